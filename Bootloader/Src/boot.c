@@ -0,0 +1,208 @@
+// Bootloader-ul de la 0x08000000: termină o actualizare începută de
+// aplicație, revine la imaginea veche dacă cea nouă nu s-a confirmat și
+// pornește aplicația din slotul ei (harta flash-ului: Core/Inc/fw_image.h).
+//
+// Proiect separat, fără HAL și fără RTOS: Bootloader/Src/boot.c,
+// Core/Src/fw_image.c, Core/Src/crc.c, Core/Src/system_stm32l4xx.c și
+// Core/Startup/startup_stm32l452retxp.s, cu STM32L452RETXP_BOOT.ld și
+// include-urile din Core/Inc și Drivers/CMSIS (make -C Bootloader). Rulează
+// pe MSI 4 MHz, cu flash-ul fără stări de așteptare.
+//
+// O placă nouă are nevoie de ambele imagini: aplicația începe la
+// FW_APP_ADDR și nu pornește fără bootloader. "bluetooth Debug.launch"
+// descarcă Bootloader/build/bootloader.elf după Debug/bluetooth.elf, deci
+// bootloader-ul trebuie construit o dată înainte de prima depanare; fără
+// IDE: STM32_Programmer_CLI -c port=SWD -w Bootloader/build/bootloader.elf,
+// apoi -w Debug/bluetooth.elf -rst. Aplicația poate fi apoi rescrisă
+// singură, prin SWD sau pe link (Tools/fwupdate.c).
+//
+// Schimbul paginilor dintre slotul aplicației și staging trece prin două
+// pagini de lucru, alternate după paritatea paginii:
+//   pas 0: lucru[p & 1] <- aplicație[p]
+//   pas 1: aplicație[p] <- staging[p]
+//   pas 2: staging[p]   <- lucru[p & 1]
+// Pașii 0 și 1 se notează în starea de boot; pasul 2 se reface la reluare
+// (pagina de lucru a lui p rămâne neatinsă până la pasul 0 al lui p + 2).
+// Fiecare pas șterge întâi destinația, deci o cădere de tensiune oricând
+// se reia de la ultimul pas notat. Același schimb, repetat, e rollback-ul.
+
+#include "stm32l4xx.h"
+#include "fw_image.h"
+
+#define BOOT_FLASH_KEY1   0x45670123UL
+#define BOOT_FLASH_KEY2   0xCDEF89ABUL
+#define BOOT_FLASH_ERRORS (FLASH_SR_OPERR | FLASH_SR_PROGERR | FLASH_SR_WRPERR | FLASH_SR_PGAERR | \
+                           FLASH_SR_SIZERR | FLASH_SR_PGSERR | FLASH_SR_MISERR | FLASH_SR_FASTERR)
+
+static FwState_t state;
+
+// Eroare ECC dublă la o citire din flash (înregistrare sau pagină
+// programată pe jumătate): citirea întoarce date oarecare, pe care
+// verificările (magic, CRC) le resping
+void NMI_Handler(void) {
+    if ((FLASH->ECCR & FLASH_ECCR_ECCD) != 0U) {
+        FLASH->ECCR |= FLASH_ECCR_ECCD;
+        return;
+    }
+    for (;;) {
+    }
+}
+
+static uint32_t WaitReady(void) {
+    uint32_t errors;
+
+    while ((FLASH->SR & FLASH_SR_BSY) != 0U) {
+    }
+    errors = FLASH->SR & BOOT_FLASH_ERRORS;
+    FLASH->SR = errors;
+    return errors;
+}
+
+static void ErasePage(uint32_t address) {
+    uint32_t page = (address - FLASH_BASE) / FW_PAGE_SIZE;
+
+    MODIFY_REG(FLASH->CR, FLASH_CR_PNB, page << FLASH_CR_PNB_Pos);
+    SET_BIT(FLASH->CR, FLASH_CR_PER);
+    SET_BIT(FLASH->CR, FLASH_CR_STRT);
+    WaitReady();
+    CLEAR_BIT(FLASH->CR, FLASH_CR_PER | FLASH_CR_PNB);
+}
+
+static void ProgramDouble(uint32_t address, uint32_t low, uint32_t high) {
+    SET_BIT(FLASH->CR, FLASH_CR_PG);
+    *(volatile uint32_t *)address = low;
+    __ISB();
+    *(volatile uint32_t *)(address + 4U) = high;
+    WaitReady();
+    CLEAR_BIT(FLASH->CR, FLASH_CR_PG);
+}
+
+// Double-word-urile șterse rămân neprogramate: pagina copiată e identică,
+// inclusiv zonele libere, fără erori de programare peste 0xFF
+static void CopyPage(uint32_t dst, uint32_t src) {
+    const uint32_t *words = (const uint32_t *)src;
+
+    ErasePage(dst);
+    for (uint32_t i = 0; i < FW_PAGE_SIZE / 4U; i += 2U) {
+        if (words[i] != 0xFFFFFFFFUL || words[i + 1U] != 0xFFFFFFFFUL) {
+            ProgramDouble(dst + i * 4U, words[i], words[i + 1U]);
+        }
+    }
+}
+
+static void Record(uint8_t type, uint8_t step, uint32_t value) {
+    if (state.used >= FW_STATE_RECORDS) {
+        return; // nu se ajunge aici: aplicația șterge starea înaintea unei instalări
+    }
+    ProgramDouble(FW_STATE_ADDR + state.used * sizeof(FwStateRecord_t),
+                  FW_STATE_MAGIC | ((uint32_t)type << 16) | ((uint32_t)step << 24), value);
+    state.used++;
+}
+
+static void Swap(void) {
+    uint32_t page = state.done / 2U;
+
+    // Reluare: pasul 1 sau pasul 2 al paginii întrerupte
+    if (state.done % 2U == 1U) {
+        uint32_t scratch = FW_SCRATCH_ADDR + (page & 1U) * FW_PAGE_SIZE;
+
+        CopyPage(FW_APP_ADDR + page * FW_PAGE_SIZE, FW_STAGING_ADDR + page * FW_PAGE_SIZE);
+        Record(FW_REC_STEP, 1, page);
+        CopyPage(FW_STAGING_ADDR + page * FW_PAGE_SIZE, scratch);
+        page++;
+    } else if (state.done != 0U) {
+        uint32_t scratch = FW_SCRATCH_ADDR + ((page - 1U) & 1U) * FW_PAGE_SIZE;
+
+        CopyPage(FW_STAGING_ADDR + (page - 1U) * FW_PAGE_SIZE, scratch);
+    }
+
+    for (; page < state.pages; page++) {
+        uint32_t app = FW_APP_ADDR + page * FW_PAGE_SIZE;
+        uint32_t staging = FW_STAGING_ADDR + page * FW_PAGE_SIZE;
+        uint32_t scratch = FW_SCRATCH_ADDR + (page & 1U) * FW_PAGE_SIZE;
+
+        CopyPage(scratch, app);
+        Record(FW_REC_STEP, 0, page);
+        CopyPage(app, staging);
+        Record(FW_REC_STEP, 1, page);
+        CopyPage(staging, scratch);
+    }
+    Record(FW_REC_SWAPPED, 0, 0);
+}
+
+static void Revert(void) {
+    Record(FW_REC_REVERT, 0, state.pages);
+    state.done = 0;
+    Swap();
+}
+
+static void StartApplication(void) {
+    const uint32_t *vectors = (const uint32_t *)(FW_APP_ADDR + FW_HEADER_SIZE);
+
+    // Cache-urile au fost oprite pe durata scrierilor: golite și repornite
+    SET_BIT(FLASH->CR, FLASH_CR_LOCK);
+    SET_BIT(FLASH->ACR, FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+    CLEAR_BIT(FLASH->ACR, FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+    SET_BIT(FLASH->ACR, FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+
+    __disable_irq();
+    SCB->VTOR = (uint32_t)vectors;
+    __DSB();
+    __ISB();
+    __set_MSP(vectors[0]);
+    __enable_irq();
+    ((void (*)(void))vectors[1])();
+}
+
+int main(void) {
+    FwImageHeader_t header;
+
+    // Fără cache-uri cât paginile sunt șterse și rescrise: o citire din
+    // cache ar întoarce conținutul vechi al paginii
+    CLEAR_BIT(FLASH->ACR, FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+    if ((FLASH->CR & FLASH_CR_LOCK) != 0U) {
+        FLASH->KEYR = BOOT_FLASH_KEY1;
+        FLASH->KEYR = BOOT_FLASH_KEY2;
+    }
+    WaitReady();
+
+    FwState_Scan((const FwStateRecord_t *)FW_STATE_ADDR, FW_STATE_RECORDS, &state);
+
+    switch (state.phase) {
+    case FW_PHASE_INSTALLING:
+        // Aplicația a verificat deja staging-ul; verificarea de aici
+        // prinde doar o corupere ulterioară, cât încă nu s-a schimbat nimic
+        if (state.done == 0U && FwImage_Verify(FW_STAGING_ADDR) != 0) {
+            Record(FW_REC_CLOSED, 0, 0);
+            break;
+        }
+        Swap();
+        // fall through
+    case FW_PHASE_INSTALLED:
+        if (FwImage_Verify(FW_APP_ADDR) != 0) {
+            Revert();
+            break;
+        }
+        Record(FW_REC_TRIAL, 0, 0);
+        break;
+    case FW_PHASE_TRIAL:
+        // Reset înainte de confirmare (watchdog, cădere, alimentare):
+        // imaginea nouă nu și-a dovedit sănătatea
+        Revert();
+        break;
+    case FW_PHASE_REVERTING:
+        Swap();
+        break;
+    default:
+        break;
+    }
+
+    if (FwImage_Check(FW_APP_ADDR, &header) != 0) {
+        // Nimic de pornit: rămâne aici până la programarea prin SWD
+        for (;;) {
+            __WFI();
+        }
+    }
+    StartApplication();
+    return 0;
+}
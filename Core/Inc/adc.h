@@ -0,0 +1,38 @@
+#ifndef __ADC_H
+#define __ADC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// ADC1, configurat direct din registre (fără driver HAL în proiect).
+// Între cicluri ADC-ul e dezactivat cu regulatorul oprit; calibrarea se
+// păstrează (se pierde doar în deep power-down), deci un ciclu costă doar
+// pornirea regulatorului (t_ADCVREG_STUP = 20 us).
+#define ADC_FULL_SCALE 4095U
+#define ADC_SEQ_MAX    16U     // conversii într-o secvență (SQ1..SQ16)
+
+// Timpi de eșantionare (SMPx), în cicluri de ceas ADC
+#define ADC_SMP_92_5   5U
+#define ADC_SMP_640_5  7U
+
+// Calibrare single-ended; ADC-ul rămâne oprit
+void Adc_Init(void);
+void Adc_SetSampleTime(uint32_t channel, uint32_t smp);
+void Adc_PowerUp(void);
+void Adc_PowerDown(void);
+// Conversie cu supraeșantionare hardware 16x, rezultat pe 12 biți; ADC pornit
+uint16_t Adc_Read(uint32_t channel);
+// Secvența pentru Adc_Scan, calculată o singură dată (maxim ADC_SEQ_MAX canale)
+void Adc_SetSequence(const uint8_t *channels, uint32_t count);
+// Toată secvența dintr-o singură pornire, fiecare conversie supraeșantionată;
+// DMA1 canal 1 copiază rezultatele în results, în ordinea secvenței. ADC pornit.
+void Adc_Scan(uint16_t *results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_H */
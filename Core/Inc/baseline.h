@@ -0,0 +1,68 @@
+#ifndef __BASELINE_H
+#define __BASELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sensors.h"
+
+// Încălzirea și linia de bază (R0) a senzorilor din tabelul sensors.c.
+//
+// Încălzire: după alimentare rezistența senzorului trece printr-un
+// tranzitoriu de câteva minute, cu atât mai lung cu cât senzorul a stat mai
+// mult rece. În locul unei întârzieri fixe, media counts pe ferestre de
+// WARMUP_WINDOW_MS se compară cu fereastra anterioară: canalul e cald după
+// WARMUP_STABLE_WINDOWS ferestre consecutive care diferă cu cel mult 1%
+// (minim WARMUP_DRIFT_MIN). Până atunci alarmele canalului sunt suprimate,
+// iar pentru MQ-2 DO nu forțează alarma și calea de siguranță pornește doar
+// ventilatorul, fără buzzer. După warmup_s canalul e declarat cald oricum
+// (EVT_WARMUP_DONE cu bitul 0x8000): alarma nu rămâne suprimată la nesfârșit.
+// Încălzirea se reia doar după o cădere a alimentării (BOR); la celelalte
+// resetări canalele deja calde rămân calde (mască în registrul de backup).
+//
+// Linie de bază: în aer curat verificat (canal cald, toate canalele la
+// ALARM_NONE, DO inactiv, ppm sub un sfert din warn) estimarea
+// R0 = (Rs/RL) / (Rs/R0 în aer curat) se mediază pe BASELINE_WINDOW_MS.
+// La capătul ferestrei R0 urmărit se apropie de medie cu cel mult
+// BASELINE_STEP_PCT, fără să iasă din ±BASELINE_LIMIT_PCT față de valoarea
+// din tabel (configurație). Un eșantion care nu e aer curat, sau a cărui
+// estimare e la peste BASELINE_SPREAD_PCT de R0 urmărit, anulează
+// fereastra: o scurgere lentă de gaz nu poate fi „învățată” ca aer curat.
+// Valoarea urmărită se păstrează în registrele de backup RTC (peste resetări
+// și, cu VBAT prezent, peste căderile de alimentare); o valoare nouă în
+// configurație o înlocuiește.
+#define WARMUP_WINDOW_MS       10000U
+#define WARMUP_STABLE_WINDOWS  3U
+#define WARMUP_DRIFT_MIN       8U       // counts
+#define BASELINE_WINDOW_MS     3600000U
+#define BASELINE_SPREAD_PCT    10U
+#define BASELINE_STEP_PCT      1U
+#define BASELINE_LIMIT_PCT     30U
+#define BASELINE_LOG_PCT       2U       // EVT_BASELINE la o mișcare cumulată de atât
+
+typedef struct {
+    uint8_t warm;
+    uint8_t timedOut;        // declarat cald la warmup_s, fără semnal stabil
+    uint32_t warmupMs;       // durata încălzirii (sau de până acum)
+    uint16_t r0;             // R0/RL x 1000 folosit acum
+    uint16_t configured;     // R0/RL x 1000 din tabel
+    uint32_t cleanMs;        // aer curat continuu în fereastra curentă
+} BaselineStatus_t;
+
+// Din Sensors_Init, după Config_Load și înainte de ștergerea flag-urilor de
+// reset: R0 urmărit și canalele calde din registrele de backup
+void Baseline_Init(void);
+// Din Sensors_Scan, la fiecare eșantion: factorul de compensare aplicat
+// canalului și 1 dacă eșantionul e aer curat verificat
+void Baseline_Update(uint8_t index, uint16_t counts, uint16_t factor, uint8_t clean, uint32_t now);
+uint8_t Baseline_Warm(uint8_t index);
+uint16_t Baseline_R0(uint8_t index);
+void Baseline_GetStatus(uint8_t index, uint32_t now, BaselineStatus_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BASELINE_H */
@@ -0,0 +1,56 @@
+#ifndef __BUZZER_H
+#define __BUZZER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sections.h"
+
+// Buzzer pe PB2. Tonul e generat de LPTIM1_OUT (singura funcție de timer
+// disponibilă pe PB2), iar secvența e avansată din întreruperea TIM6, câte
+// o întrerupere pe pas: un model pornit continuă fără niciun task.
+#define BUZZER_LPTIM_HZ  (80000000U / 16U) // PCLK1 / 16
+#define BUZZER_TICK_HZ   2000U             // TIM6: rezoluție 0.5 ms, pas maxim ~32 s
+
+typedef struct {
+    uint16_t toneHz;     // 0 = pauză
+    uint16_t durationMs;
+} BuzzerStep_t;
+
+typedef struct {
+    const BuzzerStep_t *steps;
+    uint8_t count;
+    uint8_t repeat;      // 0 = repetare până la Buzzer_Stop
+} BuzzerPattern_t;
+
+// Ordinea dă prioritatea: un model nu îl întrerupe pe unul mai important
+typedef enum {
+    BUZZER_NONE = 0,
+    BUZZER_BEEP,         // confirmare scurtă
+    BUZZER_FAULT,        // defect (ventilator blocat, senzor)
+    BUZZER_WARNING,      // concentrație peste warn_ppm
+    BUZZER_ALARM,        // alarmă, secvența temporală de evacuare T3
+    BUZZER_PATTERN_COUNT
+} BuzzerPatternId_t;
+
+void Buzzer_Init(void);
+// Pornește modelul dacă nu rulează deja unul cu prioritate mai mare; din
+// SRAM2, cu tabelele modelelor, fiindcă o apelează calea de siguranță
+HOT_FUNC void Buzzer_Play(BuzzerPatternId_t id);
+// Oprește modelul doar dacă el e cel care rulează
+void Buzzer_Stop(BuzzerPatternId_t id);
+BuzzerPatternId_t Buzzer_Current(void);
+// Tranzițiile văzute pe PB2 în windowUs (IDR urmărește și ieșirea
+// LPTIM1_OUT): 0 cu tonul pornit = pin blocat în scurt sau timer oprit.
+// E propria ieșire a MCU: nu spune dacă buzzerul e conectat și sună.
+uint32_t Buzzer_Feedback(uint32_t windowUs);
+// Apelată din întreruperea TIM6 la sfârșitul fiecărui pas
+void Buzzer_StepElapsed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BUZZER_H */
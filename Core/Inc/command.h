@@ -0,0 +1,22 @@
+#ifndef __COMMAND_H
+#define __COMMAND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Comenzi text pe linkul Bluetooth. O linie începe cu '$' și se termină cu
+// CR sau LF, de ex. "$cfg set sample_ms 200". Comenzile dintr-un caracter
+// ('1', '0', 'h', ...) rămân neschimbate și se execută imediat.
+#define COMMAND_PREFIX    '$'
+#define COMMAND_MAX_LINE  64U
+#define COMMAND_MAX_ARGS  6U
+
+// Apelată din BluetoothTask cu linia fără prefix și fără terminator
+void Command_Execute(char *line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __COMMAND_H */
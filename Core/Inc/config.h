@@ -0,0 +1,152 @@
+#ifndef __CONFIG_H
+#define __CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "energy.h"
+
+// Configurație persistentă, cheie/valoare cu tip, în două pagini de flash
+// (A/B). Fiecare salvare scrie pagina inactivă cu generație +1 și CRC-32;
+// antetul se programează ultimul, deci o salvare întreruptă lasă intactă
+// pagina veche. La pornire se încarcă o singură dată în structura config,
+// citită direct (O(1), fără acces la flash) de pe căile critice.
+#define CONFIG_START          0x0807B000UL
+#define CONFIG_PAGE_SIZE      0x800UL
+#define CONFIG_MAGIC          0x47464E43UL // "CNFG"
+
+// Flag pentru StorageTask: configurația a fost modificată și trebuie salvată
+#define STORAGE_FLAG_CONFIG   0x02U
+
+typedef enum {
+    CFG_TYPE_U8 = 1,
+    CFG_TYPE_U16 = 2,
+    CFG_TYPE_U32 = 3,
+} ConfigType_t;
+
+// Cheile sunt persistente: nu se renumerotează, doar se adaugă la final
+typedef enum {
+    CFG_BAUD_RATE = 0,       // viteza linkului Bluetooth (aplicată la repornire)
+    CFG_SAMPLE_PERIOD_MS,    // perioada buclei de monitorizare gaz
+    CFG_HISTORY_PERIOD_MS,   // perioada eșantioanelor din istoric
+    CFG_ALARM_DEBOUNCE,      // eșantioane consecutive necesare pentru schimbarea stării
+    CFG_BUZZER_ENABLE,       // buzzer activ la alarmă
+    CFG_FAN_AUTO,            // ventilatorul pornește în mod automat (curbă), nu manual
+    CFG_STREAM_BATCH,        // eșantioane per cadru de streaming
+    CFG_WARN_PPM,            // prag de avertizare
+    CFG_ALARM_PPM,           // prag de alarmă
+    CFG_SENSOR_R0,           // R0/RL x 1000 pentru senzorul MQ-2
+    CFG_FAN_PPM_LO,          // sub acest prag ventilatorul e oprit
+    CFG_FAN_PPM_HI,          // de la acest prag ventilatorul merge la fan_duty_hi
+    CFG_FAN_DUTY_LO,         // factor de umplere minim (%) la care motorul pornește
+    CFG_FAN_DUTY_HI,         // factor de umplere maxim (%) al curbei
+    CFG_FAN_DUTY_WARN,       // minim (%) pe durata avertizării
+    CFG_FAN_DUTY_ALARM,      // minim (%) pe durata alarmei, și în mod manual
+    CFG_FAN_RAMP,            // viteza maximă de variație (%/s)
+    CFG_FAN_TARGET_PPM,      // consemn pentru bucla închisă; 0 = curba fan_ppm/fan_duty
+    CFG_FAN_KP,              // câștigurile PID, Q8.8: 0.1% per ppm (x s pentru ki, / s pentru kd)
+    CFG_FAN_KI,
+    CFG_FAN_KD,
+    CFG_FAN_TACH,            // impulsuri de turometru pe rotație; 0 = ventilator fără turometru
+    CFG_LOW_POWER,           // Stop 2 între eșantioane (alimentare din baterie)
+    CFG_LINK_LPUART,         // HC-05 pe LPUART1 (PB10/PB11), activ în Stop 2 (la repornire)
+    CFG_I_RUN_NA,            // curenții tipici per mod (nA), pentru estimarea din $power
+    CFG_I_LPRUN_NA,
+    CFG_I_SLEEP_NA,
+    CFG_I_STOP1_NA,
+    CFG_I_STOP2_NA,
+    CFG_I_BOARD_NA,          // consumul constant al restului plăcii (senzor, HC-05, LDO)
+    CFG_SUPPLY_PERIOD_MS,    // perioada măsurării VDDA/VBAT/temperatură
+    CFG_BATT_LOW_MV,         // prag de baterie descărcată pe VBAT; 0 = dezactivat
+    CFG_BATT_SAMPLE_MS,      // perioada buclei de gaz cât timp bateria e descărcată
+    CFG_LOG_BINARY,          // jurnalul de diagnostic pe USART2: 0 = text, 1 = cadre LINK_FRAME_LOG
+    CFG_DIAG_BAUD,           // viteza canalului de diagnostic (USART2, aplicată la repornire)
+    CFG_DIAG_STATS_MS,       // perioada rezumatului de stare pe canalul de diagnostic; 0 = oprit
+    CFG_MODBUS_ADDR,         // adresa slave-ului Modbus RTU (USART3); 0 = dezactivat (la repornire)
+    CFG_MODBUS_BAUD,         // viteza magistralei RS-485 (aplicată la repornire)
+    CFG_MODBUS_PARITY,       // 0 = fără (2 biți de stop), 1 = pară, 2 = impară (la repornire)
+    CFG_ENV_PERIOD_MS,       // perioada măsurării SHT3x pe I2C1; 0 = fără senzor (la repornire)
+    CFG_ENV_COMP,            // compensarea MQ-2 cu temperatura și umiditatea măsurate
+    CFG_WARMUP_MAX_S,        // durata maximă a încălzirii senzorilor (s); 0 = fără faza de încălzire
+    CFG_BASELINE_TRACK,      // urmărirea lentă a lui R0 în aer curat (baseline.h)
+    CFG_SELFTEST_H,          // perioada autotestului programat (ore); 0 = doar la comandă
+    CFG_KEY_COUNT
+} ConfigKey_t;
+
+typedef struct {
+    uint32_t baudRate;
+    uint32_t historyPeriodMs;
+    uint16_t samplePeriodMs;
+    uint8_t alarmDebounce;
+    uint8_t buzzerEnable;
+    uint8_t fanAuto;
+    uint8_t streamBatch;
+    uint16_t warnPpm;
+    uint16_t alarmPpm;
+    uint16_t sensorR0;
+    uint16_t fanPpmLo;
+    uint16_t fanPpmHi;
+    uint8_t fanDutyLo;
+    uint8_t fanDutyHi;
+    uint8_t fanDutyWarn;
+    uint8_t fanDutyAlarm;
+    uint8_t fanRamp;
+    uint16_t fanTargetPpm;
+    uint16_t fanKp;
+    uint16_t fanKi;
+    uint16_t fanKd;
+    uint8_t fanTachPulses;
+    uint8_t lowPower;
+    uint8_t linkLpuart;
+    uint32_t currentNa[ENERGY_MODE_COUNT];
+    uint32_t boardNa;
+    uint32_t supplyPeriodMs;
+    uint16_t battLowMv;
+    uint16_t battSamplePeriodMs;
+    uint8_t logBinary;
+    uint32_t diagBaud;
+    uint32_t diagStatsMs;
+    uint8_t modbusAddr;
+    uint8_t modbusParity;
+    uint32_t modbusBaud;
+    uint32_t envPeriodMs;
+    uint8_t envComp;
+    uint16_t warmupMaxS;
+    uint8_t baselineTrack;
+    uint16_t selftestHours;
+} Config_t;
+
+// Configurația activă; doar citire în afara config.c
+extern Config_t config;
+
+// Valori implicite + suprascriere din cea mai nouă pagină validă
+void Config_Load(void);
+// După osKernelInitialize: mutexul copiei de lucru, comună între
+// BluetoothTask, DiagTask ($cfg) și ModbusTask
+void Config_Init(void);
+// Caută cheia după nume; -1 dacă nu există
+int Config_Find(const char *name);
+const char *Config_Name(uint8_t key);
+uint32_t Config_Get(uint8_t key);
+// Modificările se fac într-o copie de lucru; -1 dacă valoarea e în afara limitelor
+int Config_Set(uint8_t key, uint32_t value);
+uint32_t Config_GetStaged(uint8_t key);
+// Scriere directă a cheilor first..first+count-1 în configurația activă
+// (Modbus), fără modificările $cfg încă neaplicate din copia de lucru.
+// Toate valorile se verifică înainte de prima modificare (-1 = niciuna
+// aplicată); salvarea se cere doar dacă ceva chiar s-a schimbat.
+int Config_Apply(uint8_t first, uint8_t count, const uint32_t *values);
+// Aplică atomic copia de lucru și cere salvarea în flash
+void Config_Commit(void);
+void Config_Revert(void);
+void Config_Defaults(void);
+// Scrie configurația activă în pagina inactivă (din StorageTask)
+int Config_Save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CONFIG_H */
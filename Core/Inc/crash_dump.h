@@ -0,0 +1,72 @@
+#ifndef __CRASH_DUMP_H
+#define __CRASH_DUMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Instantaneu al unei căderi, păstrat în SRAM2 (secțiunea .crash_dump,
+// neinițializată la pornire) peste resetul care urmează. La pornirea
+// următoare e validat după CRC, notat în jurnal și trimis pe link în
+// cadre LINK_FRAME_CRASH; Tools/crashdecode.c îl simbolizează cu ELF-ul.
+#define CRASH_DUMP_MAGIC       0x48535243U // "CRSH"
+#define CRASH_DUMP_TASK_LEN    16U         // configMAX_TASK_NAME_LEN
+#define CRASH_DUMP_STACK_WORDS 24U
+
+// Cauza = numărul excepției (IPSR) pentru defectele procesorului
+typedef enum {
+    CRASH_HARDFAULT = 3,
+    CRASH_MEMMANAGE = 4,
+    CRASH_BUSFAULT = 5,
+    CRASH_USAGEFAULT = 6,
+    CRASH_STACK_OVERFLOW = 0x100, // gardă MPU sau verificarea kernelului
+} CrashReason_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t length;     // sizeof(CrashDump_t), pentru compatibilitate cu host-ul
+    uint32_t reason;
+    uint32_t excReturn;  // LR la intrarea în handler (bit 2: PSP = context de task)
+    uint32_t r0;         // cadrul salvat de procesor
+    uint32_t r1;
+    uint32_t r2;
+    uint32_t r3;
+    uint32_t r12;
+    uint32_t lr;
+    uint32_t pc;
+    uint32_t xpsr;
+    uint32_t sp;         // SP-ul contextului căzut, după cadrul salvat
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uint32_t uptimeMs;
+    char task[CRASH_DUMP_TASK_LEN];
+    uint32_t stack[CRASH_DUMP_STACK_WORDS]; // de la sp în sus
+    uint32_t crc;        // CRC-32 peste câmpurile anterioare
+} CrashDump_t;
+
+// Activează MemManage/BusFault/UsageFault separat (altfel toate devin
+// HardFault) și notează în jurnal o cădere nouă; după EventLog_Init
+void CrashDump_Init(void);
+// Instantaneul valid de la căderea anterioară, sau NULL
+const CrashDump_t *CrashDump_Get(void);
+// 1 dacă instantaneul nu a fost încă trimis pe link
+uint8_t CrashDump_Pending(void);
+void CrashDump_MarkReported(void);
+// Trimite instantaneul în cadre LINK_FRAME_CRASH (u16 offset + fragment);
+// doar din BluetoothTask, ca Link_SendFrame
+void CrashDump_Send(void);
+// Salvează instantaneul pentru cadrul de excepție dat și resetează placa
+void CrashDump_Capture(uint32_t *frame, uint32_t excReturn) __attribute__((noreturn));
+// Ca mai sus, pentru o eroare detectată de kernel la comutare (ex. hook-ul
+// de depășire a stivei): registrele vin din contextul salvat al task-ului
+void CrashDump_CaptureTask(uint32_t reason) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRASH_DUMP_H */
@@ -0,0 +1,26 @@
+#ifndef __CRC_H
+#define __CRC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+// CRC-16/CCITT-FALSE (poli 0x1021, init 0xFFFF) - folosit pentru cadrele de pe link
+uint16_t Crc16(const uint8_t *data, size_t len);
+uint16_t Crc16_Update(uint16_t crc, const uint8_t *data, size_t len);
+
+// CRC-16/MODBUS (poli 0x8005 reflectat, init 0xFFFF) - cadrele Modbus RTU
+uint16_t Crc16_Modbus(const uint8_t *data, size_t len);
+
+// CRC-32 (IEEE 802.3, reflectat) - folosit pentru imaginile din flash
+uint32_t Crc32(const uint8_t *data, size_t len);
+uint32_t Crc32_Update(uint32_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRC_H */
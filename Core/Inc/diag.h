@@ -0,0 +1,32 @@
+#ifndef __DIAG_H
+#define __DIAG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sections.h"
+
+// Canalul de diagnostic pe USART2 (VCP-ul ST-LINK, diag_baud): separat de
+// legătura Bluetooth, ca depanarea pe banc să nu-i ia din bandă sau latență.
+// DiagTask (prioritate minimă) golește jurnalul LOG() prin DMA, trimite la
+// diag_stats_ms un rezumat al stării (heap, stive, jurnal, consum,
+// alimentare) și execută comenzile primite pe VCP, ca pe link ("$" e
+// opțional); răspunsurile lor ajung în jurnal ca text.
+#define DIAG_FLAG_LINE 0x02U // linie de comandă completă (LOG_FLAG_TX_DONE = 0x01)
+
+// După MX_USART2_UART_Init: pornește recepția pe întrerupere
+void Diag_Init(void);
+// Din HAL_UART_RxCpltCallback / HAL_UART_ErrorCallback, pentru USART2
+HOT_FUNC void Diag_RxCallback(void);
+HOT_FUNC void Diag_ErrorCallback(void);
+// Rezumatul stării, prin LOG()
+void Diag_DumpStats(void);
+void StartDiagTask(void *argument);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DIAG_H */
@@ -0,0 +1,46 @@
+#ifndef __ENERGY_H
+#define __ENERGY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Contabilitatea timpului pe moduri de consum și estimarea energiei din
+// curenții tipici per mod (cheile i_*_na din configurație, în nA).
+// Codul nu depinde de HAL: același calcul rulează în firmware (power.c,
+// $power) și pe host (Tools/power_sim.c).
+typedef enum {
+    ENERGY_MODE_RUN = 0, // Run, 80 MHz din PLL
+    ENERGY_MODE_LPRUN,   // Low-power run (MSI <= 2 MHz)
+    ENERGY_MODE_SLEEP,   // WFI, tick-ul SysTick continuă
+    ENERGY_MODE_STOP1,
+    ENERGY_MODE_STOP2,
+    ENERGY_MODE_COUNT
+} EnergyMode_t;
+
+typedef struct {
+    uint64_t us[ENERGY_MODE_COUNT];   // timp petrecut în fiecare mod
+} EnergyResidency_t;
+
+typedef struct {
+    uint32_t avgNa;      // curentul mediu: moduri ponderate + baseNa
+    uint32_t perHourUah; // sarcina consumată într-o oră
+    uint32_t perHourUwh; // energia într-o oră, la tensiunea dată
+} EnergyEstimate_t;
+
+uint64_t Energy_Total(const EnergyResidency_t *residency);
+// Partea din timpul total petrecută în mod, în promile
+uint16_t Energy_Permille(const EnergyResidency_t *residency, EnergyMode_t mode);
+// currentNa[mod]: curentul tipic al nucleului în fiecare mod; baseNa: restul
+// plăcii (consum constant); supplyMv: tensiunea de alimentare
+void Energy_Estimate(const EnergyResidency_t *residency, const uint32_t currentNa[ENERGY_MODE_COUNT],
+                     uint32_t baseNa, uint32_t supplyMv, EnergyEstimate_t *out);
+const char *Energy_ModeName(EnergyMode_t mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ENERGY_H */
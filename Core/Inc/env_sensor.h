@@ -0,0 +1,51 @@
+#ifndef __ENV_SENSOR_H
+#define __ENV_SENSOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sections.h"
+
+// Senzor de temperatură și umiditate SHT3x pe I2C1 (PB8 SCL, PB9 SDA,
+// 100 kHz), pentru compensarea MQ-2 (gas_sensor.h). La fiecare env_ms un
+// timer software trimite comanda de măsurare (single shot, repetabilitate
+// mare, fără clock stretching) prin întrerupere, iar după
+// ENV_CONVERSION_MS rezultatul se citește prin DMA (DMA2 canal 6).
+// Niciun task nu așteaptă după magistrală: timerul doar pornește
+// transferurile, iar întreruperea de la sfârșitul lor verifică CRC-ul și
+// publică citirea. Un transfer neterminat până la pasul următor e abandonat,
+// iar perifericul reinițializat.
+#define ENV_I2C_ADDRESS       0x44U    // ADDR la GND; 0x45 cu ADDR la VDD
+#define ENV_CMD_MEASURE       0x2400U  // single shot, repetabilitate mare
+#define ENV_CONVERSION_MS     20U      // 15.5 ms maxim în foaia de catalog
+// O citire mai veche de atât nu mai e folosită la compensare
+#define ENV_MAX_AGE(periodMs) (3U * (periodMs))
+
+typedef struct {
+    uint32_t timestamp;     // ms de la pornire; 0 = încă nicio citire validă
+    int16_t temperature;    // 0.1 °C
+    uint16_t humidity;      // 0.1 %RH
+} EnvReading_t;
+
+typedef struct {
+    uint32_t reads;         // citiri valide
+    uint32_t crcErrors;
+    uint32_t busErrors;     // NACK (senzor absent), arbitraj, erori de magistrală
+    uint32_t timeouts;      // transfer neterminat la pasul următor
+} EnvStats_t;
+
+// După MX_I2C1_Init; pornește măsurările dacă env_ms != 0
+void EnvSensor_Init(void);
+// 1 dacă ultima citire validă e mai nouă decât ENV_MAX_AGE
+uint8_t EnvSensor_Get(EnvReading_t *out);
+// 1 cât timp un transfer e în curs (I2C1 se oprește în Stop 2)
+uint8_t EnvSensor_Busy(void);
+void EnvSensor_GetStats(EnvStats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ENV_SENSOR_H */
@@ -0,0 +1,86 @@
+#ifndef __EVENT_LOG_H
+#define __EVENT_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Jurnal de evenimente append-only în flash-ul intern, cu nivelarea uzurii.
+//
+// Regiunea rezervată în linker script (EVTLOG) e folosită circular, pagină
+// cu pagină, deci fiecare pagină e ștearsă o dată pe ciclu. Fiecare pagină
+// începe cu un antet de 16 octeți, urmat de înregistrări de 16 octeți
+// programate ca două double-word-uri. O înregistrare întreruptă de o cădere
+// de tensiune are CRC invalid și e sărită la citire; slotul nu se refolosește.
+#define EVENT_LOG_START       0x0807C000UL
+#define EVENT_LOG_PAGES       8U
+#define EVENT_LOG_PAGE_SIZE   0x800UL
+#define EVENT_LOG_MAGIC       0x474F4C45UL // "ELOG"
+#define EVENT_LOG_RECORD_SIZE 16U
+#define EVENT_LOG_SLOTS       ((EVENT_LOG_PAGE_SIZE / EVENT_LOG_RECORD_SIZE) - 1U)
+
+// Evenimentele se adună în RAM și se scriu în flash în loturi
+#define EVENT_LOG_PENDING     32U
+#define EVENT_LOG_BATCH       8U
+#define EVENT_LOG_FLUSH_MS    5000U
+
+// Flag pentru StorageTask: există un lot de scris
+#define STORAGE_FLAG_EVENTLOG 0x01U
+
+typedef enum {
+    EVT_BOOT = 1,            // value = RCC->CSR (cauza resetului) >> 24
+    EVT_GAS_DETECTED = 2,    // value = concentrația (ppm) la intrarea în alarmă, aux = canalul (sensors.h)
+    EVT_GAS_CLEARED = 3,     // idem, la revenirea canalului sub praguri
+    EVT_FAN_ON = 4,          // value = factor de umplere țintă (%), aux = 1 în mod automat
+    EVT_FAN_OFF = 5,
+    EVT_LOG_DROPPED = 6,     // value = câte evenimente s-au pierdut (coadă plină)
+    EVT_CONFIG_SAVED = 7,    // value = 1 la succes, 0 la eroare de scriere
+    EVT_GAS_WARNING = 8,     // value = concentrația (ppm) la intrarea în avertizare, aux = canalul
+    EVT_FAN_STALL = 9,       // value = factorul de umplere (%) fără impulsuri de la turometru
+    EVT_SAFETY_TRIP = 10,    // value = latența de acționare (us), aux = concentrația (ppm)
+    EVT_WATCHDOG_RESET = 11, // value = mască WatchdogTask_t întârziate, aux = întârzierea (ms)
+    EVT_CRASH = 12,          // value = CrashReason_t, aux = CFSR (16 biți de jos)
+    EVT_BATTERY_LOW = 13,    // value = VBAT (mV), aux = VDDA (mV)
+    EVT_BATTERY_OK = 14,     // idem, la revenirea peste batt_low_mv + histerezis
+    EVT_FW_STAGED = 15,      // value = versiunea nouă (major << 8 | minor), aux = pagini de schimbat
+    EVT_FW_CONFIRMED = 16,   // value = versiunea confirmată după perioada de probă
+    EVT_FW_ROLLBACK = 17,    // value = versiunea respinsă, aux = versiunea revenită
+    EVT_WARMUP_DONE = 18,    // value = durata încălzirii (s), aux = canalul | 0x8000 dacă a expirat warmup_s
+    EVT_BASELINE = 19,       // value = R0/RL x 1000 urmărit, aux = canalul
+    EVT_SELFTEST = 20,       // value = mască elemente picate (SelfTestItem_t), aux = mască elemente sărite
+} EventType_t;
+
+typedef struct {
+    uint32_t sequence;  // crește monoton pe toată durata de viață a jurnalului
+    uint32_t timestamp; // ms de la pornire (ordinea între resetări vine din EVT_BOOT)
+    uint8_t type;
+    uint8_t flags;
+    uint16_t value;
+    uint16_t aux;
+    uint16_t crc;       // CRC-16 peste primii 14 octeți
+} EventRecord_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t eraseCount;
+    uint32_t firstSequence;
+    uint16_t reserved;
+    uint16_t crc;       // CRC-16 peste primii 14 octeți
+} EventLogPageHeader_t;
+
+void EventLog_Init(void);
+// Apelabilă din task-uri și din ISR; doar pune evenimentul în coada din RAM
+void EventLog_Append(uint8_t type, uint16_t value, uint16_t aux);
+// Scrie în flash evenimentele din coadă (din StorageTask sau înainte de citire)
+void EventLog_Flush(void);
+// Citește cel mult max înregistrări cu sequence >= *cursor, în ordine;
+// avansează *cursor după ultima înregistrare returnată
+uint32_t EventLog_Read(uint32_t *cursor, EventRecord_t *out, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_LOG_H */
@@ -0,0 +1,64 @@
+#ifndef __FAN_H
+#define __FAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "gas_sensor.h"
+#include "sections.h"
+
+// Ventilator pe PB1, PWM pe TIM3_CH4 la 25 kHz (peste pragul audibil)
+#define FAN_PWM_FREQ_HZ 25000U
+#define FAN_PWM_PERIOD  (80000000U / FAN_PWM_FREQ_HZ)
+
+// Bucla de reglaj rulează pe un timer software, la perioadă fixă,
+// independent de sample_ms
+#define FAN_CONTROL_PERIOD_MS 100U
+
+// Turometru pe PA15, captură pe TIM2_CH1 cu tact de 1 MHz; impulsurile pe
+// rotație vin din fan_tach (implicit 0 = fără turometru, caz în care turația
+// e 0 și detecția rotorului blocat e oprită; 2 la ventilatoarele de PC)
+#define FAN_TACH_TICK_HZ         1000000U
+// Fără impulsuri în acest interval, turația e considerată 0
+#define FAN_TACH_TIMEOUT_MS      500U
+// Cât timp poate sta rotorul cu PWM peste fan_duty_lo înainte de EVT_FAN_STALL
+#define FAN_STALL_MS             3000U
+
+typedef enum {
+    FAN_MODE_AUTO = 0,   // factor de umplere din curba concentrație -> duty sau din PID
+    FAN_MODE_MANUAL = 1, // factor de umplere fix, setat prin comandă
+} FanMode_t;
+
+void Fan_Init(void);
+void Fan_SetAuto(void);
+void Fan_SetManual(uint8_t dutyPercent);
+// Minim temporar impus de autotest (selftest.h), peste modul curent; 0 = fără.
+// Doar ridică factorul de umplere: alarma rămâne prioritară.
+void Fan_SetTest(uint8_t dutyPercent);
+FanMode_t Fan_GetMode(void);
+// Factorul de umplere aplicat acum, în procente
+uint8_t Fan_GetDuty(void);
+// 1 dacă ieșirea PWM nu e 0 (TIM3 se oprește în Stop 2, cu ieșirea înghețată)
+uint8_t Fan_Running(void);
+// Turația măsurată (rpm), 0 dacă rotorul stă sau fan_tach = 0
+uint16_t Fan_GetRpm(void);
+// Curba configurabilă: 0 sub fan_ppm_lo, liniar fan_duty_lo..fan_duty_hi
+// până la fan_ppm_hi, cu minime impuse de nivelul de avertizare/alarmă
+uint8_t Fan_CurveDuty(uint16_t ppm, AlarmLevel_t level);
+// Ultima măsură, publicată de GasMonitorTask la fiecare eșantion
+void Fan_SetMeasurement(uint16_t ppm, AlarmLevel_t level);
+// Un pas al buclei de reglaj (apelată din timerul de control); aplică
+// curba sau PID-ul (fan_target_ppm != 0), minimele și limita de rampă
+void Fan_Update(uint32_t elapsedMs);
+// Din calea de siguranță (întrerupere): ridică imediat factorul de umplere
+// la fan_duty_alarm, fără rampă. Fan_Update nu coboară sub el cât timp
+// Safety_Active(). Din SRAM2 (HOT_FUNC): rulează și în timpul ștergerii flash.
+HOT_FUNC void Fan_SafetyOn(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FAN_H */
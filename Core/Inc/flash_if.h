@@ -0,0 +1,49 @@
+#ifndef __FLASH_IF_H
+#define __FLASH_IF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "stm32l4xx_hal.h"
+
+// Acces comun la flash-ul intern pentru jurnal, configurație etc.
+// Toate operațiile de ștergere/programare trebuie încadrate de
+// FlashIf_Begin/FlashIf_End: un mutex serializează task-urile și
+// flash-ul e deblocat o singură dată pe sesiune.
+//
+// Cât flash-ul e ocupat (ștergere ~22 ms pe pagină, programare ~90 us pe
+// double-word), BASEPRI maschează prioritățile FLASH_IF_MASK_PRIORITY..15:
+// SysTick și PendSV stau, deci niciun task nu rulează, iar eșantionarea
+// (GasMonitorTask) întârzie cu până la ~22 ms la fiecare pagină ștearsă
+// (tick-urile se recuperează după). Rulează în continuare doar
+// întreruperile din SRAM2: calea de siguranță (EXTI0) și, la
+// FLASH_IF_RAM_IRQ_PRIORITY, UART-urile (USART1/2/3, LPUART1) și DMA1
+// canal 7, ca octeții primiți să nu se piardă; doar sfârșitul unei linii
+// sau al unui cadru, care trezește un task, așteaptă în flash sfârșitul
+// ștergerii. Orice altă întrerupere stă la FLASH_IF_MASK_PRIORITY sau mai
+// jos: codul ei e în flash și ar opri nucleul până la sfârșitul ștergerii.
+// Recepția prin interogare (comenzile HC-05 din BluetoothTask) nu rulează
+// cât task-urile stau.
+#define FLASH_IF_RAM_IRQ_PRIORITY 5U // = configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+#define FLASH_IF_MASK_PRIORITY    6U
+
+void FlashIf_Init(void);
+void FlashIf_Begin(void);
+void FlashIf_End(void);
+HAL_StatusTypeDef FlashIf_ErasePage(uint32_t address);
+// len trebuie să fie multiplu de 8 (programare pe double-word)
+HAL_StatusTypeDef FlashIf_Program(uint32_t address, const void *data, size_t len);
+// Citire mapată în memorie; -1 dacă citirea a declanșat o eroare ECC
+// (double-word programat pe jumătate la o cădere de tensiune)
+int FlashIf_Read(uint32_t address, void *out, size_t len);
+// Apelată din NMI_Handler la eroare ECC dublă pe o citire din flash
+void FlashIf_EccErrorCallback(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLASH_IF_H */
@@ -0,0 +1,103 @@
+#ifndef __FW_IMAGE_H
+#define __FW_IMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Împărțirea flash-ului între bootloader (Bootloader/) și aplicație, comună
+// celor două build-uri și uneltelor de pe host (Tools/fwpack.c, fwupdate.c):
+//
+//   0x08000000  bootloader           12 KB
+//   0x08003000  pagini de lucru       2 x 2 KB (schimbul de pagini)
+//   0x08004000  starea de boot        4 KB, înregistrări append-only
+//   0x08005000  slotul aplicației   236 KB: antet 0x200 + imaginea
+//   0x08040000  slotul de staging   236 KB: imaginea nouă, primită pe link
+//   0x0807B000  CONFIG, EVTLOG (neschimbate)
+//
+// Activarea schimbă paginile celor două sloturi (nu copiază): imaginea
+// veche ajunge în staging, de unde se poate reveni dacă cea nouă nu se
+// confirmă (rollback).
+#define FW_PAGE_SIZE        0x800UL
+#define FW_BOOT_ADDR        0x08000000UL
+#define FW_SCRATCH_ADDR     0x08003000UL
+#define FW_STATE_ADDR       0x08004000UL
+#define FW_STATE_SIZE       0x1000UL
+#define FW_APP_ADDR         0x08005000UL
+#define FW_STAGING_ADDR     0x08040000UL
+#define FW_SLOT_SIZE        0x3B000UL
+#define FW_SLOT_PAGES       (FW_SLOT_SIZE / FW_PAGE_SIZE)
+
+// Antetul ocupă începutul slotului; vectorii urmează la +0x200, aliniați
+// cum cere VTOR. imageSize și imageCrc sunt completate de Tools/fwpack.c
+// după link; firmware-ul le lasă 0, deci o imagine scrisă direct prin SWD
+// pornește, dar nu poate fi trimisă ca actualizare.
+#define FW_HEADER_SIZE      0x200UL
+#define FW_IMAGE_MAGIC      0x4D494753UL // "SGIM"
+#define FW_VERSION          0x00010000UL // major.minor.patch: 8.8.16 biți
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t imageSize;   // octeții de după antet (vectori, cod, date)
+    uint32_t imageCrc;    // CRC-32 peste acești octeți
+    uint32_t reserved[4];
+} FwImageHeader_t;
+
+// Starea de boot: double-word-uri scrise în ordine, citite la fiecare
+// pornire; ultima înregistrare validă spune ce urmează. O înregistrare
+// ruptă de o cădere de tensiune nu are magic-ul corect și oprește citirea.
+#define FW_STATE_MAGIC      0xB007U
+#define FW_STATE_RECORDS    (FW_STATE_SIZE / sizeof(FwStateRecord_t))
+
+typedef enum {
+    FW_REC_INSTALL = 1,   // aplicația: staging verificat, value = pagini de schimbat
+    FW_REC_REVERT,        // bootloader-ul: imaginea nouă nu s-a confirmat
+    FW_REC_STEP,          // pasul step (0/1) din pagina value s-a terminat
+    FW_REC_SWAPPED,       // schimbul s-a terminat
+    FW_REC_TRIAL,         // bootloader-ul pornește imaginea nouă prima dată
+    FW_REC_CONFIRM,       // aplicația: imaginea nouă a trecut perioada de probă
+    FW_REC_CLOSED,        // ciclul s-a încheiat: staging invalid sau rollback raportat
+} FwRecordType_t;
+
+typedef struct {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t step;
+    uint32_t value;
+} FwStateRecord_t;
+
+typedef enum {
+    FW_PHASE_IDLE = 0,    // nicio actualizare în curs (confirmată sau revenită)
+    FW_PHASE_INSTALLING,  // schimb spre imaginea nouă, neterminat
+    FW_PHASE_INSTALLED,   // schimbat, încă nepornit
+    FW_PHASE_TRIAL,       // imaginea nouă rulează neconfirmată
+    FW_PHASE_REVERTING,   // schimb înapoi, neterminat
+    FW_PHASE_REVERTED,    // imaginea veche e din nou activă
+} FwPhase_t;
+
+typedef struct {
+    FwPhase_t phase;
+    uint32_t pages;       // paginile schimbului curent
+    uint32_t done;        // pași terminați: 2 pe pagină
+    uint32_t used;        // înregistrări ocupate (inclusiv cele rupte)
+} FwState_t;
+
+// Reface starea din înregistrările de la FW_STATE_ADDR
+void FwState_Scan(const FwStateRecord_t *records, uint32_t count, FwState_t *state);
+// Antet valid și vectori plauzibili (stivă în RAM, reset în slotul
+// aplicației, unde e legată orice imagine); *header primește antetul.
+// 0 = în regulă, inclusiv pentru o imagine neîmpachetată (imageSize = 0).
+int FwImage_Check(uint32_t slot, FwImageHeader_t *header);
+// FwImage_Check plus CRC-ul imaginii (doar imagini împachetate)
+int FwImage_Verify(uint32_t slot);
+// Paginile ocupate de imaginea dintr-un slot; tot slotul dacă antetul lipsește
+uint32_t FwImage_Pages(uint32_t slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FW_IMAGE_H */
@@ -0,0 +1,61 @@
+#ifndef __GAS_SENSOR_H
+#define __GAS_SENSOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sections.h"
+
+// Conversia din tensiunea divizorului RL/Rs în concentrație, comună
+// senzorilor din tabelul sensors.c. Ieșirea digitală (DO, comparatorul
+// modulului MQ-2) rămâne pe PA0.
+#define GAS_SENSOR_FULL_SCALE  4095U
+#define GAS_SENSOR_MAX_PPM     10000U
+
+typedef enum {
+    ALARM_NONE = 0,
+    ALARM_WARNING = 1,
+    ALARM_ALARM = 2,
+} AlarmLevel_t;
+
+// Curba din foaia de catalog, tabelată pe Rs/R0 x 1000 (crescător) și
+// interpolată liniar între puncte
+typedef struct {
+    uint16_t ratio;
+    uint16_t ppm;
+} GasCurvePoint_t;
+
+typedef struct {
+    const GasCurvePoint_t *points;
+    uint8_t count;
+} GasCurve_t;
+
+extern const GasCurve_t gasCurveMq2Lpg;
+extern const GasCurve_t gasCurveMq7Co;
+extern const GasCurve_t gasCurveMq135Co2;
+
+// Concentrație din Rs/R0, cu R0/RL x 1000 și factorul de compensare x1000
+// (1000 = fără corecție) aplicat pe Rs/R0
+HOT_FUNC uint16_t GasSensor_Convert(const GasCurve_t *curve, uint16_t r0, uint16_t factor, uint16_t counts);
+// MQ-2: ppm echivalent GPL, cu R0 din configurație și Rs/R0 corectat cu
+// condițiile date de GasSensor_SetConditions
+HOT_FUNC uint16_t GasSensor_Ppm(uint16_t counts);
+// Aceeași funcție, executată din flash: doar pentru comparația din $bench
+uint16_t GasSensor_PpmFlash(uint16_t counts);
+// Compensarea cu temperatura (0.1 °C) și umiditatea (0.1 %RH) ambiante,
+// relativ la condițiile de calibrare a lui R0 (20 °C, 65 %RH)
+void GasSensor_SetConditions(int16_t temperature, uint16_t humidity);
+// Fără măsurare recentă: Rs/R0 necorectat
+void GasSensor_ClearConditions(void);
+// Factorul aplicat acum pe Rs/R0, x1000 (1000 = fără corecție)
+uint16_t GasSensor_Compensation(void);
+// Nivel de alarmă cu histerezis de 10% la coborâre
+AlarmLevel_t GasSensor_Classify(uint16_t ppm, AlarmLevel_t current, uint16_t warnPpm, uint16_t alarmPpm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GAS_SENSOR_H */
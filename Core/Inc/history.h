@@ -0,0 +1,29 @@
+#ifndef __HISTORY_H
+#define __HISTORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sample_codec.h"
+
+// Istoric circular al eșantioanelor în RAM (1024 x history_ms, implicit ~17 minute)
+#define HISTORY_CAPACITY   1024U
+
+void History_Add(uint32_t timestamp, uint16_t value);
+// Indexul următorului eșantion care va fi scris (crește monoton)
+uint32_t History_Head(void);
+// Indexul celui mai vechi eșantion încă disponibil
+uint32_t History_Oldest(void);
+// Codează eșantioanele începând de la *cursor până se umple out sau se
+// ajunge la capăt; avansează *cursor, pune în *first indexul primului
+// eșantion codat și returnează lungimea blocului (0 dacă nu e nimic nou)
+size_t History_Encode(uint32_t *cursor, uint32_t *first, uint8_t *out, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HISTORY_H */
@@ -0,0 +1,57 @@
+#ifndef __HOT_PATH_H
+#define __HOT_PATH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sections.h"
+
+// Execuția din SRAM2 a căilor fierbinți (RAM_HOT_PATHS, sections.h):
+// tabela de vectori, întreruperile UART/EXTI/DMA cu drumul lor prin HAL,
+// calea de siguranță (EXTI0 -> ventilator, buzzer) și nucleele rulate la
+// fiecare eșantion (GasSensor_Ppm, Pid_Update). Flash-ul are 4 stări de
+// așteptare la 80 MHz; ART le ascunde pe codul liniar, nu și pe cel cu
+// multe ramificații, iar cât flash-ul e șters sau programat orice citire
+// din el oprește nucleul. Cu vectorii și calea completă în SRAM2, EXTI0
+// rulează și în timpul unei ștergeri de pagină (flash_if.c).
+
+// Întreruperile măsurate, de la intrarea în handler până la ieșire
+typedef enum {
+    HOT_ISR_EXTI0 = 0,  // ieșirea DO a senzorului (calea de siguranță)
+    HOT_ISR_DMA_LOG,    // DMA1 canal 7, jurnalul pe USART2
+    HOT_ISR_USART2,     // consola de diagnostic
+    HOT_ISR_LPUART1,    // link-ul pe LPUART1
+    HOT_ISR_USART1,     // link-ul pe USART1 (recepția prin întrerupere, ota.c)
+    HOT_ISR_USART3,     // slave-ul Modbus (RTO, sfârșitul cadrului)
+    HOT_ISR_COUNT
+} HotIsr_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t lastCycles;
+    uint32_t maxCycles;
+} HotIsrStats_t;
+
+// Același nucleu rulat o dată din flash și o dată din SRAM2, pe aceleași date
+typedef struct {
+    uint32_t flashCycles;
+    uint32_t ramCycles;
+    uint32_t calls;
+} HotBench_t;
+
+// La începutul lui main: copiază vectorii în SRAM2 și mută VTOR acolo
+void HotPath_Init(void);
+// La ieșirea din handler; start = DWT->CYCCNT la intrare
+HOT_FUNC void HotPath_IsrDone(HotIsr_t isr, uint32_t start);
+void HotPath_GetIsrStats(HotIsr_t isr, HotIsrStats_t *stats);
+const char *HotPath_IsrName(HotIsr_t isr);
+// Ciclurile nucleelor pe eșantion, din flash și din SRAM2
+void HotPath_Bench(HotBench_t *ppm, HotBench_t *pid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOT_PATH_H */
@@ -0,0 +1,36 @@
+#ifndef __LED_H
+#define __LED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// LED roșu pe PA5, LED verde pe PA6, comandate doar de serviciul de LED-uri
+#define LED_TICK_MS 100U
+
+// Ordinea dă prioritatea: fiecare LED afișează indicația activă cea mai
+// importantă dintre cele care îl folosesc
+typedef enum {
+    LED_IND_HEARTBEAT = 0, // sistem pornit (mereu activă)
+    LED_IND_LINK,          // comunicație recentă pe Bluetooth
+    LED_IND_WARNING,       // concentrație peste warn_ppm
+    LED_IND_ALARM,         // alarmă de gaz
+    LED_IND_FAULT,         // defect (ventilator blocat, eroare fatală)
+    LED_IND_COUNT
+} LedIndication_t;
+
+// Creează timerul de LED-uri; după osKernelInitialize
+void Led_Init(void);
+// Activează/dezactivează o indicație; se poate apela și din întreruperi
+void Led_Set(LedIndication_t indication, uint8_t active);
+// Eroare fatală: întreruperi oprite, indicația rulează din bucla de
+// așteptare pe SysTick, fără kernel și fără HAL_Delay. Nu se întoarce.
+void Led_Halt(LedIndication_t indication);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LED_H */
@@ -0,0 +1,64 @@
+#ifndef __LINK_H
+#define __LINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Cadre binare pe linkul Bluetooth, intercalate cu mesajele text:
+//   0xA5 | tip | lungime (u16 LE) | payload | CRC-16 (u16 LE, peste tip..payload)
+// Host-ul caută octetul de sincronizare și validează CRC-ul, deci textul
+// dintre cadre este ignorat fără probleme.
+#define LINK_FRAME_SYNC        0xA5U
+#define LINK_FRAME_MAX_PAYLOAD 128U
+// Fără niciun octet primit în acest interval, legătura e considerată inactivă
+#define LINK_IDLE_MS           60000U
+
+// Flag-uri pentru BluetoothTask cât așteaptă cu legătura inactivă (low_power)
+#define LINK_FLAG_RX           0x01U // front de start pe RX: încep comenzi
+#define LINK_FLAG_MESSAGE      0x02U // mesaj nou în coada de mesaje
+#define LINK_FLAG_SELFTEST     0x04U // autotestul cere ping-ul sau are raportul gata
+#define LINK_WAIT_MS           1000U // sub termenul de watchdog al task-ului
+
+#define LINK_FRAME_HISTORY     0x01U // u32 index primul eșantion + bloc SampleCodec
+#define LINK_FRAME_STREAM      0x02U // idem, eșantioane noi trimise periodic
+#define LINK_FRAME_EVENTS      0x03U // până la 8 EventRecord_t brute din jurnalul flash
+#define LINK_FRAME_CRASH       0x04U // u16 offset + fragment din CrashDump_t
+#define LINK_FRAME_SUPPLY      0x05U // SupplyReading_t, la fiecare măsurare nouă
+#define LINK_FRAME_LOG         0x06U // înregistrări brute din jurnalul de diagnostic (USART2)
+#define LINK_FRAME_SELFTEST    0x07U // SelfTestReport_t, la sfârșitul fiecărui autotest
+#define LINK_FRAME_PING        0x08U // SelfTestPing_t; gazda răspunde cu LINK_FRAME_PONG
+#define LINK_FRAME_PONG        0x09U // de la gazdă: payload-ul ping-ului, neschimbat
+// Actualizarea firmware-ului (ota.h); BEGIN, DATA și END vin de la gazdă
+#define LINK_FRAME_OTA_BEGIN   0x10U // OtaBegin_t
+#define LINK_FRAME_OTA_DATA    0x11U // u32 offset + până la OTA_BLOCK_SIZE octeți din imagine
+#define LINK_FRAME_OTA_END     0x12U // fără payload: verificare și activare
+#define LINK_FRAME_OTA_ACK     0x13U // OtaAck_t, răspunsul plăcii la fiecare cadru
+
+// Apelabile doar din BluetoothTask (blocante, pe portul legăturii:
+// USART1 sau LPUART1, după cfg link_lpuart)
+void Link_Send(const uint8_t *data, uint16_t len);
+void Link_SendFrame(uint8_t type, const uint8_t *payload, uint16_t len);
+// Răspunsuri text fără printf (stiva task-ului Bluetooth e mică)
+void Link_Print(const char *text);
+void Link_PrintU32(uint32_t value);
+// Așteptarea cu legătura inactivă: armează trezirea pe RX (EXTI pe USART1,
+// recepție prin întrerupere pe LPUART1), care setează LINK_FLAG_RX.
+// Disarm întoarce 1 dacă un octet a fost deja primit în *byte.
+void Link_ListenArm(void);
+uint8_t Link_ListenDisarm(uint8_t *byte);
+// Recepție prin întrerupere într-un buffer circular, pentru fluxurile
+// binare care nu încap în interogarea octet cu octet (ota.c): octeții
+// continuă să vină cât task-ul scrie în flash. Read întoarce câți octeți
+// a copiat până la timeoutMs.
+void Link_RxStart(void);
+void Link_RxStop(void);
+uint16_t Link_RxRead(uint8_t *out, uint16_t len, uint32_t timeoutMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LINK_H */
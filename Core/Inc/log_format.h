@@ -0,0 +1,26 @@
+#ifndef __LOG_FORMAT_H
+#define __LOG_FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Formatare printf minimală pentru înregistrările jurnalului de diagnostic,
+// cu argumentele deja reduse la cuvinte de 32 de biți. Nu depinde de HAL:
+// rulează în DiagTask (logger.c) și pe host (Tools/logdecode.c).
+// Suportă %d %i %u %x %X %c %s %p %%, cu '-', '0', lățime și 'l' (ignorat).
+// %s primește o adresă din țintă, tradusă în șir de resolveString (pe țintă
+// pointerul însuși, pe host o căutare în ELF); NULL afișează "?".
+typedef const char *(*LogResolveString_t)(uint32_t address);
+
+// Întoarce lungimea scrisă în out (trunchiată la size - 1, terminată cu 0)
+uint32_t LogFormat(char *out, uint32_t size, const char *fmt, const uint32_t *args, uint32_t nargs,
+                   LogResolveString_t resolveString);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_FORMAT_H */
@@ -0,0 +1,70 @@
+#ifndef __LOGGER_H
+#define __LOGGER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Jurnal de diagnostic cu formatare amânată. LOG() pune în bufferul
+// circular doar adresa șirului de format, timpul (ms) și argumentele brute,
+// fără blocare (rezervare cu LDREX/STREX), din task-uri și din orice ISR.
+// DiagTask (diag.c), cu prioritate mică, formatează înregistrările și le
+// trimite pe USART2 (VCP-ul ST-LINK) prin DMA; cu log_binary = 1 trimite înregistrările
+// nemodificate în cadre LINK_FRAME_LOG, formatate pe host de
+// Tools/logdecode.c cu șirurile din ELF.
+//
+// Argumentele sunt întregi sau pointeri (câte un cuvânt); %s doar pentru
+// șiruri constante, citite abia la formatare. Ieșirea printf (_write) intră
+// în același buffer, ca text deja formatat.
+//
+// Înregistrare: cuvântul 0 = adresa formatului (scris ultimul, marchează
+// înregistrarea completă) sau LOG_TAG_TEXT | octeți; cuvântul 1 = număr de
+// cuvinte de date << 28 | ms de la pornire (28 de biți); apoi datele.
+#define LOG_RING_WORDS   512U          // putere a lui 2 (2 KB)
+#define LOG_MAX_ARGS     6U
+#define LOG_MAX_DATA     15U           // cuvinte de date pe înregistrare
+#define LOG_FLAG_TX_DONE 0x01U         // flag DiagTask: transferul DMA s-a terminat
+#define LOG_DRAIN_MS     100U          // aliniat cu timerele de 100 ms
+#define LOG_TAG_TEXT     0xFF000000UL  // text brut (_write); octeții în biții de jos
+#define LOG_TAG_DROPPED  0xFE000000UL  // doar pe fir: înregistrări pierdute (buffer plin)
+#define LOG_TAG_MASK     0xFF000000UL
+
+#define LOG_ARG(x)       ((uint32_t)(uintptr_t)(x))
+#define LOG_PICK(_1, _2, _3, _4, _5, _6, _7, name, ...) name
+#define LOG(...)         LOG_PICK(__VA_ARGS__, LOG_6, LOG_5, LOG_4, LOG_3, LOG_2, LOG_1, LOG_0, _)(__VA_ARGS__)
+
+#define LOG_0(fmt)       Logger_Write((fmt), 0, 0)
+#define LOG_N(fmt, ...)  do { \
+        const uint32_t logArgs_[] = { __VA_ARGS__ }; \
+        Logger_Write((fmt), sizeof(logArgs_) / sizeof(logArgs_[0]), logArgs_); \
+    } while (0)
+#define LOG_1(fmt, a)                   LOG_N(fmt, LOG_ARG(a))
+#define LOG_2(fmt, a, b)                LOG_N(fmt, LOG_ARG(a), LOG_ARG(b))
+#define LOG_3(fmt, a, b, c)             LOG_N(fmt, LOG_ARG(a), LOG_ARG(b), LOG_ARG(c))
+#define LOG_4(fmt, a, b, c, d)          LOG_N(fmt, LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d))
+#define LOG_5(fmt, a, b, c, d, e)       LOG_N(fmt, LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d), LOG_ARG(e))
+#define LOG_6(fmt, a, b, c, d, e, f)    LOG_N(fmt, LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d), LOG_ARG(e), LOG_ARG(f))
+
+typedef struct {
+    uint32_t written;   // înregistrări golite de DiagTask
+    uint32_t dropped;   // înregistrări pierdute (buffer plin)
+    uint32_t highWater; // ocuparea maximă a bufferului, în cuvinte
+} LoggerStats_t;
+
+// LOG() se poate folosi de la pornire: înregistrările se adună până la
+// primul ciclu al DiagTask
+void Logger_Write(const char *fmt, uint32_t nargs, const uint32_t *args);
+void Logger_WriteText(const char *text, uint32_t len);
+// 1 cât timp un transfer DMA pe USART2 e în curs (Stop 2 l-ar întrerupe)
+uint8_t Logger_Busy(void);
+void Logger_GetStats(LoggerStats_t *out);
+// Din DiagTask: golește bufferul pe USART2 (text sau cadre, după log_binary)
+void Logger_Drain(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOGGER_H */
@@ -50,6 +50,8 @@ extern "C" {
 /* USER CODE END EM */
 
 /* Exported functions prototypes ---------------------------------------------*/
+void HAL_TIM_MspPostInit(TIM_HandleTypeDef *htim);
+
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
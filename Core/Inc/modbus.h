@@ -0,0 +1,104 @@
+#ifndef __MODBUS_H
+#define __MODBUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sensors.h"
+#include "sections.h"
+
+// Slave Modbus RTU pentru sistemul de management al clădirii, pe USART3
+// (PC4 TX, PC5 RX, PB14 DE spre transceiver-ul RS-485; USART2 e canalul
+// de diagnostic). Activ doar cu modbus_addr != 0, la modbus_baud și
+// modbus_parity (aplicate la repornire). Cât timp e activ, placa nu intră
+// în Stop 2: USART3 nu recepționează acolo.
+//
+// Recepția merge prin DMA direct în bufferul cadrului; sfârșitul cadrului
+// e pauza de 3,5 caractere, detectată de timeout-ul de recepție al
+// USART-ului (RTOR), nu de un timer software. ModbusTask verifică și
+// execută cererea, iar răspunsul pleacă tot prin DMA; DE e comandat de
+// USART (HAL_RS485Ex_Init), fără GPIO din software. Recepția se rearmează
+// după ultimul bit al răspunsului (TC).
+//
+// Registrele de intrare (04) sunt câmpurile lui LiveState_t, citite direct
+// din structura publicată de GasMonitorTask. Registrele holding (03, 06,
+// 16) sunt cheile de configurație, câte două registre pe cheie (2k: partea
+// superioară, 2k + 1: cea inferioară); o scriere validă se aplică imediat
+// (Config_Apply), iar flash-ul se rescrie doar dacă vreo valoare s-a schimbat.
+#define MODBUS_FRAME_MAX      256U
+#define MODBUS_RTO_US         1750U // pauza fixă peste 19200 baud
+#define MODBUS_RTO_BITS       39U   // 3,5 caractere x 11 biți (start, 8, paritate/stop, stop)
+#define MODBUS_MAX_READ       125U  // registre per citire (03, 04)
+#define MODBUS_MAX_WRITE      123U  // registre per scriere multiplă (16)
+
+#define MODBUS_FLAG_FRAME     0x01U // cadru încheiat de RTO, de procesat
+
+typedef enum {
+    MODBUS_EX_FUNCTION = 1,  // funcție neimplementată
+    MODBUS_EX_ADDRESS = 2,   // registru în afara hărții
+    MODBUS_EX_VALUE = 3,     // cantitate greșită sau valoare în afara limitelor
+} ModbusException_t;
+
+// Harta registrelor de intrare: adresa = indexul câmpului. Doar câmpuri de
+// 16 biți, în ordinea adreselor; valorile de 32 de biți în două registre,
+// partea superioară prima.
+typedef struct {
+    uint16_t ppm;            // 0: concentrația estimată
+    uint16_t counts;         // 1: ADC-ul senzorului
+    uint16_t level;          // 2: AlarmLevel_t
+    uint16_t detector;       // 3: DO al modulului activ (după debounce)
+    uint16_t safety;         // 4: calea de siguranță a acționat
+    uint16_t fanDuty;        // 5: %
+    uint16_t fanRpm;         // 6
+    uint16_t fanMode;        // 7: FanMode_t
+    uint16_t vddaMv;         // 8
+    uint16_t vbatMv;         // 9
+    int16_t temperature;     // 10: 0.1 °C
+    uint16_t lowBattery;     // 11
+    uint16_t uptimeHi;       // 12-13: secunde de la pornire
+    uint16_t uptimeLo;
+    uint16_t versionHi;      // 14-15: FW_VERSION
+    uint16_t versionLo;
+    int16_t ambientTemp;     // 16: SHT3x, 0.1 °C (0 fără citire recentă)
+    uint16_t ambientRh;      // 17: SHT3x, 0.1 %RH
+    uint16_t compensation;   // 18: factorul aplicat pe Rs/R0, x1000
+    uint16_t channelPpm[SENSOR_MAX];   // 19-26: ppm pe canal (sensors.h), 0 după ultimul
+    uint16_t channelLevel[SENSOR_MAX]; // 27-34: AlarmLevel_t pe canal
+    uint16_t warmMask;       // 35: bitul i = canalul i și-a terminat încălzirea
+    uint16_t selftest;       // 36: ultimul autotest, 2 biți SelfTestResult_t pe SelfTestItem_t
+} LiveState_t;
+
+#define MODBUS_INPUT_COUNT    (sizeof(LiveState_t) / sizeof(uint16_t))
+
+typedef struct {
+    uint32_t frames;         // cadre cu CRC corect (inclusiv pentru alte adrese)
+    uint32_t crcErrors;
+    uint32_t lineErrors;     // paritate, zgomot, depășire sau cadru prea lung
+    uint32_t replies;
+    uint32_t exceptions;
+} ModbusStats_t;
+
+// Scrisă doar de GasMonitorTask, citită de ModbusTask registru cu registru
+extern LiveState_t liveState;
+
+// După MX_USART3_UART_Init: adresa și timeout-ul de recepție (RTOR)
+void Modbus_Init(void);
+// Din GasMonitorTask, la fiecare eșantion
+void Modbus_Publish(uint16_t counts, uint16_t ppm, AlarmLevel_t level, uint8_t detector);
+// 1 dacă slave-ul e configurat (modbus_addr != 0)
+uint8_t Modbus_Enabled(void);
+// Din HAL_UART_ErrorCallback / HAL_UART_RxCpltCallback /
+// HAL_UART_TxCpltCallback, pentru USART3
+HOT_FUNC void Modbus_RxEndCallback(uint32_t errorCode);
+HOT_FUNC void Modbus_RxFullCallback(void);
+HOT_FUNC void Modbus_TxCallback(void);
+void Modbus_GetStats(ModbusStats_t *out);
+void StartModbusTask(void *argument);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MODBUS_H */
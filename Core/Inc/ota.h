@@ -0,0 +1,76 @@
+#ifndef __OTA_H
+#define __OTA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "link.h"
+
+// Actualizarea firmware-ului pe link (Tools/fwupdate.c), cu bootloader-ul
+// din Bootloader/ și harta din fw_image.h.
+//
+// Gazda trimite un cadru LINK_FRAME_OTA_BEGIN; din acel moment
+// BluetoothTask primește prin întrerupere (Link_RxStart) și nu mai
+// interpretează comenzile text până la sfârșitul sesiunii. Imaginea vine în
+// blocuri LINK_FRAME_OTA_DATA de până la OTA_BLOCK_SIZE octeți, fiecare cu
+// CRC-ul cadrului; gazda ține cel mult OTA_WINDOW blocuri neconfirmate, iar
+// placa confirmă cumulativ (nextOffset) după fiecare bloc scris în staging.
+// Un bloc pierdut sau respins se vede la următorul (offset diferit): placa
+// răspunde o singură dată cu OTA_ERR_SEQ și gazda reia de la nextOffset.
+// La LINK_FRAME_OTA_END imaginea din staging e verificată (antet, CRC-32)
+// și, dacă e validă, placa cere bootloader-ului schimbul și se resetează.
+//
+// Imaginea nouă rulează în probă: se confirmă după OTA_TRIAL_MS în care
+// WatchdogTask a reîmprospătat IWDG fără întrerupere. Orice reset înainte
+// de confirmare (watchdog, cădere, alimentare) o înlocuiește cu cea veche.
+#define OTA_BLOCK_SIZE       1024U    // multiplu de 8 (programare pe double-word)
+#define OTA_WINDOW           4U
+#define OTA_FRAME_MAX        (4U + OTA_BLOCK_SIZE)
+#define OTA_IDLE_MS          5000U    // fără cadre valide: sesiunea se închide
+#define OTA_TRIAL_MS         60000U
+
+// Flag pentru StorageTask: confirmarea imaginii sau închiderea unui rollback
+#define STORAGE_FLAG_FW      0x04U
+
+typedef enum {
+    OTA_OK = 0,
+    OTA_ERR_STATE,   // nicio sesiune, sau imaginea curentă e încă în probă
+    OTA_ERR_SIZE,    // imaginea nu încape în slot / bloc invalid
+    OTA_ERR_FLASH,   // ștergere sau programare eșuată
+    OTA_ERR_SEQ,     // offset diferit de nextOffset: reluare de acolo
+    OTA_ERR_VERIFY,  // antet sau CRC-32 greșit în staging
+} OtaStatus_t;
+
+// Payload LINK_FRAME_OTA_BEGIN
+typedef struct {
+    uint32_t imageSize;  // fișierul produs de Tools/fwpack.c, antet inclus
+} OtaBegin_t;
+
+// Payload LINK_FRAME_OTA_ACK, răspunsul la fiecare cadru al gazdei
+typedef struct {
+    uint8_t status;      // OtaStatus_t
+    uint8_t window;      // OTA_WINDOW
+    uint16_t blockSize;  // OTA_BLOCK_SIZE
+    uint32_t nextOffset; // primul octet încă nescris în staging
+} OtaAck_t;
+
+// Înainte de pornirea kernelului: citește starea de boot (probă, rollback)
+void Ota_Init(void);
+// Din BluetoothTask, după octetul LINK_FRAME_SYNC citit prin interogare;
+// revine la sfârșitul sesiunii (sau nu revine: resetul după instalare).
+// Un LINK_FRAME_PONG (selftest.h) e predat autotestului și închide sesiunea.
+void Ota_Session(void);
+// Din WatchdogTask, la fiecare reîmprospătare a IWDG
+void Ota_HealthTick(uint32_t elapsedMs);
+// Din StorageTask, la STORAGE_FLAG_FW: scrie confirmarea sau închiderea
+void Ota_Commit(void);
+// Pentru $fw
+void Ota_PrintStatus(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OTA_H */
@@ -0,0 +1,53 @@
+#ifndef __PID_H
+#define __PID_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sections.h"
+
+// Regulator PID în virgulă fixă, apelat la perioadă constantă.
+//
+// Câștigurile sunt Q8.8 (valoare x 256), în unități de ieșire per unitate
+// de intrare: kp per unitate, ki per unitate x secundă, kd per unitate/s.
+// Derivata se calculează pe măsură, nu pe eroare, ca o schimbare de
+// consemn să nu dea un impuls în ieșire. Anti-windup: integratorul e
+// limitat la plaja ieșirii și nu mai integrează cât timp ieșirea e
+// saturată (sau limitată de rampă) în direcția erorii.
+// Codul nu depinde de HAL, așa că se compilează și pe host (Tools/).
+#define PID_Q          8
+#define PID_GAIN(x)    ((int32_t)((x) * (1 << PID_Q) + 0.5))
+
+typedef struct {
+    int32_t kp;
+    int32_t ki;
+    int32_t kd;
+    int32_t outMin;
+    int32_t outMax;
+    int32_t rateLimit;       // variația maximă a ieșirii per apel (0 = fără limită)
+    uint32_t periodMs;
+    uint8_t reverse;         // 1: ieșirea crește când măsura depășește consemnul
+    int32_t integrator;      // Q8.8, în unități de ieșire
+    int32_t prevMeasurement;
+    int32_t output;
+} Pid_t;
+
+void Pid_Init(Pid_t *pid, uint32_t periodMs, int32_t outMin, int32_t outMax, uint8_t reverse);
+// Câștigurile și limita de rampă se pot schimba din mers, fără salt în ieșire
+void Pid_Configure(Pid_t *pid, int32_t kp, int32_t ki, int32_t kd, int32_t rateLimit);
+// Pornire fără salt de la ieșirea curentă a elementului de execuție
+void Pid_Reset(Pid_t *pid, int32_t measurement, int32_t output);
+HOT_FUNC int32_t Pid_Update(Pid_t *pid, int32_t setpoint, int32_t measurement);
+// Aceeași funcție, executată din flash: doar pentru comparația din $bench
+int32_t Pid_UpdateFlash(Pid_t *pid, int32_t setpoint, int32_t measurement);
+// Ieșirea aplicată efectiv diferă (limită externă, comandă prioritară):
+// integratorul o urmărește ca revenirea la PID să fie fără salt
+void Pid_Track(Pid_t *pid, int32_t applied);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PID_H */
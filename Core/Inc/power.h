@@ -0,0 +1,56 @@
+#ifndef __POWER_H
+#define __POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "energy.h"
+
+// Idle fără tick (configUSE_TICKLESS_IDLE = 2): cu low_power = 1, când toate
+// task-urile sunt blocate cel puțin POWER_MIN_STOP_MS, placa intră în Stop 2
+// și e trezită de timerul de trezire RTC (LSE) la următorul termen din
+// kernel, de calea de siguranță (EXTI0) sau de un front pe RX-ul legăturii.
+// Ventilatorul (TIM3) și buzzerul (LPTIM1/TIM6) nu merg în Stop 2, deci cât
+// timp sunt active rămâne doar Sleep (WFI, tick-ul continuă).
+#define POWER_MIN_STOP_MS   5U    // sub acest interval trezirea costă mai mult
+#define POWER_MAX_STOP_MS   1000U // IWDG merge și în Stop: sub WATCHDOG_TIMEOUT_MS
+// 1: PB13 (LD4) e ridicat cât timp nucleul e treaz, pentru osciloscop
+#define POWER_TRACE         0
+// Tensiunea presupusă pentru estimarea energiei (µWh) din $power
+#define POWER_SUPPLY_MV     3300U
+
+typedef enum {
+    POWER_WAKE_RTC = 0,  // termenul kernelului (timerul de trezire RTC)
+    POWER_WAKE_GAS,      // DO al senzorului (EXTI0)
+    POWER_WAKE_LINK,     // RX: front de start (EXTI7) sau LPUART1
+    POWER_WAKE_OTHER,
+    POWER_WAKE_COUNT
+} PowerWake_t;
+
+typedef struct {
+    uint32_t stopCount;                // intrări în Stop 2
+    uint32_t lastStopMs;
+    EnergyResidency_t residency;       // de la Power_ResetStats; run = restul
+    uint32_t wakeCount[POWER_WAKE_COUNT];
+    uint8_t lse;                       // 1 = RTC pe LSE, 0 = pe LSI (LSE nu a pornit)
+} PowerStats_t;
+
+// Înainte de Watchdog_Init: pornirea LSE poate dura până la o secundă
+void Power_Init(void);
+// portSUPPRESS_TICKS_AND_SLEEP, din task-ul idle cu schedulerul suspendat
+void Power_Sleep(uint32_t expectedTicks);
+// RX-ul USART1 ca sursă de trezire (prin Link_ListenArm)
+void Power_LinkWakeArm(uint8_t enable);
+// Din HAL_GPIO_EXTI_Callback, pentru PB7
+void Power_LinkWakeCallback(void);
+void Power_GetStats(PowerStats_t *out);
+// Pornește o fereastră nouă de măsurare (rezidență și treziri)
+void Power_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __POWER_H */
@@ -0,0 +1,41 @@
+#ifndef __SAFETY_H
+#define __SAFETY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Calea de siguranță: frontul descendent al ieșirii DO a senzorului (PA0,
+// EXTI0) pornește ventilatorul la fan_duty_alarm și buzzerul direct din
+// întrerupere, fără să aștepte GasMonitorTask. Întreruperea are prioritate
+// peste configMAX_SYSCALL_INTERRUPT_PRIORITY, deci nu e întârziată de
+// secțiunile critice ale kernelului și nu apelează funcții FreeRTOS;
+// raportarea (jurnal, mesaje) rămâne în task-uri. Cât timp MQ-2 se
+// încălzește (baseline.h) DO poate comuta fără gaz: declanșarea pornește
+// atunci doar ventilatorul, fără buzzer.
+#define SAFETY_IRQ_PRIORITY 2U
+
+typedef struct {
+    uint32_t trips;       // declanșări de la pornire
+    uint32_t lastCycles;  // cicluri de la intrarea în callback până la actuatoare
+    uint32_t maxCycles;   // cel mai rău caz observat
+} SafetyStats_t;
+
+// După Fan_Init și Buzzer_Init: activează EXTI0; dacă DO e deja activ
+// (gaz prezent la pornire) declanșează imediat
+void Safety_Init(void);
+// DO activ acum (nivel jos pe PA0), citit direct din IDR
+uint8_t Safety_Active(void);
+// Pentru raportare din task: 1 dacă a avut loc o declanșare nouă
+uint8_t Safety_TakeTrip(void);
+// 1 = declanșările nu pornesc buzzerul (senzor în încălzire)
+void Safety_SetQuiet(uint8_t quiet);
+void Safety_GetStats(SafetyStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SAFETY_H */
@@ -0,0 +1,57 @@
+#ifndef __SAMPLE_CODEC_H
+#define __SAMPLE_CODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Codare compactă pentru fluxuri de eșantioane (istoric și streaming).
+//
+// Format bloc (toate numerele sunt varint LEB128):
+//   antet:   timestamp0, valoare0
+//   apoi, pentru fiecare eșantion următor, unul dintre tokenii:
+//     literal: zigzag(dv) << 1       urmat de zigzag(ddt)
+//     run:     (k << 1) | 1          k eșantioane cu dv == 0 și ddt == 0
+// unde dv = delta valorii, iar ddt = delta intervalului de timp față de
+// intervalul anterior (primul interval este codat față de 0).
+// Codul nu depinde de HAL, așa că se compilează și pe host (Tools/).
+
+typedef struct {
+    uint32_t timestamp; // ms de la pornire
+    uint16_t value;
+} Sample_t;
+
+// Octeți de rezervă pe care Put îi cere liberi: run în așteptare (5) +
+// literal (3 + 5) + run final la Finish (5)
+#define SAMPLE_ENCODER_RESERVE 18U
+
+typedef struct {
+    uint8_t *out;
+    size_t size;
+    size_t len;
+    uint32_t count;
+    uint32_t prevTimestamp;
+    uint32_t prevInterval;
+    uint16_t prevValue;
+    uint32_t run;
+} SampleEncoder_t;
+
+void SampleEncoder_Init(SampleEncoder_t *enc, uint8_t *out, size_t size);
+// Returnează 0 la succes, -1 dacă bufferul nu mai are loc pentru eșantion
+int SampleEncoder_Put(SampleEncoder_t *enc, const Sample_t *sample);
+// Închide run-ul în așteptare și returnează lungimea blocului
+size_t SampleEncoder_Finish(SampleEncoder_t *enc);
+
+// Codează un vector întreg; returnează 0 dacă nu încape în out
+size_t SampleCodec_Encode(const Sample_t *samples, size_t count, uint8_t *out, size_t size);
+// Decodează un bloc; returnează numărul de eșantioane, sau -1 la bloc corupt
+int32_t SampleCodec_Decode(const uint8_t *in, size_t len, Sample_t *out, size_t maxCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SAMPLE_CODEC_H */
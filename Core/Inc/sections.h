@@ -0,0 +1,47 @@
+#ifndef __SECTIONS_H
+#define __SECTIONS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Plasarea explicită în SRAM2 (32 KB la 0x10000000, STM32L452RETXP_FLASH.ld).
+//
+// SRAM2_ZERO: date puse la zero de startup, ca .bss. Inițializatorii sunt
+//   ignorați (secțiunea e NOLOAD), deci variabilele se declară fără ei.
+// SRAM2_NOINIT: date pe care startup-ul nu le atinge: supraviețuiesc unui
+//   reset de sistem (software, watchdog, pin), dar la pornirea de la
+//   alimentare conțin zgomot, deci se validează (număr magic, CRC).
+// RAMFUNC: cod copiat din flash la pornire și executat din SRAM2, pe
+//   magistrala I-Code, fără stările de așteptare ale flash-ului și fără
+//   să fie afectat de ștergerea/programarea flash-ului. Apelurile între
+//   flash și SRAM2 depășesc raza unui BL, de aici long_call (pus și pe
+//   declarația din header; altfel linkerul adaugă un veneer); noinline
+//   împiedică copierea corpului în apelanții din flash.
+#define SRAM2_ZERO   __attribute__((section(".sram2")))
+#define SRAM2_NOINIT __attribute__((section(".sram2_noinit")))
+#define RAMFUNC      __attribute__((section(".ramfunc"), noinline, long_call))
+
+// Căile fierbinți (întreruperile UART/EXTI/DMA și nucleele pe eșantion, vezi
+// hot_path.h) rulează din SRAM2 cu RAM_HOT_PATHS = 1; cu 0 rămân în flash,
+// ca ciclurile să se poată compara între cele două build-uri. Pe host
+// (Tools/) macro-urile sunt goale.
+#ifndef RAM_HOT_PATHS
+#define RAM_HOT_PATHS 1
+#endif
+
+#if RAM_HOT_PATHS && defined(__arm__)
+#define HOT_FUNC  RAMFUNC
+// Tabele citite din căile fierbinți: copiate în SRAM2 cu codul, ca
+// întreruperea să nu atingă flash-ul cât acesta e șters sau programat
+#define HOT_CONST __attribute__((section(".ramfunc.rodata")))
+#else
+#define HOT_FUNC
+#define HOT_CONST
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SECTIONS_H */
@@ -0,0 +1,94 @@
+#ifndef __SELFTEST_H
+#define __SELFTEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Autotestul lanțului de alarmă, pornit cu $selftest run sau la fiecare
+// selftest_h ore. Un timer software avansează pașii, fiecare scurt; nimic
+// nu așteaptă în GasMonitorTask, iar calea de siguranță și nivelurile de
+// alarmă rămân active tot timpul:
+//   1. senzori: counts fiecărui canal în SELFTEST_COUNTS_MIN..MAX (altfel
+//      ieșire în scurt la masă/alimentare sau modul deconectat);
+//   2. buzzer: un BUZZER_BEEP (cea mai mică prioritate: orice alarmă îl
+//      înlocuiește) și fronturile de pe PB2. Doar comanda e verificată:
+//      PB2 e ieșirea MCU, fără citire înapoi de la buzzer, deci un buzzer
+//      deconectat nu se vede. Cu tonul comandat rezultatul e SKIP, fără
+//      fronturi FAIL (timer oprit, pin în scurt);
+//   3. ventilator: minim SELFTEST_FAN_DUTY (Fan_SetTest, doar ridică
+//      factorul de umplere) și turația de la turometru după SELFTEST_FAN_MS
+//      (sărit cu fan_tach = 0);
+//   4. link: LINK_FRAME_PING trimis de BluetoothTask, timpul până la
+//      LINK_FRAME_PONG de la gazdă.
+// Buzzerul și ventilatorul se sar cât timp un canal e peste praguri sau DO
+// e activ: atunci chiar lucrează, iar alarma nu e întreruptă de test.
+// Raportul (SelfTestReport_t) pleacă pe link ca LINK_FRAME_SELFTEST, intră
+// în jurnal ca EVT_SELFTEST și apare în registrul Modbus 36.
+#define SELFTEST_COUNTS_MIN       40U      // ~1% din scală
+#define SELFTEST_COUNTS_MAX       4055U
+#define SELFTEST_BUZZER_WINDOW_US 2000U    // ~5 perioade din tonul de 2.7 kHz
+#define SELFTEST_BUZZER_EDGES     4U
+#define SELFTEST_FAN_DUTY         60U      // %
+#define SELFTEST_FAN_MS           5000U    // rampa + FAN_TACH_TIMEOUT_MS
+#define SELFTEST_FAN_MIN_RPM      300U
+#define SELFTEST_LINK_TIMEOUT_MS  2000U
+#define SELFTEST_STEP_MS          100U     // pasul timerului cât se așteaptă
+
+typedef enum {
+    SELFTEST_NOT_RUN = 0,
+    SELFTEST_PASS = 1,
+    SELFTEST_FAIL = 2,
+    SELFTEST_SKIP = 3,       // neverificabil (alarmă activă, link inactiv, buzzer fără citire înapoi)
+} SelfTestResult_t;
+
+typedef enum {
+    SELFTEST_SENSORS = 0,
+    SELFTEST_BUZZER,
+    SELFTEST_FAN,
+    SELFTEST_LINK,
+    SELFTEST_ITEM_COUNT
+} SelfTestItem_t;
+
+typedef struct {
+    uint32_t timestamp;      // ms de la pornire, la sfârșitul testului
+    uint16_t sequence;       // numărul rulării de la pornire
+    uint8_t manual;          // 1 = pornit prin comandă, 0 = programat
+    uint8_t badChannels;     // canale (sensors.h) în afara domeniului
+    uint8_t result[SELFTEST_ITEM_COUNT]; // SelfTestResult_t
+    uint16_t buzzerEdges;
+    uint16_t fanRpm;
+    uint16_t linkRttMs;
+    uint16_t reserved;
+} SelfTestReport_t;
+
+// Payload LINK_FRAME_PING (și LINK_FRAME_PONG)
+typedef struct {
+    uint32_t token;          // sequence << 16 | contor de ping-uri
+    uint32_t sentMs;
+} SelfTestPing_t;
+
+// După Fan_Init, Buzzer_Init și Sensors_Init
+void SelfTest_Init(void);
+// Test la cerere ($selftest run); -1 dacă unul rulează deja
+int SelfTest_Start(void);
+uint8_t SelfTest_Running(void);
+// Din BluetoothTask la fiecare trecere: 1 dacă trebuie trimis ping-ul din
+// *ping. Cu legătura inactivă pasul de link e sărit.
+uint8_t SelfTest_LinkPoll(uint8_t linkActive, SelfTestPing_t *ping);
+// Din sesiunea de cadre (ota.c), la LINK_FRAME_PONG
+void SelfTest_Pong(const uint8_t *payload, uint16_t len);
+// 1 dacă un raport nou n-a fost încă trimis pe link
+uint8_t SelfTest_TakeReport(SelfTestReport_t *out);
+// Ultimul raport complet (timestamp 0 = niciun test)
+void SelfTest_GetReport(SelfTestReport_t *out);
+// Rezultatele ultimului test, câte 2 biți pe element (registrul Modbus)
+uint16_t SelfTest_Summary(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SELFTEST_H */
@@ -0,0 +1,60 @@
+#ifndef __SENSORS_H
+#define __SENSORS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stm32l4xx.h"
+#include "gas_sensor.h"
+
+// Senzorii de gaz de pe placă, descriși de tabelul din sensors.c: pinul,
+// canalul ADC, curba, R0 și pragurile fiecăruia. Un senzor nou înseamnă o
+// intrare nouă în tabel, nimic altceva.
+//
+// La fiecare eșantion toate canalele se convertesc într-o singură secvență
+// ADC (Adc_Scan), copiată de DMA; CPU-ul face apoi doar conversia în ppm și
+// nivelul de alarmă al fiecărui canal, deci costul crește liniar cu
+// numărul de canale. Fiecare canal are nivelul lui, cu histerezis, iar
+// schimbările intră în același jurnal: EVT_GAS_* cu aux = indexul canalului.
+// Încălzirea și R0 urmărit al fiecărui canal vin din baseline.h.
+#define SENSOR_MAX      8U   // registrele Modbus rezervate per canal
+#define SENSOR_PRIMARY  0U   // MQ-2: istoricul, ventilatorul și registrele 0-2
+
+typedef struct {
+    const char *name;
+    GPIO_TypeDef *port;       // AO al modulului, în mod analogic
+    uint16_t pin;
+    uint8_t adcChannel;
+    uint8_t sampleTime;       // ADC_SMP_*
+    uint8_t compensate;       // 1: factorul T/RH al MQ-2 (GasSensor_SetConditions)
+    const GasCurve_t *curve;
+    const uint16_t *r0;       // R0/RL x 1000, punctul de plecare al lui Baseline_R0
+    uint16_t cleanRatio;      // Rs/R0 în aer curat x 1000 (foaia de catalog)
+    const uint16_t *warnPpm;
+    const uint16_t *alarmPpm;
+} SensorChannel_t;
+
+typedef struct {
+    uint16_t counts;
+    uint16_t ppm;
+    AlarmLevel_t level;
+} SensorState_t;
+
+// Pinii analogici, ADC-ul (calibrare, timpi de eșantionare) și secvența
+void Sensors_Init(void);
+// Între Adc_PowerUp și Adc_PowerDown; întoarce nivelul cel mai mare dintre
+// canale (ALARM_NONE pentru cele încă în încălzire)
+AlarmLevel_t Sensors_Scan(uint32_t now);
+uint8_t Sensors_Count(void);
+const SensorChannel_t *Sensors_Channel(uint8_t index);
+void Sensors_Get(uint8_t index, SensorState_t *out);
+// Cicluri CPU ale ultimului Sensors_Scan (secvența ADC inclusă)
+uint32_t Sensors_ScanCycles(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSORS_H */
@@ -0,0 +1,49 @@
+#ifndef __STACK_GUARD_H
+#define __STACK_GUARD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32l4xx.h"
+
+// Gărzi MPU de 32 de octeți fără acces sub stiva MSP (regiune fixă) și sub
+// stiva task-ului curent (o singură regiune, mutată la fiecare comutare din
+// traceTASK_SWITCHED_IN). O depășire care atinge garda dă MemManage, prins
+// de crash_dump ca CRASH_STACK_OVERFLOW. Sub gardă rămân primii 16 octeți
+// ai stivei, modelul verificat de configCHECK_FOR_STACK_OVERFLOW = 2, care
+// prinde depășirile ce sar peste gardă (cadre mari, neatinse complet).
+#define STACK_GUARD_SIZE        32U // regiunea MPU minimă
+#define STACK_GUARD_CANARY      16U // portSTACK_LIMIT_PADDING pentru metoda 2
+#define STACK_GUARD_MSP_REGION  6U
+#define STACK_GUARD_TASK_REGION 7U // număr mai mare: prioritate în MPU
+
+// Adresa gărzii pentru o stivă care începe (jos) la stackBottom
+#define STACK_GUARD_BASE(stackBottom) \
+    (((uint32_t)(stackBottom) + STACK_GUARD_CANARY + STACK_GUARD_SIZE - 1U) & ~(STACK_GUARD_SIZE - 1U))
+
+// Din vTaskSwitchContext (PendSV): atributele regiunii nu se schimbă, deci
+// o singură scriere în RBAR (cu VALID, fără RNR). Revenirea din PendSV
+// serializează accesul, nu trebuie DSB/ISB.
+static inline void StackGuard_SwitchIn(const void *stackBottom) {
+    MPU->RBAR = STACK_GUARD_BASE(stackBottom) | MPU_RBAR_VALID_Msk | STACK_GUARD_TASK_REGION;
+}
+
+// Înainte de osKernelStart: programează gărzile și pornește MPU
+// (PRIVDEFENA: restul memoriei rămâne cu harta implicită)
+void StackGuard_Init(void);
+// 1 dacă defectul MemManage vine dintr-o gardă (MSTKERR sau MMFAR în gardă)
+uint8_t StackGuard_Hit(uint32_t cfsr, uint32_t mmfar);
+// Oprește MPU, ca handlerul de cădere să poată citi stiva de sub gardă
+void StackGuard_Disable(void);
+// Ca osThreadGetStackSpace (octeți neatinși), dar fără să citească garda:
+// pentru task-ul curent garda e activă și citirea ei ar da MemManage.
+// thread e un osThreadId_t (antetul e inclus din FreeRTOSConfig.h, înainte
+// de cmsis_os.h)
+uint32_t StackGuard_StackSpace(void *thread);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STACK_GUARD_H */
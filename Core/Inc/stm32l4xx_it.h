@@ -27,7 +27,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "sections.h"
 /* USER CODE END Includes */
 
 /* Exported types ------------------------------------------------------------*/
@@ -47,14 +47,31 @@
 
 /* Exported functions prototypes ---------------------------------------------*/
 void NMI_Handler(void);
-void HardFault_Handler(void);
-void MemManage_Handler(void);
-void BusFault_Handler(void);
-void UsageFault_Handler(void);
 void DebugMon_Handler(void);
 void SysTick_Handler(void);
+void EXTI0_IRQHandler(void);
+void DMA1_Channel2_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+void DMA1_Channel7_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+void TIM2_IRQHandler(void);
+void I2C1_EV_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+void USART1_IRQHandler(void);
+void USART2_IRQHandler(void);
+void USART3_IRQHandler(void);
+void TIM6_DAC_IRQHandler(void);
+void DMA2_Channel6_IRQHandler(void);
+void LPUART1_IRQHandler(void);
 /* USER CODE BEGIN EFP */
-
+void RTC_WKUP_IRQHandler(void);
+/* Handlers executed from SRAM2 when RAM_HOT_PATHS is set (hot_path.h) */
+HOT_FUNC void EXTI0_IRQHandler(void);
+HOT_FUNC void DMA1_Channel7_IRQHandler(void);
+HOT_FUNC void USART1_IRQHandler(void);
+HOT_FUNC void USART2_IRQHandler(void);
+HOT_FUNC void USART3_IRQHandler(void);
+HOT_FUNC void LPUART1_IRQHandler(void);
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
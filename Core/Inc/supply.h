@@ -0,0 +1,47 @@
+#ifndef __SUPPLY_H
+#define __SUPPLY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Supravegherea alimentării din canalele interne ale ADC1: VREFINT (din
+// care rezultă VDDA), VBAT (prin divizorul intern de 3) și senzorul de
+// temperatură. Măsurarea se face din bucla de gaz, o dată la supply_ms, cât
+// timp ADC-ul e oricum pornit pentru eșantionul de gaz; căile interne se
+// activează doar pe durata măsurării (divizorul VBAT consumă din baterie).
+#define SUPPLY_VREFINT_CHANNEL 0U
+#define SUPPLY_TEMP_CHANNEL    17U
+#define SUPPLY_VBAT_CHANNEL    18U
+#define SUPPLY_TSTART_US       120U // pornirea senzorului de temperatură
+#define SUPPLY_HYSTERESIS_MV   100U // revenirea din baterie descărcată
+
+typedef struct {
+    uint32_t timestamp;  // ms de la pornire
+    uint16_t vddaMv;
+    uint16_t vbatMv;
+    int16_t temperature; // 0.1 °C
+    uint8_t lowBattery;  // 1 = VBAT sub batt_low_mv (cu histerezis)
+    uint8_t reserved;
+} SupplyReading_t;       // și payload-ul cadrului LINK_FRAME_SUPPLY
+
+void Supply_Init(void);
+// 1 dacă a trecut supply_ms de la ultima măsurare
+uint8_t Supply_Due(uint32_t now);
+// Între Adc_PowerUp și Adc_PowerDown; întoarce 1 la schimbarea stării
+// lowBattery
+uint8_t Supply_Measure(uint32_t now);
+// Ultima măsurare (timestamp 0: încă nicio măsurare) și numărul ei de ordine
+uint32_t Supply_Get(SupplyReading_t *out);
+uint8_t Supply_LowBattery(void);
+// Perioada buclei de gaz: sample_ms, mărită la batt_sample_ms cât timp
+// bateria e descărcată
+uint32_t Supply_SamplePeriod(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SUPPLY_H */
@@ -0,0 +1,53 @@
+#ifndef __WATCHDOG_H
+#define __WATCHDOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Supervizor IWDG: WatchdogTask reîmprospătează watchdog-ul doar cât timp
+// fiecare task înregistrat s-a anunțat în termenul lui. Altfel scrie în
+// registrele de backup ce task a întârziat și lasă IWDG să reseteze placa;
+// la pornirea următoare Watchdog_Init raportează în jurnal.
+#define WATCHDOG_TIMEOUT_MS 2000U // IWDG: LSI 32 kHz / 32, reload 2000
+#define WATCHDOG_PERIOD_MS  250U  // verificarea termenelor și reîmprospătarea
+
+typedef enum {
+    WDG_TASK_GAS = 0,
+    WDG_TASK_BLUETOOTH,
+    WDG_TASK_STORAGE,
+    WDG_TASK_TIMER,      // taskul de timere (controlul ventilatorului)
+    WDG_TASK_COUNT
+} WatchdogTask_t;
+
+// Tick-ul HAL (1 ms), incrementat din SysTick
+extern volatile uint32_t uwTick;
+extern volatile uint32_t watchdogCheckIn[WDG_TASK_COUNT];
+
+// Anunțare de viață: o singură scriere pe 32 de biți, fără apel și fără
+// secțiune critică, deci se poate pune și în buclele critice
+static inline void Watchdog_CheckIn(WatchdogTask_t task) {
+    watchdogCheckIn[task] = uwTick;
+}
+
+// După EventLog_Init: raportează resetul anterior de watchdog (dacă e cazul)
+// și pornește IWDG. Din acest moment WatchdogTask trebuie să ruleze.
+void Watchdog_Init(void);
+// Termenul (ms) în care task-ul trebuie să se anunțe; 0 = nesupravegheat.
+// Se poate reapela când termenul se schimbă (ex. sample_ms).
+void Watchdog_Register(WatchdogTask_t task, uint32_t deadlineMs);
+// Vârsta ultimei anunțări, pentru diagnostic
+uint32_t Watchdog_Age(WatchdogTask_t task);
+uint32_t Watchdog_Deadline(WatchdogTask_t task);
+const char *Watchdog_TaskName(WatchdogTask_t task);
+// Resetul anterior: mască de task-uri întârziate (0 dacă nu a fost de watchdog)
+uint32_t Watchdog_LastResetMask(void);
+void StartWatchdogTask(void *argument);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WATCHDOG_H */
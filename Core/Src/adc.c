@@ -0,0 +1,111 @@
+#include "main.h"
+#include "adc.h"
+
+static uint32_t sequence[4];   // SQR1..SQR4 pentru Adc_Scan
+static uint32_t sequenceLength;
+
+// Pornirea regulatorului ADC (t_ADCVREG_STUP = 20 us)
+static void RegulatorStart(void) {
+    ADC1->CR |= ADC_CR_ADVREGEN;
+    for (volatile uint32_t i = 0; i < SystemCoreClock / 50000U; i++) {
+    }
+}
+
+void Adc_Init(void) {
+    __HAL_RCC_ADC_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    // DMA1 canal 1, cererea 0: ADC1
+    DMA1_CSELR->CSELR &= ~DMA_CSELR_C1S;
+
+    // Ceas sincron HCLK/2 = 40 MHz
+    ADC1_COMMON->CCR = (ADC1_COMMON->CCR & ~ADC_CCR_CKMODE) | (2U << ADC_CCR_CKMODE_Pos);
+
+    // Ieșire din deep power-down, apoi calibrare single-ended
+    ADC1->CR &= ~ADC_CR_DEEPPWD;
+    RegulatorStart();
+    ADC1->CR &= ~ADC_CR_ADCALDIF;
+    ADC1->CR |= ADC_CR_ADCAL;
+    while (ADC1->CR & ADC_CR_ADCAL) {
+    }
+
+    // Supraeșantionare 16x cu shift 4: medie pe 12 biți, fără cost de CPU
+    ADC1->CFGR2 = ADC_CFGR2_ROVSE | (3U << ADC_CFGR2_OVSR_Pos) | (4U << ADC_CFGR2_OVSS_Pos);
+    ADC1->CR &= ~ADC_CR_ADVREGEN;
+}
+
+void Adc_SetSampleTime(uint32_t channel, uint32_t smp) {
+    if (channel < 10U) {
+        MODIFY_REG(ADC1->SMPR1, ADC_SMPR1_SMP0 << (channel * 3U), smp << (channel * 3U));
+    } else {
+        MODIFY_REG(ADC1->SMPR2, ADC_SMPR2_SMP10 << ((channel - 10U) * 3U), smp << ((channel - 10U) * 3U));
+    }
+}
+
+void Adc_PowerUp(void) {
+    RegulatorStart();
+    ADC1->ISR = ADC_ISR_ADRDY;
+    ADC1->CR |= ADC_CR_ADEN;
+    while ((ADC1->ISR & ADC_ISR_ADRDY) == 0) {
+    }
+}
+
+void Adc_PowerDown(void) {
+    ADC1->CR |= ADC_CR_ADDIS;
+    while (ADC1->CR & ADC_CR_ADEN) {
+    }
+    ADC1->CR &= ~ADC_CR_ADVREGEN;
+}
+
+uint16_t Adc_Read(uint32_t channel) {
+    ADC1->SQR1 = channel << ADC_SQR1_SQ1_Pos;
+    ADC1->ISR = ADC_ISR_EOC;
+    ADC1->CR |= ADC_CR_ADSTART;
+    while ((ADC1->ISR & ADC_ISR_EOC) == 0) {
+    }
+    return (uint16_t)ADC1->DR;
+}
+
+void Adc_SetSequence(const uint8_t *channels, uint32_t count) {
+    if (count == 0 || count > ADC_SEQ_MAX) {
+        return;
+    }
+    // SQ1..SQ4 în SQR1 după câmpul L, apoi câte cinci în SQR2..SQR4
+    sequence[0] = count - 1U;
+    sequence[1] = sequence[2] = sequence[3] = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (i < 4U) {
+            sequence[0] |= (uint32_t)channels[i] << (6U * (i + 1U));
+        } else {
+            sequence[1U + (i - 4U) / 5U] |= (uint32_t)channels[i] << (6U * ((i - 4U) % 5U));
+        }
+    }
+    sequenceLength = count;
+}
+
+void Adc_Scan(uint16_t *results) {
+    // Mod single: ADC-ul se oprește singur după ultima conversie, iar DMA-ul
+    // (one-shot, DMACFG = 0) după ultimul transfer; CPU-ul doar așteaptă
+    DMA1_Channel1->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    DMA1_Channel1->CPAR = (uint32_t)&ADC1->DR;
+    DMA1_Channel1->CMAR = (uint32_t)results;
+    DMA1_Channel1->CNDTR = sequenceLength;
+    DMA1_Channel1->CCR = DMA_CCR_MINC | DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_EN;
+
+    ADC1->SQR1 = sequence[0];
+    ADC1->SQR2 = sequence[1];
+    ADC1->SQR3 = sequence[2];
+    ADC1->SQR4 = sequence[3];
+    ADC1->CFGR |= ADC_CFGR_DMAEN;
+    ADC1->ISR = ADC_ISR_EOC | ADC_ISR_EOS | ADC_ISR_OVR;
+    ADC1->CR |= ADC_CR_ADSTART;
+    while ((DMA1->ISR & DMA_ISR_TCIF1) == 0) {
+    }
+    while (ADC1->CR & ADC_CR_ADSTART) {
+    }
+
+    // Adc_Read citește din nou DR direct, fără DMA
+    ADC1->CFGR &= ~ADC_CFGR_DMAEN;
+    DMA1_Channel1->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+}
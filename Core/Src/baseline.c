@@ -0,0 +1,237 @@
+#include "main.h"
+#include "baseline.h"
+#include "config.h"
+#include "event_log.h"
+#include "logger.h"
+
+// Un registru de backup per canal: R0 din tabel << 16 | R0 urmărit
+// (BKP0R/BKP1R sunt ale watchdog-ului), apoi masca canalelor calde
+#define BASELINE_BKP(index)  ((&RTC->BKP2R)[index])
+#define BASELINE_BKP_WARM    BASELINE_BKP(SENSOR_MAX)
+#define BASELINE_WARM_MAGIC  0x574D0000U // "WM" + mască în octeții de jos
+
+_Static_assert(3U + SENSOR_MAX <= 32U, "baseline: prea puține registre de backup");
+
+typedef struct {
+    // Încălzire
+    uint32_t start;
+    uint32_t windowStart;
+    uint32_t windowSum;
+    uint16_t windowCount;
+    uint16_t previous;       // media ferestrei anterioare
+    uint16_t windows;        // ferestre încheiate
+    uint8_t stable;          // ferestre stabile consecutive
+    uint8_t started;
+    uint8_t warm;
+    uint8_t timedOut;
+    uint32_t warmupMs;
+    // Linie de bază
+    uint16_t r0;
+    uint16_t configured;
+    uint16_t logged;         // R0 din ultimul EVT_BASELINE
+    uint32_t cleanStart;
+    uint32_t cleanCount;     // 0 = fereastră de aer curat neîncepută
+    uint64_t cleanSum;
+    uint16_t cleanMin;
+    uint16_t cleanMax;
+} Channel_t;
+
+static Channel_t channels[SENSOR_MAX];
+
+static uint16_t Bound(uint32_t r0, uint16_t configured) {
+    uint32_t low = configured - configured * BASELINE_LIMIT_PCT / 100U;
+    uint32_t high = configured + configured * BASELINE_LIMIT_PCT / 100U;
+
+    if (high > 0xFFFFU) {
+        high = 0xFFFFU;
+    }
+    return (uint16_t)((r0 < low) ? low : (r0 > high) ? high : r0);
+}
+
+static void Save(uint8_t index, const Channel_t *c) {
+    BASELINE_BKP(index) = ((uint32_t)c->configured << 16) | c->r0;
+}
+
+void Baseline_Init(void) {
+    uint32_t warmMask = 0;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_RCC_RTCAPB_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    // Încălzitorul se răcește doar fără alimentare (BOR, inclusiv pornirea;
+    // registrele de backup rămân cu VBAT). După un reset de watchdog, OTA sau
+    // cădere senzorii sunt tot calzi: DO și buzzerul rămân active imediat.
+    // Înainte de __HAL_RCC_CLEAR_RESET_FLAGS din main.
+    if (!__HAL_RCC_GET_FLAG(RCC_FLAG_BORRST) && (BASELINE_BKP_WARM & 0xFFFF0000U) == BASELINE_WARM_MAGIC) {
+        warmMask = BASELINE_BKP_WARM & 0xFFFFU;
+    }
+    BASELINE_BKP_WARM = BASELINE_WARM_MAGIC | warmMask;
+
+    for (uint8_t i = 0; i < Sensors_Count(); i++) {
+        Channel_t *c = &channels[i];
+        uint32_t saved = BASELINE_BKP(i);
+
+        c->configured = *Sensors_Channel(i)->r0;
+        c->r0 = c->configured;
+        // Valoarea salvată contează doar pentru același R0 din configurație
+        if ((saved >> 16) == c->configured && (uint16_t)saved == Bound((uint16_t)saved, c->configured)) {
+            c->r0 = (uint16_t)saved;
+        }
+        c->logged = c->r0;
+        c->warm = (config.warmupMaxS == 0) || (warmMask & (1U << i)) != 0;
+        if (c->warm) {
+            BASELINE_BKP_WARM |= 1U << i;
+        }
+        Save(i, c);
+    }
+}
+
+static void WarmupDone(uint8_t index, Channel_t *c, uint32_t now, uint8_t timedOut) {
+    c->warm = 1;
+    c->timedOut = timedOut;
+    c->warmupMs = now - c->start;
+    BASELINE_BKP_WARM |= 1U << index;
+    LOG("%s: incalzit in %u ms%s", Sensors_Channel(index)->name, c->warmupMs, timedOut ? " (expirat)" : "");
+    EventLog_Append(EVT_WARMUP_DONE, (uint16_t)((c->warmupMs / 1000U > 0xFFFFU) ? 0xFFFFU : c->warmupMs / 1000U),
+                    (uint16_t)(index | (timedOut ? 0x8000U : 0U)));
+}
+
+static void Warmup(uint8_t index, Channel_t *c, uint16_t counts, uint32_t now) {
+    if (!c->started) {
+        c->started = 1;
+        c->start = now;
+        c->windowStart = now;
+    }
+    c->windowSum += counts;
+    c->windowCount++;
+
+    // Stabilitatea se judecă pe medii de fereastră, nu pe eșantioane
+    // individuale: zgomotul nu amână încălzirea, deriva o amână
+    if (now - c->windowStart >= WARMUP_WINDOW_MS) {
+        uint16_t average = (uint16_t)(c->windowSum / c->windowCount);
+        uint16_t drift = (average / 100U > WARMUP_DRIFT_MIN) ? average / 100U : WARMUP_DRIFT_MIN;
+        uint16_t delta = (average > c->previous) ? average - c->previous : c->previous - average;
+
+        c->stable = (c->windows != 0 && delta <= drift) ? c->stable + 1U : 0U;
+        c->previous = average;
+        c->windows++;
+        c->windowSum = 0;
+        c->windowCount = 0;
+        c->windowStart = now;
+    }
+
+    if (c->stable >= WARMUP_STABLE_WINDOWS || config.warmupMaxS == 0) {
+        WarmupDone(index, c, now, 0);
+    } else if (now - c->start >= config.warmupMaxS * 1000UL) {
+        WarmupDone(index, c, now, 1);
+    }
+}
+
+// R0/RL x 1000 care ar da exact raportul de aer curat al senzorului
+static uint16_t Estimate(const SensorChannel_t *channel, uint16_t counts, uint16_t factor) {
+    uint64_t r0;
+
+    if (counts == 0 || counts >= GAS_SENSOR_FULL_SCALE) {
+        return 0;
+    }
+    r0 = ((uint64_t)(GAS_SENSOR_FULL_SCALE - counts) * 1000000000ULL) /
+         ((uint64_t)counts * channel->cleanRatio * factor);
+    return (uint16_t)((r0 > 0xFFFFU) ? 0xFFFFU : r0);
+}
+
+static void Track(uint8_t index, Channel_t *c, uint16_t estimate, uint32_t now) {
+    uint32_t spread = (uint32_t)c->r0 * BASELINE_SPREAD_PCT / 100U;
+    uint32_t limit = (uint32_t)c->r0 * BASELINE_STEP_PCT / 100U;
+    uint32_t average;
+    int32_t step;
+
+    if (estimate == 0 || estimate + spread < c->r0 || estimate > c->r0 + spread) {
+        c->cleanCount = 0;
+        return;
+    }
+    if (c->cleanCount == 0) {
+        c->cleanStart = now;
+        c->cleanSum = 0;
+        c->cleanMin = estimate;
+        c->cleanMax = estimate;
+    }
+    c->cleanSum += estimate;
+    c->cleanCount++;
+    if (estimate < c->cleanMin) {
+        c->cleanMin = estimate;
+    }
+    if (estimate > c->cleanMax) {
+        c->cleanMax = estimate;
+    }
+    if (now - c->cleanStart < BASELINE_WINDOW_MS) {
+        return;
+    }
+
+    // Fereastră completă: R0 se apropie de medie cu cel mult un pas
+    average = (uint32_t)(c->cleanSum / c->cleanCount);
+    c->cleanCount = 0;
+    if ((uint32_t)(c->cleanMax - c->cleanMin) > spread) {
+        return; // semnal neliniștit: aerul n-a fost curat de fapt
+    }
+    if (limit == 0) {
+        limit = 1;
+    }
+    step = (int32_t)average - c->r0;
+    if (step > (int32_t)limit) {
+        step = (int32_t)limit;
+    } else if (step < -(int32_t)limit) {
+        step = -(int32_t)limit;
+    }
+    c->r0 = Bound((uint32_t)((int32_t)c->r0 + step), c->configured);
+    Save(index, c);
+
+    if ((uint32_t)((c->r0 > c->logged) ? c->r0 - c->logged : c->logged - c->r0) >=
+        (uint32_t)c->logged * BASELINE_LOG_PCT / 100U) {
+        LOG("%s: R0 %u -> %u", Sensors_Channel(index)->name, c->logged, c->r0);
+        EventLog_Append(EVT_BASELINE, c->r0, index);
+        c->logged = c->r0;
+    }
+}
+
+void Baseline_Update(uint8_t index, uint16_t counts, uint16_t factor, uint8_t clean, uint32_t now) {
+    const SensorChannel_t *channel = Sensors_Channel(index);
+    Channel_t *c = &channels[index];
+
+    // R0 nou în configurație (calibrare din $cfg): urmărirea pornește de la el
+    if (*channel->r0 != c->configured) {
+        c->configured = *channel->r0;
+        c->r0 = c->configured;
+        c->logged = c->r0;
+        c->cleanCount = 0;
+        Save(index, c);
+    }
+    if (!c->warm) {
+        Warmup(index, c, counts, now);
+        return;
+    }
+    if (!config.baselineTrack || !clean) {
+        c->cleanCount = 0;
+        return;
+    }
+    Track(index, c, Estimate(channel, counts, factor), now);
+}
+
+uint8_t Baseline_Warm(uint8_t index) {
+    return channels[index].warm;
+}
+
+uint16_t Baseline_R0(uint8_t index) {
+    return channels[index].r0;
+}
+
+void Baseline_GetStatus(uint8_t index, uint32_t now, BaselineStatus_t *out) {
+    const Channel_t *c = &channels[index];
+
+    out->warm = c->warm;
+    out->timedOut = c->timedOut;
+    out->warmupMs = c->warm ? c->warmupMs : (c->started ? now - c->start : 0);
+    out->r0 = c->r0;
+    out->configured = c->configured;
+    out->cleanMs = c->cleanCount ? now - c->cleanStart : 0;
+}
@@ -0,0 +1,192 @@
+#include "main.h"
+#include "buzzer.h"
+
+extern TIM_HandleTypeDef htim6;
+
+HOT_CONST static const BuzzerStep_t beepSteps[] = {
+    { 2700, 80 },
+};
+
+HOT_CONST static const BuzzerStep_t faultSteps[] = {
+    { 1500, 100 }, { 0, 100 }, { 1500, 100 }, { 0, 29700 },
+};
+
+HOT_CONST static const BuzzerStep_t warningSteps[] = {
+    { 2000, 150 }, { 0, 4850 },
+};
+
+// ISO 8201: trei impulsuri de 0.5 s cu pauze de 0.5 s, apoi 1.5 s liniște
+HOT_CONST static const BuzzerStep_t alarmSteps[] = {
+    { 3000, 500 }, { 0, 500 }, { 3000, 500 }, { 0, 500 }, { 3000, 500 }, { 0, 1500 },
+};
+
+#define STEPS(s) (s), (uint8_t)(sizeof(s) / sizeof((s)[0]))
+
+HOT_CONST static const BuzzerPattern_t patterns[BUZZER_PATTERN_COUNT] = {
+    [BUZZER_NONE]    = { NULL, 0, 1 },
+    [BUZZER_BEEP]    = { STEPS(beepSteps),    1 },
+    [BUZZER_FAULT]   = { STEPS(faultSteps),   0 },
+    [BUZZER_WARNING] = { STEPS(warningSteps), 0 },
+    [BUZZER_ALARM]   = { STEPS(alarmSteps),   0 },
+};
+
+static volatile BuzzerPatternId_t current;
+static uint8_t stepIndex;
+static uint8_t repeatsLeft;
+
+// PB2 comută între LPTIM1_OUT (ton) și ieșire GPIO în 0 (liniște)
+HOT_FUNC static void PinTone(uint8_t on) {
+    uint32_t mode = on ? 2U : 1U;
+
+    GPIOB->MODER = (GPIOB->MODER & ~GPIO_MODER_MODE2) | (mode << GPIO_MODER_MODE2_Pos);
+}
+
+// Registrele LPTIM se scriu prin sincronizare în domeniul lui de ceas;
+// următoarea scriere e permisă abia după flag-ul OK (câteva cicluri)
+HOT_FUNC static void LptimWrite(volatile uint32_t *reg, uint32_t value, uint32_t okFlag) {
+    *reg = value;
+    for (uint32_t n = 0; n < 1000U && (LPTIM1->ISR & okFlag) == 0; n++) {
+    }
+    LPTIM1->ICR = okFlag;
+}
+
+HOT_FUNC static void SetTone(uint16_t hz) {
+    uint32_t arr;
+
+    if (hz == 0) {
+        PinTone(0);
+        return;
+    }
+    arr = BUZZER_LPTIM_HZ / hz - 1U;
+    if ((LPTIM1->CR & LPTIM_CR_ENABLE) == 0) {
+        LPTIM1->CR = LPTIM_CR_ENABLE;
+        LptimWrite(&LPTIM1->ARR, arr, LPTIM_ISR_ARROK);
+        LptimWrite(&LPTIM1->CMP, arr / 2U, LPTIM_ISR_CMPOK);
+        LPTIM1->CR = LPTIM_CR_ENABLE | LPTIM_CR_CNTSTRT;
+    } else if (LPTIM1->ARR != arr) {
+        // Cu PRELOAD, noua frecvență intră la sfârșitul perioadei curente
+        LptimWrite(&LPTIM1->ARR, arr, LPTIM_ISR_ARROK);
+        LptimWrite(&LPTIM1->CMP, arr / 2U, LPTIM_ISR_CMPOK);
+    }
+    PinTone(1);
+}
+
+HOT_FUNC static void StartStep(void) {
+    const BuzzerStep_t *step = &patterns[current].steps[stepIndex];
+
+    SetTone(step->toneHz);
+    __HAL_TIM_SET_COUNTER(&htim6, 0);
+    __HAL_TIM_SET_AUTORELOAD(&htim6, (uint32_t)step->durationMs * (BUZZER_TICK_HZ / 1000U) - 1U);
+}
+
+static void Finish(void) {
+    __HAL_TIM_DISABLE(&htim6);
+    PinTone(0);
+    LPTIM1->CR = 0; // LPTIM oprit între modele, nu consumă
+    current = BUZZER_NONE;
+}
+
+void Buzzer_Init(void) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    // LPTIM1 din PCLK1, prescaler 16, PWM cu preîncărcare ARR/CMP
+    __HAL_RCC_LPTIM1_CLK_ENABLE();
+    MODIFY_REG(RCC->CCIPR, RCC_CCIPR_LPTIM1SEL, 0);
+    LPTIM1->CR = 0;
+    LPTIM1->CFGR = (4U << LPTIM_CFGR_PRESC_Pos) | LPTIM_CFGR_PRELOAD;
+
+    // PB2: funcția alternativă rămâne selectată, MODER alege ton/liniște
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    GPIO_InitStruct.Pin = GPIO_PIN_2;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct.Alternate = GPIO_AF1_LPTIM1;
+    HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+    GPIOB->BSRR = GPIO_BSRR_BR2;
+    PinTone(0);
+
+    current = BUZZER_NONE;
+    __HAL_TIM_CLEAR_FLAG(&htim6, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(&htim6, TIM_IT_UPDATE);
+}
+
+HOT_FUNC void Buzzer_Play(BuzzerPatternId_t id) {
+    uint32_t primask;
+
+    if (id == BUZZER_NONE || id >= BUZZER_PATTERN_COUNT) {
+        return;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    // Același model nu se repornește, ca apelurile repetate să nu-l taie
+    if (id > current || (id == current && patterns[id].repeat != 0)) {
+        current = id;
+        stepIndex = 0;
+        repeatsLeft = patterns[id].repeat;
+        StartStep();
+        // O actualizare TIM6 rămasă de la modelul vechi ar sări primul pas
+        __HAL_TIM_CLEAR_FLAG(&htim6, TIM_FLAG_UPDATE);
+        __HAL_TIM_ENABLE(&htim6);
+    }
+    __set_PRIMASK(primask);
+}
+
+void Buzzer_Stop(BuzzerPatternId_t id) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (current == id && id != BUZZER_NONE) {
+        Finish();
+    }
+    __set_PRIMASK(primask);
+}
+
+BuzzerPatternId_t Buzzer_Current(void) {
+    return current;
+}
+
+uint32_t Buzzer_Feedback(uint32_t windowUs) {
+    uint32_t start = DWT->CYCCNT;
+    uint32_t window = windowUs * (SystemCoreClock / 1000000U);
+    uint32_t last = GPIOB->IDR & GPIO_PIN_2;
+    uint32_t edges = 0;
+
+    while (DWT->CYCCNT - start < window) {
+        uint32_t level = GPIOB->IDR & GPIO_PIN_2;
+
+        if (level != last) {
+            edges++;
+            last = level;
+        }
+    }
+    return edges;
+}
+
+// Buzzer_Play poate rula dintr-o întrerupere mai prioritară decât TIM6:
+// pasul se face în secțiune critică, altfel ar continua pe starea veche
+// și ar putea opri modelul tocmai pornit
+void Buzzer_StepElapsed(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (current == BUZZER_NONE) {
+        __HAL_TIM_DISABLE(&htim6);
+    } else if (++stepIndex < patterns[current].count) {
+        StartStep();
+    } else {
+        stepIndex = 0;
+        if (repeatsLeft != 0 && --repeatsLeft == 0) {
+            Finish();
+        } else {
+            StartStep();
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+    if (htim->Instance == TIM6) {
+        Buzzer_StepElapsed();
+    }
+}
@@ -0,0 +1,539 @@
+#include "main.h"
+#include "command.h"
+#include "config.h"
+#include "fan.h"
+#include "buzzer.h"
+#include "safety.h"
+#include "watchdog.h"
+#include "crash_dump.h"
+#include "power.h"
+#include "supply.h"
+#include "diag.h"
+#include "hot_path.h"
+#include "ota.h"
+#include "modbus.h"
+#include "env_sensor.h"
+#include "gas_sensor.h"
+#include "sensors.h"
+#include "baseline.h"
+#include "selftest.h"
+#include "link.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    void (*handler)(int argc, char **argv);
+} Command_t;
+
+static void CmdConfig(int argc, char **argv);
+static void CmdFan(int argc, char **argv);
+static void CmdBuzzer(int argc, char **argv);
+static void CmdSafety(int argc, char **argv);
+static void CmdWatchdog(int argc, char **argv);
+static void CmdCrash(int argc, char **argv);
+static void CmdPower(int argc, char **argv);
+static void CmdSupply(int argc, char **argv);
+static void CmdStats(int argc, char **argv);
+static void CmdBench(int argc, char **argv);
+static void CmdFirmware(int argc, char **argv);
+static void CmdModbus(int argc, char **argv);
+static void CmdEnv(int argc, char **argv);
+static void CmdSensors(int argc, char **argv);
+static void CmdSelfTest(int argc, char **argv);
+
+static const Command_t commands[] = {
+    { "cfg", CmdConfig },
+    { "fan", CmdFan },
+    { "buzzer", CmdBuzzer },
+    { "safety", CmdSafety },
+    { "wdg", CmdWatchdog },
+    { "crash", CmdCrash },
+    { "power", CmdPower },
+    { "supply", CmdSupply },
+    { "stats", CmdStats },
+    { "bench", CmdBench },
+    { "fw", CmdFirmware },
+    { "modbus", CmdModbus },
+    { "env", CmdEnv },
+    { "sensors", CmdSensors },
+    { "selftest", CmdSelfTest },
+};
+
+static int Split(char *line, char **argv) {
+    int argc = 0;
+
+    while (*line != '\0' && argc < (int)COMMAND_MAX_ARGS) {
+        while (*line == ' ') {
+            *line++ = '\0';
+        }
+        if (*line == '\0') {
+            break;
+        }
+        argv[argc++] = line;
+        while (*line != ' ' && *line != '\0') {
+            line++;
+        }
+    }
+    return argc;
+}
+
+static int ParseU32(const char *text, uint32_t *value) {
+    char *end;
+    unsigned long parsed = strtoul(text, &end, 0);
+
+    if (end == text || *end != '\0') {
+        return -1;
+    }
+    *value = (uint32_t)parsed;
+    return 0;
+}
+
+static void PrintConfigKey(uint8_t key) {
+    Link_Print(Config_Name(key));
+    Link_Print("=");
+    Link_PrintU32(Config_Get(key));
+    if (Config_GetStaged(key) != Config_Get(key)) {
+        Link_Print(" (nou: ");
+        Link_PrintU32(Config_GetStaged(key));
+        Link_Print(")");
+    }
+    Link_Print("\r\n");
+}
+
+// cfg list | get <cheie> | set <cheie> <valoare> | commit | revert | defaults
+static void CmdConfig(int argc, char **argv) {
+    int key;
+    uint32_t value;
+
+    if (argc < 2 || strcmp(argv[1], "list") == 0) {
+        for (uint8_t k = 0; k < CFG_KEY_COUNT; k++) {
+            PrintConfigKey(k);
+        }
+    } else if (strcmp(argv[1], "get") == 0 && argc == 3 && (key = Config_Find(argv[2])) >= 0) {
+        PrintConfigKey((uint8_t)key);
+    } else if (strcmp(argv[1], "set") == 0 && argc == 4 && (key = Config_Find(argv[2])) >= 0) {
+        if (ParseU32(argv[3], &value) != 0 || Config_Set((uint8_t)key, value) != 0) {
+            Link_Print("Valoare invalidă.\r\n");
+            return;
+        }
+        PrintConfigKey((uint8_t)key);
+    } else if (strcmp(argv[1], "commit") == 0) {
+        Config_Commit();
+        Link_Print("Configurație aplicată.\r\n");
+    } else if (strcmp(argv[1], "revert") == 0) {
+        Config_Revert();
+        Link_Print("Modificări anulate.\r\n");
+    } else if (strcmp(argv[1], "defaults") == 0) {
+        Config_Defaults();
+        Link_Print("Valori implicite pregătite (cfg commit pentru aplicare).\r\n");
+    } else {
+        Link_Print("Utilizare: cfg list|get|set|commit|revert|defaults\r\n");
+    }
+}
+
+// fan [status] | auto | <0-100>  (valoarea fixă trece ventilatorul în mod manual)
+static void CmdFan(int argc, char **argv) {
+    uint32_t value;
+
+    if (argc >= 2 && strcmp(argv[1], "auto") == 0) {
+        Fan_SetAuto();
+    } else if (argc >= 2 && strcmp(argv[1], "status") != 0) {
+        if (ParseU32(argv[1], &value) != 0 || value > 100) {
+            Link_Print("Utilizare: fan status|auto|<0-100>\r\n");
+            return;
+        }
+        Fan_SetManual((uint8_t)value);
+    }
+    Link_Print((Fan_GetMode() == FAN_MODE_AUTO) ? "mod=auto" : "mod=manual");
+    Link_Print(" duty=");
+    Link_PrintU32(Fan_GetDuty());
+    Link_Print("% rpm=");
+    Link_PrintU32(Fan_GetRpm());
+    Link_Print("\r\n");
+}
+
+// buzzer beep|fault|warning|alarm|stop  (test al modelelor sonore)
+static void CmdBuzzer(int argc, char **argv) {
+    static const char *const names[BUZZER_PATTERN_COUNT] = {
+        [BUZZER_NONE] = "stop",
+        [BUZZER_BEEP] = "beep",
+        [BUZZER_FAULT] = "fault",
+        [BUZZER_WARNING] = "warning",
+        [BUZZER_ALARM] = "alarm",
+    };
+
+    for (uint8_t id = 0; argc == 2 && id < BUZZER_PATTERN_COUNT; id++) {
+        if (strcmp(argv[1], names[id]) == 0) {
+            if (id == BUZZER_NONE) {
+                Buzzer_Stop(Buzzer_Current());
+            } else {
+                Buzzer_Play((BuzzerPatternId_t)id);
+            }
+            return;
+        }
+    }
+    Link_Print("Utilizare: buzzer beep|fault|warning|alarm|stop\r\n");
+}
+
+// safety: declanșări ale căii de siguranță și latența de acționare
+static void CmdSafety(int argc, char **argv) {
+    SafetyStats_t stats;
+    uint32_t cyclesPerUs = SystemCoreClock / 1000000U;
+
+    Safety_GetStats(&stats);
+    Link_Print("declansari=");
+    Link_PrintU32(stats.trips);
+    Link_Print(" ultima=");
+    Link_PrintU32(stats.lastCycles / cyclesPerUs);
+    Link_Print("us max=");
+    Link_PrintU32(stats.maxCycles / cyclesPerUs);
+    Link_Print("us activ=");
+    Link_PrintU32(Safety_Active());
+    Link_Print("\r\n");
+}
+
+// wdg: vârsta ultimei anunțări și termenul fiecărui task supravegheat,
+// plus task-urile care au provocat resetul anterior
+static void CmdWatchdog(int argc, char **argv) {
+    uint32_t lastReset = Watchdog_LastResetMask();
+
+    for (uint8_t i = 0; i < WDG_TASK_COUNT; i++) {
+        Link_Print(Watchdog_TaskName((WatchdogTask_t)i));
+        Link_Print(" varsta=");
+        Link_PrintU32(Watchdog_Age((WatchdogTask_t)i));
+        Link_Print("ms termen=");
+        Link_PrintU32(Watchdog_Deadline((WatchdogTask_t)i));
+        Link_Print((lastReset & (1U << i)) ? "ms (a cauzat resetul anterior)\r\n" : "ms\r\n");
+    }
+}
+
+// crash: rezumatul ultimei căderi și retrimiterea instantaneului binar
+static void CmdCrash(int argc, char **argv) {
+    const CrashDump_t *crash = CrashDump_Get();
+
+    if (crash == NULL) {
+        Link_Print("Nicio cădere înregistrată.\r\n");
+        return;
+    }
+    Link_Print("cauza=");
+    Link_PrintU32(crash->reason);
+    Link_Print(" pc=");
+    Link_PrintU32(crash->pc);
+    Link_Print(" task=");
+    Link_Print(crash->task[0] != '\0' ? crash->task : "-");
+    Link_Print("\r\n");
+    CrashDump_Send();
+}
+
+// power: intrări în Stop 2, rezidența pe moduri, sursele de trezire și
+// consumul estimat din curenții i_*_na; "power reset" începe o fereastră nouă
+static void CmdPower(int argc, char **argv) {
+    static const char *const wakeNames[POWER_WAKE_COUNT] = {
+        [POWER_WAKE_RTC] = " rtc=",
+        [POWER_WAKE_GAS] = " gaz=",
+        [POWER_WAKE_LINK] = " link=",
+        [POWER_WAKE_OTHER] = " altele=",
+    };
+    PowerStats_t stats;
+    EnergyEstimate_t estimate;
+    SupplyReading_t supply;
+
+    if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+        Power_ResetStats();
+        return;
+    }
+    if (argc != 1) {
+        Link_Print("Utilizare: power [reset]\r\n");
+        return;
+    }
+
+    Power_GetStats(&stats);
+    Link_Print(config.lowPower ? "low_power=1" : "low_power=0");
+    Link_Print(stats.lse ? " rtc=LSE" : " rtc=LSI");
+    Link_Print(" stop=");
+    Link_PrintU32(stats.stopCount);
+    Link_Print(" ultimul=");
+    Link_PrintU32(stats.lastStopMs);
+    Link_Print("ms\r\n");
+    for (uint8_t i = 0; i < ENERGY_MODE_COUNT; i++) {
+        Link_Print(Energy_ModeName((EnergyMode_t)i));
+        Link_Print("=");
+        Link_PrintU32((uint32_t)(stats.residency.us[i] / 1000U));
+        Link_Print("ms (");
+        Link_PrintU32(Energy_Permille(&stats.residency, (EnergyMode_t)i));
+        Link_Print(i + 1 < ENERGY_MODE_COUNT ? "‰) " : "‰)\r\n");
+    }
+    Link_Print("treziri:");
+    for (uint8_t i = 0; i < POWER_WAKE_COUNT; i++) {
+        Link_Print(wakeNames[i]);
+        Link_PrintU32(stats.wakeCount[i]);
+    }
+
+    // Energia la VDDA măsurat, dacă există deja o măsurare
+    Supply_Get(&supply);
+    Energy_Estimate(&stats.residency, config.currentNa, config.boardNa,
+                    supply.vddaMv != 0 ? supply.vddaMv : POWER_SUPPLY_MV, &estimate);
+    Link_Print("\r\nmediu=");
+    Link_PrintU32(estimate.avgNa / 1000U);
+    Link_Print("uA ora=");
+    Link_PrintU32(estimate.perHourUah);
+    Link_Print("uAh ");
+    Link_PrintU32(estimate.perHourUwh);
+    Link_Print("uWh\r\n");
+}
+
+// supply: ultima măsurare a alimentării și a temperaturii interne
+static void CmdSupply(int argc, char **argv) {
+    SupplyReading_t supply;
+    int32_t temperature;
+
+    if (Supply_Get(&supply) == 0) {
+        Link_Print("Nicio măsurare încă.\r\n");
+        return;
+    }
+    temperature = supply.temperature;
+    Link_Print("vdda=");
+    Link_PrintU32(supply.vddaMv);
+    Link_Print("mV vbat=");
+    Link_PrintU32(supply.vbatMv);
+    Link_Print(temperature < 0 ? "mV temp=-" : "mV temp=");
+    if (temperature < 0) {
+        temperature = -temperature;
+    }
+    Link_PrintU32((uint32_t)temperature / 10U);
+    Link_Print(".");
+    Link_PrintU32((uint32_t)temperature % 10U);
+    Link_Print("C varsta=");
+    Link_PrintU32(HAL_GetTick() - supply.timestamp);
+    Link_Print(supply.lowBattery ? "ms baterie=descarcata\r\n" : "ms baterie=ok\r\n");
+}
+
+// Rezumatul de stare merge în jurnalul de diagnostic (USART2), nu pe link
+static void CmdStats(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    Diag_DumpStats();
+    Link_Print("OK\r\n");
+}
+
+static void PrintBench(const char *name, const HotBench_t *bench) {
+    Link_Print(name);
+    Link_Print(" flash=");
+    Link_PrintU32(bench->flashCycles / bench->calls);
+    Link_Print(" ram=");
+    Link_PrintU32(bench->ramCycles / bench->calls);
+    Link_Print(" cicluri/apel\r\n");
+}
+
+// bench: nucleele pe eșantion din flash și din SRAM2, apoi ciclurile
+// întreruperilor măsurate (ultima, cea mai lungă)
+static void CmdBench(int argc, char **argv) {
+    HotBench_t ppm;
+    HotBench_t pid;
+
+    (void)argc;
+    (void)argv;
+    HotPath_Bench(&ppm, &pid);
+    Link_Print(RAM_HOT_PATHS ? "ram_hot_paths=1\r\n" : "ram_hot_paths=0\r\n");
+    PrintBench("ppm", &ppm);
+    PrintBench("pid", &pid);
+    for (uint8_t i = 0; i < HOT_ISR_COUNT; i++) {
+        HotIsrStats_t stats;
+
+        HotPath_GetIsrStats((HotIsr_t)i, &stats);
+        Link_Print(HotPath_IsrName((HotIsr_t)i));
+        Link_Print(" n=");
+        Link_PrintU32(stats.count);
+        Link_Print(" ultima=");
+        Link_PrintU32(stats.lastCycles);
+        Link_Print(" max=");
+        Link_PrintU32(stats.maxCycles);
+        Link_Print(" cicluri\r\n");
+    }
+}
+
+static void CmdFirmware(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    Ota_PrintStatus();
+}
+
+static void CmdModbus(int argc, char **argv) {
+    ModbusStats_t stats;
+
+    (void)argc;
+    (void)argv;
+    if (!Modbus_Enabled()) {
+        Link_Print("Modbus dezactivat (cfg modbus_addr, la repornire).\r\n");
+        return;
+    }
+    Modbus_GetStats(&stats);
+    Link_Print("adresa=");
+    Link_PrintU32(config.modbusAddr);
+    Link_Print(" cadre=");
+    Link_PrintU32(stats.frames);
+    Link_Print(" raspunsuri=");
+    Link_PrintU32(stats.replies);
+    Link_Print(" exceptii=");
+    Link_PrintU32(stats.exceptions);
+    Link_Print(" crc=");
+    Link_PrintU32(stats.crcErrors);
+    Link_Print(" linie=");
+    Link_PrintU32(stats.lineErrors);
+    Link_Print("\r\n");
+}
+
+static void CmdEnv(int argc, char **argv) {
+    EnvReading_t env;
+    EnvStats_t stats;
+    int32_t temperature;
+    uint16_t factor = GasSensor_Compensation();
+
+    (void)argc;
+    (void)argv;
+    EnvSensor_GetStats(&stats);
+    if (!EnvSensor_Get(&env)) {
+        Link_Print("Nicio citire recentă (cfg env_ms).");
+    } else {
+        temperature = env.temperature;
+        Link_Print(temperature < 0 ? "temp=-" : "temp=");
+        if (temperature < 0) {
+            temperature = -temperature;
+        }
+        Link_PrintU32((uint32_t)temperature / 10U);
+        Link_Print(".");
+        Link_PrintU32((uint32_t)temperature % 10U);
+        Link_Print("C rh=");
+        Link_PrintU32(env.humidity / 10U);
+        Link_Print(".");
+        Link_PrintU32(env.humidity % 10U);
+        Link_Print("% varsta=");
+        Link_PrintU32(HAL_GetTick() - env.timestamp);
+        Link_Print("ms");
+    }
+    Link_Print(" compensare=");
+    Link_PrintU32(factor / 1000U);
+    Link_Print(".");
+    Link_PrintU32((factor % 1000U) / 100U);
+    Link_PrintU32((factor % 100U) / 10U);
+    Link_PrintU32(factor % 10U);
+    Link_Print(" citiri=");
+    Link_PrintU32(stats.reads);
+    Link_Print(" crc=");
+    Link_PrintU32(stats.crcErrors);
+    Link_Print(" magistrala=");
+    Link_PrintU32(stats.busErrors);
+    Link_Print(" expirate=");
+    Link_PrintU32(stats.timeouts);
+    Link_Print("\r\n");
+}
+
+static void CmdSensors(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    for (uint8_t i = 0; i < Sensors_Count(); i++) {
+        const SensorChannel_t *channel = Sensors_Channel(i);
+        SensorState_t state;
+        BaselineStatus_t baseline;
+
+        Sensors_Get(i, &state);
+        Baseline_GetStatus(i, HAL_GetTick(), &baseline);
+        Link_Print(channel->name);
+        Link_Print(" adc=");
+        Link_PrintU32(channel->adcChannel);
+        Link_Print(" counts=");
+        Link_PrintU32(state.counts);
+        Link_Print(" ppm=");
+        Link_PrintU32(state.ppm);
+        Link_Print(" nivel=");
+        Link_PrintU32(state.level);
+        Link_Print(" praguri=");
+        Link_PrintU32(*channel->warnPpm);
+        Link_Print("/");
+        Link_PrintU32(*channel->alarmPpm);
+        Link_Print(baseline.warm ? (baseline.timedOut ? " incalzit(expirat)=" : " incalzit=") : " incalzire=");
+        Link_PrintU32(baseline.warmupMs / 1000U);
+        Link_Print("s r0=");
+        Link_PrintU32(baseline.r0);
+        Link_Print("/");
+        Link_PrintU32(baseline.configured);
+        Link_Print(" aer_curat=");
+        Link_PrintU32(baseline.cleanMs / 1000U);
+        Link_Print("s\r\n");
+    }
+    Link_Print("scanare=");
+    Link_PrintU32(Sensors_ScanCycles());
+    Link_Print(" cicluri\r\n");
+}
+
+// selftest [run]  (fără argument: ultimul raport)
+static void CmdSelfTest(int argc, char **argv) {
+    static const char *const itemNames[SELFTEST_ITEM_COUNT] = {
+        [SELFTEST_SENSORS] = "senzori", [SELFTEST_BUZZER] = "buzzer",
+        [SELFTEST_FAN] = "ventilator", [SELFTEST_LINK] = "link",
+    };
+    static const char *const resultNames[] = {
+        [SELFTEST_NOT_RUN] = "-", [SELFTEST_PASS] = "ok",
+        [SELFTEST_FAIL] = "EROARE", [SELFTEST_SKIP] = "sarit",
+    };
+    SelfTestReport_t report;
+
+    if (argc >= 2 && strcmp(argv[1], "run") == 0) {
+        Link_Print(SelfTest_Start() == 0 ? "Autotest pornit (raport: $selftest).\r\n" : "Autotest în curs.\r\n");
+        return;
+    }
+    if (argc >= 2) {
+        Link_Print("Utilizare: selftest [run]\r\n");
+        return;
+    }
+    SelfTest_GetReport(&report);
+    if (report.timestamp == 0) {
+        Link_Print(SelfTest_Running() ? "Autotest în curs.\r\n" : "Niciun autotest de la pornire.\r\n");
+        return;
+    }
+    Link_Print("autotest #");
+    Link_PrintU32(report.sequence);
+    Link_Print(report.manual ? " (comanda)" : " (programat)");
+    Link_Print(" varsta=");
+    Link_PrintU32((HAL_GetTick() - report.timestamp) / 1000U);
+    Link_Print("s\r\n");
+    for (uint32_t i = 0; i < SELFTEST_ITEM_COUNT; i++) {
+        Link_Print(itemNames[i]);
+        Link_Print("=");
+        Link_Print(resultNames[report.result[i]]);
+        if (i == SELFTEST_SENSORS && report.badChannels != 0) {
+            Link_Print(" canale=");
+            Link_PrintU32(report.badChannels);
+        } else if (i == SELFTEST_BUZZER && (report.buzzerEdges != 0 || report.result[i] == SELFTEST_FAIL)) {
+            // Fronturile comenzii de pe PB2, nu un răspuns de la buzzer
+            Link_Print(" (doar comanda) fronturi=");
+            Link_PrintU32(report.buzzerEdges);
+        } else if (i == SELFTEST_FAN && report.result[i] != SELFTEST_SKIP) {
+            Link_Print(" rpm=");
+            Link_PrintU32(report.fanRpm);
+        } else if (i == SELFTEST_LINK && report.result[i] == SELFTEST_PASS) {
+            Link_Print(" rtt=");
+            Link_PrintU32(report.linkRttMs);
+            Link_Print("ms");
+        }
+        Link_Print("\r\n");
+    }
+}
+
+void Command_Execute(char *line) {
+    char *argv[COMMAND_MAX_ARGS];
+    int argc = Split(line, argv);
+
+    if (argc == 0) {
+        return;
+    }
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (strcmp(argv[0], commands[i].name) == 0) {
+            commands[i].handler(argc, argv);
+            return;
+        }
+    }
+    Link_Print("Comandă necunoscută.\r\n");
+}
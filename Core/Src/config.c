@@ -0,0 +1,326 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "config.h"
+#include "flash_if.h"
+#include "crc.h"
+#include <stddef.h>
+#include <string.h>
+
+#define PAGE_ADDR(page) (CONFIG_START + (page) * CONFIG_PAGE_SIZE)
+
+typedef struct {
+    const char *name;
+    uint8_t type;
+    uint8_t offset;
+    uint32_t min;
+    uint32_t max;
+    uint32_t def;
+} ConfigField_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t generation;
+    uint32_t count;
+    uint32_t crc;     // CRC-32 peste intrări
+} ConfigHeader_t;
+
+typedef struct {
+    uint16_t key;
+    uint8_t type;
+    uint8_t reserved;
+    uint32_t value;
+} ConfigEntry_t;
+
+// Indexat direct după cheie
+static const ConfigField_t configFields[CFG_KEY_COUNT] = {
+    [CFG_BAUD_RATE]         = { "baud",           CFG_TYPE_U32, offsetof(Config_t, baudRate),                     1200,   921600,    9600 },
+    [CFG_SAMPLE_PERIOD_MS]  = { "sample_ms",      CFG_TYPE_U16, offsetof(Config_t, samplePeriodMs),               10,     10000,     100 },
+    [CFG_HISTORY_PERIOD_MS] = { "history_ms",     CFG_TYPE_U32, offsetof(Config_t, historyPeriodMs),              100,    3600000,   1000 },
+    [CFG_ALARM_DEBOUNCE]    = { "debounce",       CFG_TYPE_U8,  offsetof(Config_t, alarmDebounce),                1,      50,        1 },
+    [CFG_BUZZER_ENABLE]     = { "buzzer",         CFG_TYPE_U8,  offsetof(Config_t, buzzerEnable),                 0,      1,         1 },
+    [CFG_FAN_AUTO]          = { "fan_auto",       CFG_TYPE_U8,  offsetof(Config_t, fanAuto),                      0,      1,         1 },
+    [CFG_STREAM_BATCH]      = { "stream_batch",   CFG_TYPE_U8,  offsetof(Config_t, streamBatch),                  1,      60,        10 },
+    [CFG_WARN_PPM]          = { "warn_ppm",       CFG_TYPE_U16, offsetof(Config_t, warnPpm),                      10,     10000,     300 },
+    [CFG_ALARM_PPM]         = { "alarm_ppm",      CFG_TYPE_U16, offsetof(Config_t, alarmPpm),                     10,     10000,     1000 },
+    [CFG_SENSOR_R0]         = { "sensor_r0",      CFG_TYPE_U16, offsetof(Config_t, sensorR0),                     100,    60000,     2000 },
+    [CFG_FAN_PPM_LO]        = { "fan_ppm_lo",     CFG_TYPE_U16, offsetof(Config_t, fanPpmLo),                     0,      10000,     100 },
+    [CFG_FAN_PPM_HI]        = { "fan_ppm_hi",     CFG_TYPE_U16, offsetof(Config_t, fanPpmHi),                     0,      10000,     1000 },
+    [CFG_FAN_DUTY_LO]       = { "fan_duty_lo",    CFG_TYPE_U8,  offsetof(Config_t, fanDutyLo),                    0,      100,       30 },
+    [CFG_FAN_DUTY_HI]       = { "fan_duty_hi",    CFG_TYPE_U8,  offsetof(Config_t, fanDutyHi),                    0,      100,       100 },
+    [CFG_FAN_DUTY_WARN]     = { "fan_duty_warn",  CFG_TYPE_U8,  offsetof(Config_t, fanDutyWarn),                  0,      100,       50 },
+    [CFG_FAN_DUTY_ALARM]    = { "fan_duty_alarm", CFG_TYPE_U8,  offsetof(Config_t, fanDutyAlarm),                 0,      100,       100 },
+    [CFG_FAN_RAMP]          = { "fan_ramp",       CFG_TYPE_U8,  offsetof(Config_t, fanRamp),                      1,      100,       20 },
+    [CFG_FAN_TARGET_PPM]    = { "fan_target_ppm", CFG_TYPE_U16, offsetof(Config_t, fanTargetPpm),                 0,      10000,     0 },
+    [CFG_FAN_KP]            = { "fan_kp",         CFG_TYPE_U16, offsetof(Config_t, fanKp),                        0,      65535,     2048 },
+    [CFG_FAN_KI]            = { "fan_ki",         CFG_TYPE_U16, offsetof(Config_t, fanKi),                        0,      65535,     20 },
+    [CFG_FAN_KD]            = { "fan_kd",         CFG_TYPE_U16, offsetof(Config_t, fanKd),                        0,      65535,     10240 },
+    [CFG_FAN_TACH]          = { "fan_tach",       CFG_TYPE_U8,  offsetof(Config_t, fanTachPulses),                0,      8,         0 },
+    [CFG_LOW_POWER]         = { "low_power",      CFG_TYPE_U8,  offsetof(Config_t, lowPower),                     0,      1,         0 },
+    [CFG_LINK_LPUART]       = { "link_lpuart",    CFG_TYPE_U8,  offsetof(Config_t, linkLpuart),                   0,      1,         0 },
+    [CFG_I_RUN_NA]          = { "i_run_na",       CFG_TYPE_U32, offsetof(Config_t, currentNa[ENERGY_MODE_RUN]),   0,      100000000, 9400000 },
+    [CFG_I_LPRUN_NA]        = { "i_lprun_na",     CFG_TYPE_U32, offsetof(Config_t, currentNa[ENERGY_MODE_LPRUN]), 0,      100000000, 230000 },
+    [CFG_I_SLEEP_NA]        = { "i_sleep_na",     CFG_TYPE_U32, offsetof(Config_t, currentNa[ENERGY_MODE_SLEEP]), 0,      100000000, 3000000 },
+    [CFG_I_STOP1_NA]        = { "i_stop1_na",     CFG_TYPE_U32, offsetof(Config_t, currentNa[ENERGY_MODE_STOP1]), 0,      100000000, 5000 },
+    [CFG_I_STOP2_NA]        = { "i_stop2_na",     CFG_TYPE_U32, offsetof(Config_t, currentNa[ENERGY_MODE_STOP2]), 0,      100000000, 1600 },
+    [CFG_I_BOARD_NA]        = { "i_board_na",     CFG_TYPE_U32, offsetof(Config_t, boardNa),                      0,      100000000, 0 },
+    [CFG_SUPPLY_PERIOD_MS]  = { "supply_ms",      CFG_TYPE_U32, offsetof(Config_t, supplyPeriodMs),               1000,   3600000,   10000 },
+    [CFG_BATT_LOW_MV]       = { "batt_low_mv",    CFG_TYPE_U16, offsetof(Config_t, battLowMv),                    0,      3600,      2400 },
+    [CFG_BATT_SAMPLE_MS]    = { "batt_sample_ms", CFG_TYPE_U16, offsetof(Config_t, battSamplePeriodMs),           10,     10000,     1000 },
+    [CFG_LOG_BINARY]        = { "log_binary",     CFG_TYPE_U8,  offsetof(Config_t, logBinary),                    0,      1,         0 },
+    [CFG_DIAG_BAUD]         = { "diag_baud",      CFG_TYPE_U32, offsetof(Config_t, diagBaud),                     115200, 4000000,   921600 },
+    [CFG_DIAG_STATS_MS]     = { "diag_stats_ms",  CFG_TYPE_U32, offsetof(Config_t, diagStatsMs),                  0,      3600000,   0 },
+    [CFG_MODBUS_ADDR]       = { "modbus_addr",    CFG_TYPE_U8,  offsetof(Config_t, modbusAddr),                   0,      247,       0 },
+    [CFG_MODBUS_BAUD]       = { "modbus_baud",    CFG_TYPE_U32, offsetof(Config_t, modbusBaud),                   1200,   115200,    19200 },
+    [CFG_MODBUS_PARITY]     = { "modbus_parity",  CFG_TYPE_U8,  offsetof(Config_t, modbusParity),                 0,      2,         1 },
+    [CFG_ENV_PERIOD_MS]     = { "env_ms",         CFG_TYPE_U32, offsetof(Config_t, envPeriodMs),                  0,      600000,    2000 },
+    [CFG_ENV_COMP]          = { "env_comp",       CFG_TYPE_U8,  offsetof(Config_t, envComp),                      0,      1,         1 },
+    [CFG_WARMUP_MAX_S]      = { "warmup_s",       CFG_TYPE_U16, offsetof(Config_t, warmupMaxS),                   0,      3600,      900 },
+    [CFG_BASELINE_TRACK]    = { "baseline",       CFG_TYPE_U8,  offsetof(Config_t, baselineTrack),                0,      1,         1 },
+    [CFG_SELFTEST_H]        = { "selftest_h",     CFG_TYPE_U16, offsetof(Config_t, selftestHours),                0,      720,       24 },
+};
+
+extern osThreadId_t storageTaskHandle;
+
+Config_t config;
+static Config_t staged;
+static osMutexId_t configMutex; // copia de lucru; NULL înainte de Config_Init
+static uint32_t activePage;
+static uint32_t generation;
+
+static uint32_t ReadField(const Config_t *cfg, uint8_t key) {
+    const uint8_t *field = (const uint8_t *)cfg + configFields[key].offset;
+
+    switch (configFields[key].type) {
+    case CFG_TYPE_U8:  return *field;
+    case CFG_TYPE_U16: return *(const uint16_t *)field;
+    default:           return *(const uint32_t *)field;
+    }
+}
+
+static void WriteField(Config_t *cfg, uint8_t key, uint32_t value) {
+    uint8_t *field = (uint8_t *)cfg + configFields[key].offset;
+
+    switch (configFields[key].type) {
+    case CFG_TYPE_U8:  *field = (uint8_t)value; break;
+    case CFG_TYPE_U16: *(uint16_t *)field = (uint16_t)value; break;
+    default:           *(uint32_t *)field = value; break;
+    }
+}
+
+static int InRange(uint8_t key, uint32_t value) {
+    return value >= configFields[key].min && value <= configFields[key].max;
+}
+
+static int PageValid(uint32_t page, ConfigHeader_t *header) {
+    uint32_t crc = 0;
+    ConfigEntry_t entry;
+    uint32_t maxEntries = (CONFIG_PAGE_SIZE - sizeof(ConfigHeader_t)) / sizeof(ConfigEntry_t);
+
+    if (FlashIf_Read(PAGE_ADDR(page), header, sizeof(*header)) != 0 ||
+        header->magic != CONFIG_MAGIC || header->count > maxEntries) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < header->count; i++) {
+        if (FlashIf_Read(PAGE_ADDR(page) + sizeof(ConfigHeader_t) + i * sizeof(entry),
+                         &entry, sizeof(entry)) != 0) {
+            return 0;
+        }
+        crc = Crc32_Update(crc, (const uint8_t *)&entry, sizeof(entry));
+    }
+    return crc == header->crc;
+}
+
+void Config_Load(void) {
+    ConfigHeader_t header[2];
+    int valid[2];
+    int page;
+
+    for (uint8_t key = 0; key < CFG_KEY_COUNT; key++) {
+        WriteField(&config, key, configFields[key].def);
+    }
+
+    valid[0] = PageValid(0, &header[0]);
+    valid[1] = PageValid(1, &header[1]);
+    if (valid[0] && valid[1]) {
+        page = ((int32_t)(header[1].generation - header[0].generation) > 0) ? 1 : 0;
+    } else if (valid[0] || valid[1]) {
+        page = valid[1] ? 1 : 0;
+    } else {
+        // Nicio pagină validă: rămân valorile implicite, prima salvare merge în A
+        activePage = 1;
+        generation = 0;
+        staged = config;
+        return;
+    }
+
+    activePage = (uint32_t)page;
+    generation = header[page].generation;
+    for (uint32_t i = 0; i < header[page].count; i++) {
+        ConfigEntry_t entry;
+        FlashIf_Read(PAGE_ADDR(page) + sizeof(ConfigHeader_t) + i * sizeof(entry),
+                     &entry, sizeof(entry));
+        // Cheile necunoscute (firmware mai nou) sau cu alt tip sunt ignorate
+        if (entry.key < CFG_KEY_COUNT && entry.type == configFields[entry.key].type &&
+            InRange((uint8_t)entry.key, entry.value)) {
+            WriteField(&config, (uint8_t)entry.key, entry.value);
+        }
+    }
+    staged = config;
+}
+
+int Config_Find(const char *name) {
+    for (uint8_t key = 0; key < CFG_KEY_COUNT; key++) {
+        if (strcmp(configFields[key].name, name) == 0) {
+            return key;
+        }
+    }
+    return -1;
+}
+
+const char *Config_Name(uint8_t key) {
+    return (key < CFG_KEY_COUNT) ? configFields[key].name : "?";
+}
+
+uint32_t Config_Get(uint8_t key) {
+    return ReadField(&config, key);
+}
+
+static void Lock(void) {
+    if (configMutex != NULL) {
+        osMutexAcquire(configMutex, osWaitForever);
+    }
+}
+
+static void Unlock(void) {
+    if (configMutex != NULL) {
+        osMutexRelease(configMutex);
+    }
+}
+
+void Config_Init(void) {
+    configMutex = osMutexNew(NULL);
+}
+
+uint32_t Config_GetStaged(uint8_t key) {
+    uint32_t value;
+
+    Lock();
+    value = ReadField(&staged, key);
+    Unlock();
+    return value;
+}
+
+int Config_Set(uint8_t key, uint32_t value) {
+    if (key >= CFG_KEY_COUNT || !InRange(key, value)) {
+        return -1;
+    }
+    Lock();
+    WriteField(&staged, key, value);
+    Unlock();
+    return 0;
+}
+
+static void RequestSave(void) {
+    if (storageTaskHandle != NULL) {
+        osThreadFlagsSet(storageTaskHandle, STORAGE_FLAG_CONFIG);
+    }
+}
+
+int Config_Apply(uint8_t first, uint8_t count, const uint32_t *values) {
+    uint8_t changed = 0;
+    int32_t lock;
+
+    if (count == 0 || first >= CFG_KEY_COUNT || count > CFG_KEY_COUNT - first) {
+        return -1;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (!InRange((uint8_t)(first + i), values[i])) {
+            return -1;
+        }
+    }
+
+    Lock();
+    for (uint8_t i = 0; i < count; i++) {
+        changed |= (ReadField(&config, (uint8_t)(first + i)) != values[i]);
+    }
+    if (!changed) {
+        Unlock();
+        return 0;
+    }
+    lock = osKernelLock();
+    for (uint8_t i = 0; i < count; i++) {
+        WriteField(&config, (uint8_t)(first + i), values[i]);
+    }
+    osKernelRestoreLock(lock);
+    // Un $cfg commit ulterior nu trebuie să readucă valorile vechi
+    for (uint8_t i = 0; i < count; i++) {
+        WriteField(&staged, (uint8_t)(first + i), values[i]);
+    }
+    Unlock();
+    RequestSave();
+    return 0;
+}
+
+void Config_Commit(void) {
+    int32_t lock;
+
+    Lock();
+    lock = osKernelLock();
+    config = staged;
+    osKernelRestoreLock(lock);
+    Unlock();
+    RequestSave();
+}
+
+void Config_Revert(void) {
+    Lock();
+    staged = config;
+    Unlock();
+}
+
+void Config_Defaults(void) {
+    Lock();
+    for (uint8_t key = 0; key < CFG_KEY_COUNT; key++) {
+        WriteField(&staged, key, configFields[key].def);
+    }
+    Unlock();
+}
+
+int Config_Save(void) {
+    ConfigHeader_t header;
+    ConfigEntry_t entries[CFG_KEY_COUNT];
+    uint32_t target = activePage ^ 1U;
+    Config_t snapshot;
+    int32_t lock;
+    int status = 0;
+
+    lock = osKernelLock();
+    snapshot = config;
+    osKernelRestoreLock(lock);
+
+    for (uint8_t key = 0; key < CFG_KEY_COUNT; key++) {
+        entries[key].key = key;
+        entries[key].type = configFields[key].type;
+        entries[key].reserved = 0xFF;
+        entries[key].value = ReadField(&snapshot, key);
+    }
+    header.magic = CONFIG_MAGIC;
+    header.generation = generation + 1U;
+    header.count = CFG_KEY_COUNT;
+    header.crc = Crc32((const uint8_t *)entries, sizeof(entries));
+
+    // Intrările întâi, antetul la final: pagina devine validă abia la ultimul double-word
+    FlashIf_Begin();
+    if (FlashIf_ErasePage(PAGE_ADDR(target)) != HAL_OK ||
+        FlashIf_Program(PAGE_ADDR(target) + sizeof(header), entries, sizeof(entries)) != HAL_OK ||
+        FlashIf_Program(PAGE_ADDR(target), &header, sizeof(header)) != HAL_OK) {
+        status = -1;
+    }
+    FlashIf_End();
+
+    if (status == 0) {
+        activePage = target;
+        generation = header.generation;
+    }
+    return status;
+}
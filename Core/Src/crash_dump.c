@@ -0,0 +1,165 @@
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "crash_dump.h"
+#include "crc.h"
+#include "event_log.h"
+#include "link.h"
+#include "stack_guard.h"
+#include <string.h>
+
+#define CRASH_REPORTED 0x52505254U // "TRPR"
+
+// SRAM2, neinițializată de startup: supraviețuiește resetului software
+__attribute__((section(".crash_dump"))) static CrashDump_t dump;
+__attribute__((section(".crash_dump"))) static uint32_t reported;
+// Stivă proprie pentru handler: MSP poate fi chiar cauza căderii
+__attribute__((section(".crash_dump"), used)) uint32_t crashStack[128];
+
+static uint8_t valid;
+static uint8_t frame[LINK_FRAME_MAX_PAYLOAD];
+
+static uint8_t InRam(uint32_t address, uint32_t size) {
+    return (address >= SRAM1_BASE && address + size <= SRAM1_BASE + SRAM1_SIZE_MAX) ||
+           (address >= SRAM2_BASE && address + size <= SRAM2_BASE + SRAM2_SIZE);
+}
+
+// Intrarea comună a handlerelor de defect: alege stiva pe care procesorul
+// a salvat cadrul (MSP/PSP după EXC_RETURN), trece pe stiva proprie și
+// continuă în C. Fără prolog generat de compilator, deci SP și LR sunt
+// exact cele de la intrarea în excepție.
+__attribute__((naked)) void CrashDump_FaultEntry(void) {
+    __asm volatile(
+        "tst   lr, #4              \n"
+        "ite   eq                  \n"
+        "mrseq r0, msp             \n"
+        "mrsne r0, psp             \n"
+        "mov   r1, lr              \n"
+        "ldr   r2, =crashStack+512 \n"
+        "mov   sp, r2              \n"
+        "b     CrashDump_Capture   \n");
+}
+
+void HardFault_Handler(void) __attribute__((alias("CrashDump_FaultEntry")));
+void MemManage_Handler(void) __attribute__((alias("CrashDump_FaultEntry")));
+void BusFault_Handler(void) __attribute__((alias("CrashDump_FaultEntry")));
+void UsageFault_Handler(void) __attribute__((alias("CrashDump_FaultEntry")));
+
+static void __attribute__((noreturn)) Save(uint32_t reason, uint32_t *frame, uint32_t excReturn) {
+    uint32_t sp = (uint32_t)frame;
+    uint32_t words = 0;
+
+    memset(&dump, 0, sizeof(dump));
+    dump.magic = CRASH_DUMP_MAGIC;
+    dump.length = sizeof(dump);
+    dump.reason = reason;
+    dump.excReturn = excReturn;
+    dump.cfsr = SCB->CFSR;
+    dump.hfsr = SCB->HFSR;
+    dump.mmfar = SCB->MMFAR;
+    dump.bfar = SCB->BFAR;
+    dump.uptimeMs = HAL_GetTick();
+
+    // O depășire prinsă de gardă e raportată ca atare; apoi fără MPU,
+    // altfel citirea cadrului de sub gardă ar produce un nou defect
+    if (reason == CRASH_MEMMANAGE && StackGuard_Hit(dump.cfsr, dump.mmfar)) {
+        dump.reason = CRASH_STACK_OVERFLOW;
+    }
+    StackGuard_Disable();
+
+    // Un SP corupt ar provoca o nouă cădere la citire: doar din RAM
+    if (InRam(sp, 32U)) {
+        dump.r0 = frame[0];
+        dump.r1 = frame[1];
+        dump.r2 = frame[2];
+        dump.r3 = frame[3];
+        dump.r12 = frame[4];
+        dump.lr = frame[5];
+        dump.pc = frame[6];
+        dump.xpsr = frame[7];
+        // Cadru extins cu registrele FPU (bit 4 = 0) și aliniere la 8 (xPSR bit 9)
+        sp += ((excReturn & 0x10U) == 0) ? 0x68U : 0x20U;
+        if (dump.xpsr & (1U << 9)) {
+            sp += 4U;
+        }
+        while (words < CRASH_DUMP_STACK_WORDS && InRam(sp + words * 4U, 4U)) {
+            dump.stack[words] = ((uint32_t *)sp)[words];
+            words++;
+        }
+    }
+    dump.sp = sp;
+
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED && xTaskGetCurrentTaskHandle() != NULL) {
+        strncpy(dump.task, pcTaskGetName(NULL), CRASH_DUMP_TASK_LEN - 1U);
+    }
+
+    dump.crc = Crc32((const uint8_t *)&dump, offsetof(CrashDump_t, crc));
+    reported = 0;
+    __DSB();
+    NVIC_SystemReset();
+}
+
+void CrashDump_Capture(uint32_t *frame, uint32_t excReturn) {
+    Save(__get_IPSR() & 0x1FFU, frame, excReturn);
+}
+
+void CrashDump_CaptureTask(uint32_t reason) {
+    // Primul câmp din TCB e pxTopOfStack (îl folosește și portul). PendSV a
+    // salvat acolo r4-r11 și EXC_RETURN, eventual s16-s31, apoi urmează
+    // cadrul salvat de procesor la întreruperea task-ului.
+    uint32_t *top = *(uint32_t **)xTaskGetCurrentTaskHandle();
+    uint32_t excReturn = 0;
+    uint32_t *frame = NULL;
+
+    __disable_irq();
+    StackGuard_Disable();
+    if (InRam((uint32_t)top, 9U * 4U)) {
+        excReturn = top[8];
+        frame = top + 9U + (((excReturn & 0x10U) == 0) ? 16U : 0U);
+    }
+    Save(reason, frame, excReturn);
+}
+
+void CrashDump_Init(void) {
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk;
+    SCB->CCR |= SCB_CCR_DIV_0_TRP_Msk;
+
+    valid = dump.magic == CRASH_DUMP_MAGIC && dump.length == sizeof(dump) &&
+            dump.crc == Crc32((const uint8_t *)&dump, offsetof(CrashDump_t, crc));
+    if (!valid) {
+        reported = CRASH_REPORTED;
+    } else if (reported == 0) {
+        // Prima pornire după cădere: rămâne și în jurnalul din flash
+        EventLog_Append(EVT_CRASH, (uint16_t)dump.reason, (uint16_t)dump.cfsr);
+        reported = 1;
+    }
+}
+
+const CrashDump_t *CrashDump_Get(void) {
+    return valid ? &dump : NULL;
+}
+
+uint8_t CrashDump_Pending(void) {
+    return valid && reported != CRASH_REPORTED;
+}
+
+void CrashDump_MarkReported(void) {
+    reported = CRASH_REPORTED;
+}
+
+void CrashDump_Send(void) {
+    const uint8_t *bytes = (const uint8_t *)&dump;
+
+    for (uint16_t offset = 0; valid && offset < sizeof(dump);) {
+        uint16_t chunk = sizeof(dump) - offset;
+
+        if (chunk > sizeof(frame) - 2U) {
+            chunk = sizeof(frame) - 2U;
+        }
+        frame[0] = (uint8_t)offset;
+        frame[1] = (uint8_t)(offset >> 8);
+        memcpy(&frame[2], &bytes[offset], chunk);
+        Link_SendFrame(LINK_FRAME_CRASH, frame, (uint16_t)(chunk + 2U));
+        offset += chunk;
+    }
+}
@@ -0,0 +1,58 @@
+#include "crc.h"
+
+// Tabel pe nibble: 16 intrări în loc de 256, suficient de rapid pentru 9600 baud
+static const uint16_t crc16Table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t Crc16_Update(uint16_t crc, const uint8_t *data, size_t len) {
+    while (len--) {
+        uint8_t byte = *data++;
+        crc = (uint16_t)((crc << 4) ^ crc16Table[(crc >> 12) ^ (byte >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc16Table[(crc >> 12) ^ (byte & 0x0F)]);
+    }
+    return crc;
+}
+
+uint16_t Crc16(const uint8_t *data, size_t len) {
+    return Crc16_Update(0xFFFF, data, len);
+}
+
+static const uint16_t crc16ModbusTable[16] = {
+    0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+    0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400
+};
+
+uint16_t Crc16_Modbus(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc ^= *data++;
+        crc = (uint16_t)((crc >> 4) ^ crc16ModbusTable[crc & 0x0F]);
+        crc = (uint16_t)((crc >> 4) ^ crc16ModbusTable[crc & 0x0F]);
+    }
+    return crc;
+}
+
+static const uint32_t crc32Table[16] = {
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+};
+
+// crc este valoarea returnată de apelul anterior (0 la început)
+uint32_t Crc32_Update(uint32_t crc, const uint8_t *data, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crc32Table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32Table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+uint32_t Crc32(const uint8_t *data, size_t len) {
+    return Crc32_Update(0, data, len);
+}
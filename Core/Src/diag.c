@@ -0,0 +1,123 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "FreeRTOS.h"
+#include "diag.h"
+#include "logger.h"
+#include "command.h"
+#include "config.h"
+#include "power.h"
+#include "supply.h"
+#include "safety.h"
+#include "stack_guard.h"
+#include <string.h>
+
+extern UART_HandleTypeDef huart2;
+extern osThreadId_t diagTaskHandle;
+extern osThreadId_t gasMonitorTaskHandle;
+extern osThreadId_t bluetoothTaskHandle;
+extern osThreadId_t storageTaskHandle;
+extern osThreadId_t watchdogTaskHandle;
+extern osThreadId_t modbusTaskHandle;
+
+// Numele sunt constante în flash, ca logdecode să le poată citi din ELF
+typedef struct {
+    const char *name;
+    osThreadId_t *handle;
+} DiagTask_t;
+
+static const DiagTask_t tasks[] = {
+    { "gas", &gasMonitorTaskHandle },
+    { "bluetooth", &bluetoothTaskHandle },
+    { "storage", &storageTaskHandle },
+    { "watchdog", &watchdogTaskHandle },
+    { "diag", &diagTaskHandle },
+    { "modbus", &modbusTaskHandle },
+};
+
+static uint8_t rxByte;
+static char rxLine[COMMAND_MAX_LINE];
+static uint32_t rxLength;
+static char line[COMMAND_MAX_LINE];
+static volatile uint8_t linePending;
+
+void Diag_Init(void) {
+    HAL_UART_Receive_IT(&huart2, &rxByte, 1);
+}
+
+// Octet cu octet, din întrerupere; linia trece la DiagTask doar dacă cea
+// anterioară a fost executată (altfel se pierde)
+HOT_FUNC void Diag_RxCallback(void) {
+    if (rxByte == '\r' || rxByte == '\n') {
+        if (rxLength != 0 && !linePending) {
+            memcpy(line, rxLine, rxLength);
+            line[rxLength] = '\0';
+            linePending = 1;
+            if (diagTaskHandle != NULL) {
+                osThreadFlagsSet(diagTaskHandle, DIAG_FLAG_LINE);
+            }
+        }
+        rxLength = 0;
+    } else if (rxLength < sizeof(rxLine) - 1U) {
+        rxLine[rxLength++] = (char)rxByte;
+    }
+    HAL_UART_Receive_IT(&huart2, &rxByte, 1);
+}
+
+// Zgomot sau depășire (ORE): HAL oprește recepția, care se rearmează
+HOT_FUNC void Diag_ErrorCallback(void) {
+    rxLength = 0;
+    HAL_UART_Receive_IT(&huart2, &rxByte, 1);
+}
+
+void Diag_DumpStats(void) {
+    LoggerStats_t log;
+    PowerStats_t power;
+    SupplyReading_t supply;
+    SafetyStats_t safety;
+
+    LOG("stats: heap liber=%u minim=%u", xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize());
+    for (uint32_t i = 0; i < sizeof(tasks) / sizeof(tasks[0]); i++) {
+        if (*tasks[i].handle != NULL) {
+            LOG("stats: stiva %s libera=%u octeti", tasks[i].name, StackGuard_StackSpace(*tasks[i].handle));
+        }
+    }
+    Logger_GetStats(&log);
+    LOG("stats: log golite=%u pierdute=%u ocupare max=%u/%u", log.written, log.dropped, log.highWater,
+        LOG_RING_WORDS);
+    Power_GetStats(&power);
+    LOG("stats: power stop=%u run=%ums sleep=%ums stop2=%ums", power.stopCount,
+        (uint32_t)(power.residency.us[ENERGY_MODE_RUN] / 1000U),
+        (uint32_t)(power.residency.us[ENERGY_MODE_SLEEP] / 1000U),
+        (uint32_t)(power.residency.us[ENERGY_MODE_STOP2] / 1000U));
+    if (Supply_Get(&supply) != 0) {
+        LOG("stats: vdda=%umV vbat=%umV temp=%d (0.1C)", supply.vddaMv, supply.vbatMv, supply.temperature);
+    }
+    Safety_GetStats(&safety);
+    LOG("stats: safety declansari=%u max=%u cicluri", safety.trips, safety.maxCycles);
+}
+
+// Golește jurnalul la LOG_DRAIN_MS, sau imediat după o comandă
+void StartDiagTask(void *argument) {
+    uint32_t lastStats = osKernelGetTickCount();
+
+    Diag_Init();
+    for (;;) {
+        uint32_t flags = osThreadFlagsWait(DIAG_FLAG_LINE, osFlagsWaitAny, LOG_DRAIN_MS);
+        uint32_t now = osKernelGetTickCount();
+
+        if ((flags & osFlagsError) == 0 && (flags & DIAG_FLAG_LINE) && linePending) {
+            // Ecoul și răspunsurile comenzii (Link_Print) ajung în jurnal, pe
+            // USART2; linia e în RAM, deci se copiază ca text, nu prin %s
+            Logger_WriteText("> ", 2);
+            Logger_WriteText(line, strlen(line));
+            Logger_WriteText("\r\n", 2);
+            Command_Execute(line[0] == COMMAND_PREFIX ? &line[1] : line);
+            linePending = 0;
+        }
+        if (config.diagStatsMs != 0 && now - lastStats >= config.diagStatsMs) {
+            lastStats = now;
+            Diag_DumpStats();
+        }
+        Logger_Drain();
+    }
+}
@@ -0,0 +1,56 @@
+#include "energy.h"
+
+static const char *const modeNames[ENERGY_MODE_COUNT] = {
+    [ENERGY_MODE_RUN] = "run",
+    [ENERGY_MODE_LPRUN] = "lprun",
+    [ENERGY_MODE_SLEEP] = "sleep",
+    [ENERGY_MODE_STOP1] = "stop1",
+    [ENERGY_MODE_STOP2] = "stop2",
+};
+
+uint64_t Energy_Total(const EnergyResidency_t *residency) {
+    uint64_t total = 0;
+
+    for (int i = 0; i < ENERGY_MODE_COUNT; i++) {
+        total += residency->us[i];
+    }
+    return total;
+}
+
+uint16_t Energy_Permille(const EnergyResidency_t *residency, EnergyMode_t mode) {
+    uint64_t total = Energy_Total(residency);
+
+    if (total == 0) {
+        return 0;
+    }
+    return (uint16_t)((residency->us[mode] * 1000U + total / 2U) / total);
+}
+
+void Energy_Estimate(const EnergyResidency_t *residency, const uint32_t currentNa[ENERGY_MODE_COUNT],
+                     uint32_t baseNa, uint32_t supplyMv, EnergyEstimate_t *out) {
+    uint64_t total = Energy_Total(residency);
+    uint64_t charge = 0;
+    uint64_t avgNa = baseNa;
+    int shift = 0;
+
+    // Timpii se scalează sub 2^32 (~71 de minute în us), ca produsul cu
+    // un curent pe 32 de biți să încapă în 64 de biți; contează doar raportul
+    while ((total >> shift) > UINT32_MAX) {
+        shift++;
+    }
+    for (int i = 0; i < ENERGY_MODE_COUNT; i++) {
+        charge += (uint64_t)currentNa[i] * (residency->us[i] >> shift);
+    }
+    if (total != 0) {
+        avgNa += charge / (total >> shift);
+    }
+
+    // Media pe fereastra măsurată, extrapolată la o oră
+    out->avgNa = (avgNa > UINT32_MAX) ? UINT32_MAX : (uint32_t)avgNa;
+    out->perHourUah = (uint32_t)((avgNa + 500U) / 1000U);
+    out->perHourUwh = (uint32_t)((avgNa * supplyMv + 500000U) / 1000000U);
+}
+
+const char *Energy_ModeName(EnergyMode_t mode) {
+    return modeNames[mode];
+}
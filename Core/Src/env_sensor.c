@@ -0,0 +1,144 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "env_sensor.h"
+#include "config.h"
+
+#define ENV_MIN_PERIOD_MS (2U * ENV_CONVERSION_MS)
+
+extern I2C_HandleTypeDef hi2c1;
+
+static osTimerId_t envTimer;
+static uint8_t readStep;            // următorul pas al timerului: 0 = comandă, 1 = citire
+static volatile uint8_t busy;       // transfer pornit, încă neterminat
+static volatile uint8_t commandOk;  // comanda de măsurare a fost confirmată (ACK)
+static uint8_t command[2] = { (uint8_t)(ENV_CMD_MEASURE >> 8), (uint8_t)ENV_CMD_MEASURE };
+static uint8_t result[6];           // T msb, lsb, crc, RH msb, lsb, crc
+static EnvReading_t reading;
+static EnvStats_t stats;
+
+// CRC-8 din foaia de catalog SHT3x: poli 0x31, init 0xFF, peste fiecare cuvânt
+static uint8_t Crc8(const uint8_t *data) {
+    uint8_t crc = 0xFF;
+
+    for (uint32_t i = 0; i < 2U; i++) {
+        crc ^= data[i];
+        for (uint32_t bit = 0; bit < 8U; bit++) {
+            crc = (crc & 0x80U) ? (uint8_t)((crc << 1) ^ 0x31U) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t Period(void) {
+    return (config.envPeriodMs < ENV_MIN_PERIOD_MS) ? ENV_MIN_PERIOD_MS : config.envPeriodMs;
+}
+
+// Rulează în task-ul de timere: doar pornește transferurile, fără să aștepte
+static void EnvTimerCallback(void *argument) {
+    (void)argument;
+
+    if (busy) {
+        // Transfer agățat (SDA ținut de senzor, zgomot): perifericul se
+        // reinițializează și pasul curent se sare
+        stats.timeouts++;
+        HAL_I2C_DeInit(&hi2c1);
+        HAL_I2C_Init(&hi2c1);
+        busy = 0;
+        commandOk = 0;
+    }
+    if (config.envPeriodMs == 0) {
+        return; // oprit din configurație; repornește la reset
+    }
+
+    if (readStep) {
+        readStep = 0;
+        if (commandOk) {
+            busy = 1;
+            if (HAL_I2C_Master_Receive_DMA(&hi2c1, ENV_I2C_ADDRESS << 1, result, sizeof(result)) != HAL_OK) {
+                busy = 0;
+                stats.busErrors++;
+            }
+        }
+        osTimerStart(envTimer, Period() - ENV_CONVERSION_MS);
+    } else {
+        readStep = 1;
+        commandOk = 0;
+        busy = 1;
+        if (HAL_I2C_Master_Transmit_IT(&hi2c1, ENV_I2C_ADDRESS << 1, command, sizeof(command)) != HAL_OK) {
+            busy = 0;
+            stats.busErrors++;
+        }
+        osTimerStart(envTimer, ENV_CONVERSION_MS);
+    }
+}
+
+void EnvSensor_Init(void) {
+    const osTimerAttr_t envTimerAttr = {
+        .name = "EnvSensor"
+    };
+
+    if (config.envPeriodMs == 0) {
+        return;
+    }
+    envTimer = osTimerNew(EnvTimerCallback, osTimerOnce, NULL, &envTimerAttr);
+    osTimerStart(envTimer, Period());
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c == &hi2c1) {
+        commandOk = 1;
+        busy = 0;
+    }
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    uint16_t rawTemperature = (uint16_t)((result[0] << 8) | result[1]);
+    uint16_t rawHumidity = (uint16_t)((result[3] << 8) | result[4]);
+
+    if (hi2c != &hi2c1) {
+        return;
+    }
+    busy = 0;
+    if (Crc8(&result[0]) != result[2] || Crc8(&result[3]) != result[5]) {
+        stats.crcErrors++;
+        return;
+    }
+    // T = -45 + 175 * raw / 65535 [°C], RH = 100 * raw / 65535 [%]
+    reading.temperature = (int16_t)((int32_t)(1750UL * rawTemperature / 65535UL) - 450);
+    reading.humidity = (uint16_t)(1000UL * rawHumidity / 65535UL);
+    reading.timestamp = HAL_GetTick();
+    if (reading.timestamp == 0) {
+        reading.timestamp = 1; // 0 înseamnă „fără citire”
+    }
+    stats.reads++;
+}
+
+// NACK (senzor absent sau încă ocupat), pierderea arbitrajului, eroare de
+// magistrală: HAL a eliberat deja magistrala, pasul următor reîncearcă
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c == &hi2c1) {
+        stats.busErrors++;
+        busy = 0;
+    }
+}
+
+uint8_t EnvSensor_Get(EnvReading_t *out) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *out = reading;
+    __set_PRIMASK(primask);
+    return out->timestamp != 0 && HAL_GetTick() - out->timestamp <= ENV_MAX_AGE(Period());
+}
+
+uint8_t EnvSensor_Busy(void) {
+    return busy;
+}
+
+void EnvSensor_GetStats(EnvStats_t *out) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *out = stats;
+    __set_PRIMASK(primask);
+}
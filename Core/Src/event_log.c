@@ -0,0 +1,230 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "event_log.h"
+#include "flash_if.h"
+#include "crc.h"
+
+#define PAGE_ADDR(page)       (EVENT_LOG_START + (page) * EVENT_LOG_PAGE_SIZE)
+#define SLOT_ADDR(page, slot) (PAGE_ADDR(page) + ((slot) + 1U) * EVENT_LOG_RECORD_SIZE)
+
+extern osThreadId_t storageTaskHandle;
+
+// Coada din RAM: producători multipli (task-uri, ISR), un singur consumator (Flush)
+static EventRecord_t pending[EVENT_LOG_PENDING];
+static volatile uint32_t pendingHead;
+static volatile uint32_t pendingTail;
+static volatile uint16_t droppedCount;
+
+static osMutexId_t eventLogMutex;
+static uint32_t activePage;
+static uint32_t nextSlot;
+static uint32_t nextSequence;
+
+static int ReadFlash(uint32_t address, void *out) {
+    return FlashIf_Read(address, out, EVENT_LOG_RECORD_SIZE);
+}
+
+static int IsErased(const void *data) {
+    const uint32_t *words = data;
+    return (words[0] & words[1] & words[2] & words[3]) == 0xFFFFFFFFUL;
+}
+
+static int HeaderValid(const EventLogPageHeader_t *header) {
+    return header->magic == EVENT_LOG_MAGIC &&
+           header->crc == Crc16((const uint8_t *)header, 14);
+}
+
+static int RecordValid(const EventRecord_t *record) {
+    return record->crc == Crc16((const uint8_t *)record, 14);
+}
+
+// Șterge pagina următoare (cea mai veche) și scrie antetul cu contorul de ștergeri
+static HAL_StatusTypeDef OpenPage(uint32_t page) {
+    EventLogPageHeader_t header;
+    uint32_t eraseCount = 0;
+
+    if (ReadFlash(PAGE_ADDR(page), &header) == 0 && HeaderValid(&header)) {
+        eraseCount = header.eraseCount;
+    } else {
+        // Antet rupt (ștergere sau programare întreruptă): paginile se șterg
+        // pe rând, deci contorul ei e cel puțin cel mai mare al celorlalte
+        for (uint32_t other = 0; other < EVENT_LOG_PAGES; other++) {
+            if (other != page && ReadFlash(PAGE_ADDR(other), &header) == 0 &&
+                HeaderValid(&header) && header.eraseCount > eraseCount) {
+                eraseCount = header.eraseCount;
+            }
+        }
+    }
+
+    if (FlashIf_ErasePage(PAGE_ADDR(page)) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    header.magic = EVENT_LOG_MAGIC;
+    header.eraseCount = eraseCount + 1U;
+    header.firstSequence = nextSequence;
+    header.reserved = 0xFFFF;
+    header.crc = Crc16((const uint8_t *)&header, 14);
+    if (FlashIf_Program(PAGE_ADDR(page), &header, sizeof(header)) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    activePage = page;
+    nextSlot = 0;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef WriteRecord(EventRecord_t *record) {
+    if (nextSlot >= EVENT_LOG_SLOTS &&
+        OpenPage((activePage + 1U) % EVENT_LOG_PAGES) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    record->sequence = nextSequence;
+    record->crc = Crc16((const uint8_t *)record, 14);
+    // Slotul e consumat chiar dacă programarea eșuează: nu se poate reprograma
+    if (FlashIf_Program(SLOT_ADDR(activePage, nextSlot++), record, sizeof(*record)) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    nextSequence++;
+    return HAL_OK;
+}
+
+void EventLog_Init(void) {
+    EventLogPageHeader_t header;
+    EventRecord_t record;
+    uint8_t found = 0;
+
+    eventLogMutex = osMutexNew(NULL);
+
+    // Pagina activă este cea cu antet valid și firstSequence maxim
+    for (uint32_t page = 0; page < EVENT_LOG_PAGES; page++) {
+        if (ReadFlash(PAGE_ADDR(page), &header) == 0 && HeaderValid(&header) &&
+            (!found || header.firstSequence >= nextSequence)) {
+            found = 1;
+            activePage = page;
+            nextSequence = header.firstSequence;
+        }
+    }
+
+    // Jurnal gol: primul Flush va deschide pagina 0
+    nextSlot = EVENT_LOG_SLOTS;
+    if (!found) {
+        activePage = EVENT_LOG_PAGES - 1U;
+        return;
+    }
+
+    // Primul slot șters din pagina activă este următorul slot liber
+    for (uint32_t slot = 0; slot < EVENT_LOG_SLOTS; slot++) {
+        if (ReadFlash(SLOT_ADDR(activePage, slot), &record) != 0) {
+            continue;
+        }
+        if (IsErased(&record)) {
+            nextSlot = slot;
+            break;
+        }
+        if (RecordValid(&record) && record.sequence >= nextSequence) {
+            nextSequence = record.sequence + 1U;
+        }
+    }
+}
+
+void EventLog_Append(uint8_t type, uint16_t value, uint16_t aux) {
+    uint32_t primask = __get_PRIMASK();
+    uint32_t count;
+
+    __disable_irq();
+    count = pendingHead - pendingTail;
+    if (count >= EVENT_LOG_PENDING) {
+        droppedCount++;
+        __set_PRIMASK(primask);
+        return;
+    }
+    EventRecord_t *record = &pending[pendingHead % EVENT_LOG_PENDING];
+    record->timestamp = osKernelGetTickCount();
+    record->type = type;
+    record->flags = 0xFF;
+    record->value = value;
+    record->aux = aux;
+    pendingHead++;
+    __set_PRIMASK(primask);
+
+    // Lotul e complet - trezește StorageTask să-l scrie
+    if (count + 1U == EVENT_LOG_BATCH && storageTaskHandle != NULL) {
+        osThreadFlagsSet(storageTaskHandle, STORAGE_FLAG_EVENTLOG);
+    }
+}
+
+void EventLog_Flush(void) {
+    uint32_t primask;
+    uint16_t dropped;
+
+    if (pendingTail == pendingHead && droppedCount == 0) {
+        return;
+    }
+
+    osMutexAcquire(eventLogMutex, osWaitForever);
+    FlashIf_Begin();
+
+    while (pendingTail != pendingHead) {
+        EventRecord_t record = pending[pendingTail % EVENT_LOG_PENDING];
+        if (WriteRecord(&record) != HAL_OK) {
+            break; // reîncercăm la următorul Flush
+        }
+        pendingTail++;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    dropped = droppedCount;
+    droppedCount = 0;
+    __set_PRIMASK(primask);
+    if (dropped != 0) {
+        EventRecord_t record = {0};
+        record.timestamp = osKernelGetTickCount();
+        record.type = EVT_LOG_DROPPED;
+        record.flags = 0xFF;
+        record.value = dropped;
+        WriteRecord(&record);
+    }
+
+    FlashIf_End();
+    osMutexRelease(eventLogMutex);
+}
+
+uint32_t EventLog_Read(uint32_t *cursor, EventRecord_t *out, uint32_t max) {
+    EventLogPageHeader_t header, nextHeader;
+    EventRecord_t record;
+    uint32_t count = 0;
+
+    osMutexAcquire(eventLogMutex, osWaitForever);
+
+    // Paginile, de la cea mai veche (după cea activă) la cea activă
+    for (uint32_t i = 1; i <= EVENT_LOG_PAGES && count < max; i++) {
+        uint32_t page = (activePage + i) % EVENT_LOG_PAGES;
+        uint32_t slots = (page == activePage) ? nextSlot : EVENT_LOG_SLOTS;
+
+        if (ReadFlash(PAGE_ADDR(page), &header) != 0 || !HeaderValid(&header)) {
+            continue;
+        }
+        // Pagina întreagă e mai veche decât cursorul dacă următoarea începe înainte de el
+        if (i < EVENT_LOG_PAGES &&
+            ReadFlash(PAGE_ADDR((page + 1U) % EVENT_LOG_PAGES), &nextHeader) == 0 &&
+            HeaderValid(&nextHeader) && nextHeader.firstSequence > header.firstSequence &&
+            nextHeader.firstSequence <= *cursor) {
+            continue;
+        }
+
+        for (uint32_t slot = 0; slot < slots && count < max; slot++) {
+            if (ReadFlash(SLOT_ADDR(page, slot), &record) != 0 || IsErased(&record) ||
+                !RecordValid(&record) || record.sequence < *cursor) {
+                continue;
+            }
+            out[count++] = record;
+            *cursor = record.sequence + 1U;
+        }
+    }
+
+    osMutexRelease(eventLogMutex);
+    return count;
+}
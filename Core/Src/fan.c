@@ -0,0 +1,248 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "fan.h"
+#include "pid.h"
+#include "config.h"
+#include "event_log.h"
+#include "buzzer.h"
+#include "led.h"
+#include "safety.h"
+#include "watchdog.h"
+
+extern TIM_HandleTypeDef htim2;
+extern TIM_HandleTypeDef htim3;
+
+static volatile FanMode_t fanMode;
+static volatile uint8_t manualDuty;
+static volatile uint8_t testDuty;
+static volatile uint16_t measuredPpm;
+static volatile AlarmLevel_t measuredLevel;
+// Factorul de umplere curent în pași de 0.1%, ca rampa să fie fină la 100 ms
+static uint16_t dutyPermille;
+static uint32_t appliedCompare;
+static osTimerId_t controlTimer;
+static Pid_t pid;
+static uint8_t pidActive;
+static uint32_t stallMs;
+
+// Turometru: perioada ultimului impuls, actualizată din întreruperea de captură
+static volatile uint32_t tachPeriod;
+static volatile uint32_t tachTick;
+static uint32_t tachLastCapture;
+
+// Rulează în taskul de timere, care se anunță astfel supervizorului
+static void FanControlCallback(void *argument) {
+    Watchdog_CheckIn(WDG_TASK_TIMER);
+    Fan_Update(FAN_CONTROL_PERIOD_MS);
+}
+
+void Fan_Init(void) {
+    const osTimerAttr_t controlTimerAttr = {
+        .name = "FanControl"
+    };
+
+    fanMode = config.fanAuto ? FAN_MODE_AUTO : FAN_MODE_MANUAL;
+    manualDuty = 0;
+    dutyPermille = 0;
+    appliedCompare = 0;
+    pidActive = 0;
+    stallMs = 0;
+    __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_4, 0);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_4);
+    HAL_TIM_IC_Start_IT(&htim2, TIM_CHANNEL_1);
+
+    Pid_Init(&pid, FAN_CONTROL_PERIOD_MS, 0, 1000, 1); // mai mult gaz -> mai mult aer
+    controlTimer = osTimerNew(FanControlCallback, osTimerPeriodic, NULL, &controlTimerAttr);
+    osTimerStart(controlTimer, FAN_CONTROL_PERIOD_MS);
+    Watchdog_Register(WDG_TASK_TIMER, 10U * FAN_CONTROL_PERIOD_MS);
+}
+
+void Fan_SetAuto(void) {
+    fanMode = FAN_MODE_AUTO;
+}
+
+void Fan_SetManual(uint8_t dutyPercent) {
+    manualDuty = (dutyPercent > 100) ? 100 : dutyPercent;
+    fanMode = FAN_MODE_MANUAL;
+}
+
+void Fan_SetTest(uint8_t dutyPercent) {
+    testDuty = (dutyPercent > 100) ? 100 : dutyPercent;
+}
+
+FanMode_t Fan_GetMode(void) {
+    return fanMode;
+}
+
+uint8_t Fan_GetDuty(void) {
+    return (uint8_t)((dutyPermille + 5U) / 10U);
+}
+
+uint8_t Fan_Running(void) {
+    return appliedCompare != 0;
+}
+
+uint16_t Fan_GetRpm(void) {
+    uint32_t period = tachPeriod;
+
+    if (config.fanTachPulses == 0 || period == 0 || HAL_GetTick() - tachTick > FAN_TACH_TIMEOUT_MS) {
+        return 0;
+    }
+    return (uint16_t)(60U * FAN_TACH_TICK_HZ / config.fanTachPulses / period);
+}
+
+void Fan_SetMeasurement(uint16_t ppm, AlarmLevel_t level) {
+    measuredPpm = ppm;
+    measuredLevel = level;
+}
+
+uint8_t Fan_CurveDuty(uint16_t ppm, AlarmLevel_t level) {
+    uint32_t duty;
+
+    if (ppm < config.fanPpmLo) {
+        duty = 0; // aer curat - ventilatorul stă, nu consumă degeaba
+    } else if (ppm >= config.fanPpmHi || config.fanPpmHi <= config.fanPpmLo) {
+        duty = config.fanDutyHi;
+    } else {
+        duty = config.fanDutyLo + (uint32_t)(config.fanDutyHi - config.fanDutyLo) *
+                                  (ppm - config.fanPpmLo) / (config.fanPpmHi - config.fanPpmLo);
+    }
+
+    if (level == ALARM_WARNING && duty < config.fanDutyWarn) {
+        duty = config.fanDutyWarn;
+    } else if (level == ALARM_ALARM && duty < config.fanDutyAlarm) {
+        duty = config.fanDutyAlarm;
+    }
+    return (uint8_t)duty;
+}
+
+// Bucla închisă: PID pe concentrație, cu minimele de avertizare/alarmă
+// și pragul de pornire aplicate peste ieșire (integratorul le urmărește)
+static uint32_t ClosedLoopTarget(uint16_t ppm, AlarmLevel_t level, uint32_t step) {
+    uint32_t target;
+    uint32_t floor = 0;
+
+    if (!pidActive) {
+        Pid_Reset(&pid, ppm, dutyPermille); // preluare fără salt din curbă/manual
+        pidActive = 1;
+    }
+    Pid_Configure(&pid, config.fanKp, config.fanKi, config.fanKd, (int32_t)step);
+    target = (uint32_t)Pid_Update(&pid, config.fanTargetPpm, ppm);
+
+    if (level == ALARM_WARNING) {
+        floor = config.fanDutyWarn * 10U;
+    } else if (level == ALARM_ALARM) {
+        floor = config.fanDutyAlarm * 10U;
+    }
+    if (target != 0 && target < config.fanDutyLo * 10U) {
+        target = config.fanDutyLo * 10U; // sub prag motorul nu se învârte
+    }
+    if (target < floor) {
+        target = floor;
+    }
+    return target;
+}
+
+void Fan_Update(uint32_t elapsedMs) {
+    FanMode_t mode = fanMode;
+    uint16_t ppm = measuredPpm;
+    AlarmLevel_t level = measuredLevel;
+    uint32_t step = config.fanRamp * elapsedMs / 100U; // %/s -> 0.1% pe interval
+    uint16_t previous = dutyPermille;
+    uint32_t target;
+    uint32_t compare;
+    uint32_t primask;
+
+    if (step == 0) {
+        step = 1;
+    }
+    if (mode == FAN_MODE_AUTO && config.fanTargetPpm != 0) {
+        target = ClosedLoopTarget(ppm, level, step);
+    } else {
+        pidActive = 0;
+        target = ((mode == FAN_MODE_AUTO) ? Fan_CurveDuty(ppm, level) : manualDuty) * 10U;
+    }
+
+    // Alarma are prioritate și peste comanda manuală
+    if (level == ALARM_ALARM && target < config.fanDutyAlarm * 10U) {
+        target = config.fanDutyAlarm * 10U;
+    }
+    if (target < testDuty * 10U) {
+        target = testDuty * 10U;
+    }
+
+    if (dutyPermille < target) {
+        // Pornire direct de la fan_duty_lo: sub el motorul nu se învârte
+        if (dutyPermille == 0 && config.fanDutyLo * 10U < target) {
+            dutyPermille = (uint16_t)(config.fanDutyLo * 10U);
+        }
+        dutyPermille = (uint16_t)((target - dutyPermille > step) ? dutyPermille + step : target);
+    } else if (dutyPermille > target) {
+        dutyPermille = (uint16_t)((dutyPermille - target > step) ? dutyPermille - step : target);
+    }
+    if (pidActive && dutyPermille != pid.output) {
+        Pid_Track(&pid, dutyPermille);
+    }
+
+    // Registrul CCR se scrie doar când valoarea chiar se schimbă. Secțiune
+    // critică scurtă: calea de siguranță poate scrie CCR între calcul și
+    // scriere, iar interblocarea de mai jos nu trebuie s-o anuleze
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (Safety_Active() && dutyPermille < config.fanDutyAlarm * 10U) {
+        dutyPermille = (uint16_t)(config.fanDutyAlarm * 10U);
+    }
+    compare = (uint32_t)dutyPermille * FAN_PWM_PERIOD / 1000U;
+    if (compare != appliedCompare) {
+        __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_4, compare);
+        appliedCompare = compare;
+    }
+    __set_PRIMASK(primask);
+
+    if (previous == 0 && dutyPermille != 0) {
+        EventLog_Append(EVT_FAN_ON, (uint16_t)(target / 10U), mode == FAN_MODE_AUTO);
+    } else if (previous != 0 && dutyPermille == 0) {
+        EventLog_Append(EVT_FAN_OFF, 0, mode == FAN_MODE_AUTO);
+    }
+
+    // Rotor blocat: PWM suficient, dar niciun impuls de la turometru
+    // (fără turometru, fan_tach = 0, blocajul nu se poate observa)
+    if (config.fanTachPulses != 0 && dutyPermille >= config.fanDutyLo * 10U && dutyPermille != 0 &&
+        Fan_GetRpm() == 0) {
+        if (stallMs < FAN_STALL_MS && (stallMs += elapsedMs) >= FAN_STALL_MS) {
+            EventLog_Append(EVT_FAN_STALL, Fan_GetDuty(), 0);
+            Led_Set(LED_IND_FAULT, 1);
+            if (config.buzzerEnable) {
+                Buzzer_Play(BUZZER_FAULT);
+            }
+        }
+    } else {
+        if (stallMs >= FAN_STALL_MS) {
+            Buzzer_Stop(BUZZER_FAULT);
+            Led_Set(LED_IND_FAULT, 0);
+        }
+        stallMs = 0;
+    }
+}
+
+HOT_FUNC void Fan_SafetyOn(void) {
+    uint32_t compare = config.fanDutyAlarm * FAN_PWM_PERIOD / 100U;
+
+    if (appliedCompare < compare) {
+        TIM3->CCR4 = compare;
+        appliedCompare = compare;
+        dutyPermille = (uint16_t)(config.fanDutyAlarm * 10U);
+    }
+}
+
+// Captură pe frontul crescător al turometrului (TIM2 e pe 32 de biți,
+// deci diferența e corectă și la depășire)
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    if (htim->Instance == TIM2 && htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1) {
+        uint32_t capture = HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_1);
+
+        tachPeriod = capture - tachLastCapture;
+        tachLastCapture = capture;
+        tachTick = HAL_GetTick();
+    }
+}
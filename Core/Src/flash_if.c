@@ -0,0 +1,145 @@
+#include "flash_if.h"
+#include "cmsis_os.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "sections.h"
+#include <string.h>
+
+static osMutexId_t flashMutex;
+static volatile uint8_t eccError;
+
+void FlashIf_Init(void) {
+    flashMutex = osMutexNew(NULL);
+}
+
+void FlashIf_Begin(void) {
+    osMutexAcquire(flashMutex, osWaitForever);
+    HAL_FLASH_Unlock();
+    // Erori rămase de la sesiunea de debug/reset blochează programarea
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+}
+
+void FlashIf_End(void) {
+    HAL_FLASH_Lock();
+    osMutexRelease(flashMutex);
+}
+
+// Operațiile propriu-zise rulează din SRAM2 (ca funcțiile din
+// stm32l4xx_hal_flash_ramfunc.c): o buclă de așteptare în flash ar opri
+// nucleul pe toată durata ștergerii (~22 ms pe pagină), cu tot cu
+// întreruperile
+HOT_FUNC static uint32_t WaitReady(void) {
+    while ((FLASH->SR & FLASH_SR_BSY) != 0) {
+    }
+    return FLASH->SR & FLASH_FLAG_SR_ERRORS;
+}
+
+HOT_FUNC static uint32_t ErasePageRam(uint32_t page) {
+    uint32_t errors;
+
+    MODIFY_REG(FLASH->CR, FLASH_CR_PNB, page << FLASH_CR_PNB_Pos);
+    SET_BIT(FLASH->CR, FLASH_CR_PER);
+    SET_BIT(FLASH->CR, FLASH_CR_STRT);
+    errors = WaitReady();
+    CLEAR_BIT(FLASH->CR, FLASH_CR_PER | FLASH_CR_PNB);
+    return errors;
+}
+
+// Ca FLASH_Program_DoubleWord: cele două cuvinte, în ordine, separate de ISB
+HOT_FUNC static uint32_t ProgramRam(uint32_t address, uint32_t low, uint32_t high) {
+    uint32_t errors;
+
+    SET_BIT(FLASH->CR, FLASH_CR_PG);
+    *(volatile uint32_t *)address = low;
+    __ISB();
+    *(volatile uint32_t *)(address + 4U) = high;
+    errors = WaitReady();
+    CLEAR_BIT(FLASH->CR, FLASH_CR_PG);
+    return errors;
+}
+
+static uint32_t MaskBegin(uint32_t *basepri) {
+    *basepri = __get_BASEPRI();
+    __set_BASEPRI_MAX(FLASH_IF_MASK_PRIORITY << (8U - __NVIC_PRIO_BITS));
+    return DWT->CYCCNT;
+}
+
+// SysTick a fost mascat: o singură întrerupere a rămas în așteptare, restul
+// tick-urilor se recuperează în ambele ceasuri de 1 ms (ca după Stop 2)
+static void MaskEnd(uint32_t basepri, uint32_t start) {
+    uint32_t ms = (DWT->CYCCNT - start) / (SystemCoreClock / 1000U);
+
+    if (ms > 1U) {
+        uwTick += ms - 1U;
+    }
+    __set_BASEPRI(basepri);
+    if (ms > 1U && osKernelGetState() == osKernelRunning) {
+        xTaskCatchUpTicks(ms - 1U);
+    }
+}
+
+// Ca FLASH_FlushCaches: liniile din cache pot ține conținutul vechi
+static void FlushCaches(uint32_t dataCache, uint8_t instructions) {
+    if (instructions && (FLASH->ACR & FLASH_ACR_ICEN) != 0) {
+        __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+        __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+        __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+    }
+    if (dataCache != 0) {
+        __HAL_FLASH_DATA_CACHE_RESET();
+        __HAL_FLASH_DATA_CACHE_ENABLE();
+    }
+}
+
+HAL_StatusTypeDef FlashIf_ErasePage(uint32_t address) {
+    uint32_t dataCache = FLASH->ACR & FLASH_ACR_DCEN;
+    uint32_t basepri;
+    uint32_t start;
+    uint32_t errors;
+
+    __HAL_FLASH_DATA_CACHE_DISABLE();
+    start = MaskBegin(&basepri);
+    errors = ErasePageRam((address - FLASH_BASE) / FLASH_PAGE_SIZE);
+    MaskEnd(basepri, start);
+    FlushCaches(dataCache, 1);
+    if (errors != 0) {
+        __HAL_FLASH_CLEAR_FLAG(errors);
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+// Mascarea e pe fiecare double-word (~90 us), nu pe tot blocul
+HAL_StatusTypeDef FlashIf_Program(uint32_t address, const void *data, size_t len) {
+    const uint8_t *bytes = data;
+    uint32_t dataCache = FLASH->ACR & FLASH_ACR_DCEN;
+    uint32_t errors = 0;
+
+    __HAL_FLASH_DATA_CACHE_DISABLE();
+    for (size_t offset = 0; offset < len && errors == 0; offset += 8U) {
+        uint32_t words[2];
+        uint32_t basepri;
+        uint32_t start;
+
+        memcpy(words, &bytes[offset], sizeof(words));
+        start = MaskBegin(&basepri);
+        errors = ProgramRam(address + offset, words[0], words[1]);
+        MaskEnd(basepri, start);
+    }
+    FlushCaches(dataCache, 0);
+    if (errors != 0) {
+        __HAL_FLASH_CLEAR_FLAG(errors);
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+int FlashIf_Read(uint32_t address, void *out, size_t len) {
+    eccError = 0;
+    memcpy(out, (const void *)address, len);
+    return eccError ? -1 : 0;
+}
+
+void FlashIf_EccErrorCallback(void) {
+    eccError = 1;
+}
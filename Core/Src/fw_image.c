@@ -0,0 +1,80 @@
+#include "fw_image.h"
+#include "crc.h"
+#include <string.h>
+
+#define RAM_START 0x20000000UL
+#define RAM_END   0x20020000UL
+
+void FwState_Scan(const FwStateRecord_t *records, uint32_t count, FwState_t *state) {
+    memset(state, 0, sizeof(*state));
+
+    for (uint32_t i = 0; i < count; i++) {
+        FwStateRecord_t rec = records[i];
+
+        if (rec.magic == 0xFFFFU && rec.type == 0xFFU && rec.step == 0xFFU && rec.value == 0xFFFFFFFFU) {
+            break; // prima înregistrare ștearsă: sfârșitul
+        }
+        state->used = i + 1U;
+        if (rec.magic != FW_STATE_MAGIC) {
+            continue; // ruptă la scriere; slotul nu se refolosește
+        }
+
+        switch (rec.type) {
+        case FW_REC_INSTALL:
+        case FW_REC_REVERT:
+            state->phase = (rec.type == FW_REC_INSTALL) ? FW_PHASE_INSTALLING : FW_PHASE_REVERTING;
+            state->pages = rec.value;
+            state->done = 0;
+            break;
+        case FW_REC_STEP:
+            state->done = rec.value * 2U + rec.step + 1U;
+            break;
+        case FW_REC_SWAPPED:
+            state->phase = (state->phase == FW_PHASE_INSTALLING) ? FW_PHASE_INSTALLED : FW_PHASE_REVERTED;
+            break;
+        case FW_REC_TRIAL:
+            state->phase = FW_PHASE_TRIAL;
+            break;
+        case FW_REC_CONFIRM:
+        case FW_REC_CLOSED:
+            state->phase = FW_PHASE_IDLE;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int FwImage_Check(uint32_t slot, FwImageHeader_t *header) {
+    const uint32_t *vectors = (const uint32_t *)(slot + FW_HEADER_SIZE);
+    uint32_t sp = vectors[0];
+    uint32_t reset = vectors[1] & ~1U;
+
+    memcpy(header, (const void *)slot, sizeof(*header));
+    if (header->magic != FW_IMAGE_MAGIC || header->imageSize > FW_SLOT_SIZE - FW_HEADER_SIZE) {
+        return -1;
+    }
+    if (sp < RAM_START || sp > RAM_END || (vectors[1] & 1U) == 0 ||
+        reset < FW_APP_ADDR + FW_HEADER_SIZE || reset >= FW_APP_ADDR + FW_SLOT_SIZE) {
+        return -1;
+    }
+    return 0;
+}
+
+int FwImage_Verify(uint32_t slot) {
+    FwImageHeader_t header;
+
+    if (FwImage_Check(slot, &header) != 0 || header.imageSize == 0U) {
+        return -1;
+    }
+    return (Crc32((const uint8_t *)(slot + FW_HEADER_SIZE), header.imageSize) == header.imageCrc) ? 0 : -1;
+}
+
+uint32_t FwImage_Pages(uint32_t slot) {
+    FwImageHeader_t header;
+
+    if (FwImage_Check(slot, &header) != 0 || header.imageSize == 0U) {
+        return FW_SLOT_PAGES;
+    }
+    return (FW_HEADER_SIZE + header.imageSize + FW_PAGE_SIZE - 1U) / FW_PAGE_SIZE;
+}
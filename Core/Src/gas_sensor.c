@@ -0,0 +1,153 @@
+#include "main.h"
+#include "gas_sensor.h"
+#include "config.h"
+#include "sections.h"
+
+#define CURVE(points) { points, (uint8_t)(sizeof(points) / sizeof(points[0])) }
+
+// Curba GPL din foaia de catalog MQ-2 (ppm = 574 * (Rs/R0)^-2.22)
+HOT_CONST static const GasCurvePoint_t mq2Lpg[] = {
+    {   250, 10000 }, {   300, 8336 }, {   400, 4399 }, {   500, 2679 },
+    {   600,  1787 }, {   700, 1269 }, {   800,  943 }, {  1000,  574 },
+    {  1200,   383 }, {  1500,  233 }, {  2000,  123 }, {  2500,   75 },
+    {  3000,    50 }, {  4000,   26 }, {  5000,   16 }, {  7000,    8 },
+    { 10000,     3 },
+};
+
+// Curba CO din foaia de catalog MQ-7 (ppm = 99 * (Rs/R0)^-1.52)
+static const GasCurvePoint_t mq7Co[] = {
+    {   150, 1764 }, {   200, 1140 }, {   250, 812 }, {   300, 616 },
+    {   400,  398 }, {   500,  284 }, {   700, 170 }, {  1000,  99 },
+    {  1500,   54 }, {  2000,   35 }, {  3000,  19 }, {  5000,   9 },
+    { 10000,    3 },
+};
+
+// Curba CO2 din foaia de catalog MQ-135 (ppm = 116.6 * (Rs/R0)^-2.77)
+static const GasCurvePoint_t mq135Co2[] = {
+    {   200, 10000 }, {   250, 5418 }, {   300, 3270 }, {   400, 1474 },
+    {   500,   795 }, {   700,  313 }, {  1000,  117 }, {  1500,   38 },
+    {  2000,    17 }, {  3000,    6 }, {  5000,    1 },
+};
+
+HOT_CONST const GasCurve_t gasCurveMq2Lpg = CURVE(mq2Lpg);
+const GasCurve_t gasCurveMq7Co = CURVE(mq7Co);
+const GasCurve_t gasCurveMq135Co2 = CURVE(mq135Co2);
+
+// Dependența Rs/R0 de temperatură și umiditate (foaia de catalog MQ-2,
+// curbele de 33 %RH și 85 %RH), x1000, din 10 în 10 °C de la -10 °C.
+// Între curbe și între puncte interpolare liniară; în afara lor, capetele.
+#define COMP_T_MIN    (-100)  // 0.1 °C
+#define COMP_T_STEP   100
+#define COMP_RH_LO    330     // 0.1 %RH
+#define COMP_RH_HI    850
+#define COMP_REF_T    200     // condițiile de calibrare a lui R0
+#define COMP_REF_RH   650
+
+static const uint16_t compRhLo[] = { 1380, 1300, 1170, 1060, 980, 940, 920 };
+static const uint16_t compRhHi[] = { 1240, 1160, 1040,  940, 860, 820, 800 };
+
+#define COMP_POINTS (sizeof(compRhLo) / sizeof(compRhLo[0]))
+
+static uint32_t compReference;       // factorul la COMP_REF_T / COMP_REF_RH
+static uint16_t compensation = 1000; // Rs/R0 măsurat / Rs/R0 la calibrare, x1000
+
+static int32_t Interpolate(const uint16_t *curve, uint32_t index, int32_t frac) {
+    return curve[index] + ((int32_t)curve[index + 1U] - curve[index]) * frac / COMP_T_STEP;
+}
+
+static uint32_t Factor(int16_t temperature, uint16_t humidity) {
+    int32_t t = temperature - COMP_T_MIN;
+    int32_t rh = humidity;
+    uint32_t index;
+    int32_t lo, hi;
+
+    if (t < 0) {
+        t = 0;
+    } else if (t > (int32_t)(COMP_POINTS - 1U) * COMP_T_STEP) {
+        t = (int32_t)(COMP_POINTS - 1U) * COMP_T_STEP;
+    }
+    if (rh < COMP_RH_LO) {
+        rh = COMP_RH_LO;
+    } else if (rh > COMP_RH_HI) {
+        rh = COMP_RH_HI;
+    }
+    index = (uint32_t)t / COMP_T_STEP;
+    if (index == COMP_POINTS - 1U) {
+        index--;
+    }
+    lo = Interpolate(compRhLo, index, t - (int32_t)index * COMP_T_STEP);
+    hi = Interpolate(compRhHi, index, t - (int32_t)index * COMP_T_STEP);
+    return (uint32_t)(lo + (hi - lo) * (rh - COMP_RH_LO) / (COMP_RH_HI - COMP_RH_LO));
+}
+
+void GasSensor_SetConditions(int16_t temperature, uint16_t humidity) {
+    if (compReference == 0) {
+        compReference = Factor(COMP_REF_T, COMP_REF_RH);
+    }
+    compensation = (uint16_t)(Factor(temperature, humidity) * 1000U / compReference);
+}
+
+void GasSensor_ClearConditions(void) {
+    compensation = 1000;
+}
+
+uint16_t GasSensor_Compensation(void) {
+    return compensation;
+}
+
+// Corpul comun al GasSensor_Convert / GasSensor_Ppm (SRAM2) și GasSensor_PpmFlash
+static inline __attribute__((always_inline)) uint16_t Ppm(const GasCurve_t *curve, uint16_t r0,
+                                                          uint16_t factor, uint16_t counts) {
+    const GasCurvePoint_t *points = curve->points;
+    uint32_t ratio;
+
+    if (counts == 0) {
+        return 0;
+    }
+    if (counts >= GAS_SENSOR_FULL_SCALE) {
+        return GAS_SENSOR_MAX_PPM;
+    }
+
+    // Divizor RL/Rs: Rs/RL = (FS - c) / c; Rs/R0 = (Rs/RL) / (R0/RL), cu R0/RL x 1000,
+    // raportat apoi la factorul de temperatură/umiditate (x1000)
+    ratio = (uint32_t)(((uint64_t)(GAS_SENSOR_FULL_SCALE - counts) * 1000000000ULL) /
+                       ((uint64_t)counts * r0 * factor));
+
+    if (ratio <= points[0].ratio) {
+        return points[0].ppm;
+    }
+    for (uint32_t i = 1; i < curve->count; i++) {
+        if (ratio <= points[i].ratio) {
+            const GasCurvePoint_t *a = &points[i - 1];
+            const GasCurvePoint_t *b = &points[i];
+            return (uint16_t)(a->ppm - (uint32_t)(a->ppm - b->ppm) * (ratio - a->ratio) /
+                                       (b->ratio - a->ratio));
+        }
+    }
+    return 0;
+}
+
+HOT_FUNC uint16_t GasSensor_Convert(const GasCurve_t *curve, uint16_t r0, uint16_t factor, uint16_t counts) {
+    return Ppm(curve, r0, factor, counts);
+}
+
+HOT_FUNC uint16_t GasSensor_Ppm(uint16_t counts) {
+    return Ppm(&gasCurveMq2Lpg, config.sensorR0, compensation, counts);
+}
+
+uint16_t GasSensor_PpmFlash(uint16_t counts) {
+    return Ppm(&gasCurveMq2Lpg, config.sensorR0, compensation, counts);
+}
+
+AlarmLevel_t GasSensor_Classify(uint16_t ppm, AlarmLevel_t current, uint16_t warnPpm, uint16_t alarmPpm) {
+    uint32_t alarmOff = alarmPpm - alarmPpm / 10U;
+    uint32_t warnOff = warnPpm - warnPpm / 10U;
+
+    if (ppm >= alarmPpm || (current == ALARM_ALARM && ppm >= alarmOff)) {
+        return ALARM_ALARM;
+    }
+    if (ppm >= warnPpm || (current >= ALARM_WARNING && ppm >= warnOff)) {
+        return ALARM_WARNING;
+    }
+    return ALARM_NONE;
+}
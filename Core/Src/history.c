@@ -0,0 +1,56 @@
+#include "history.h"
+#include "cmsis_os.h"
+#include "sections.h"
+
+// 8 KB în SRAM2, ca să nu ocupe SRAM1 (heap-ul FreeRTOS, stivele)
+SRAM2_ZERO static Sample_t historyBuffer[HISTORY_CAPACITY];
+static volatile uint32_t historyHead;
+
+// Un singur scriitor (GasMonitorTask): scrie mai întâi slotul, apoi publică indexul
+void History_Add(uint32_t timestamp, uint16_t value) {
+    uint32_t head = historyHead;
+
+    historyBuffer[head % HISTORY_CAPACITY].timestamp = timestamp;
+    historyBuffer[head % HISTORY_CAPACITY].value = value;
+    historyHead = head + 1;
+}
+
+uint32_t History_Head(void) {
+    return historyHead;
+}
+
+uint32_t History_Oldest(void) {
+    uint32_t head = historyHead;
+    return (head > HISTORY_CAPACITY) ? head - HISTORY_CAPACITY : 0;
+}
+
+size_t History_Encode(uint32_t *cursor, uint32_t *first, uint8_t *out, size_t size) {
+    SampleEncoder_t enc;
+    Sample_t sample;
+
+    SampleEncoder_Init(&enc, out, size);
+    *first = *cursor;
+    for (;;) {
+        // Blocăm schedulerul doar cât copiem un slot, ca scriitorul să nu-l suprascrie
+        int32_t lock = osKernelLock();
+        uint32_t oldest = History_Oldest();
+        if (*cursor < oldest) {
+            *cursor = oldest; // eșantioanele mai vechi au fost deja suprascrise
+        }
+        if (*cursor == historyHead) {
+            osKernelRestoreLock(lock);
+            break;
+        }
+        sample = historyBuffer[*cursor % HISTORY_CAPACITY];
+        osKernelRestoreLock(lock);
+
+        if (enc.count == 0) {
+            *first = *cursor;
+        }
+        if (SampleEncoder_Put(&enc, &sample) != 0) {
+            break;
+        }
+        (*cursor)++;
+    }
+    return SampleEncoder_Finish(&enc);
+}
@@ -0,0 +1,100 @@
+#include "main.h"
+#include "hot_path.h"
+#include "gas_sensor.h"
+#include "pid.h"
+#include "fan.h"
+#include "config.h"
+#include <string.h>
+
+#define VECTOR_COUNT   (16U + (uint32_t)I2C4_ER_IRQn + 1U)
+#define BENCH_CALLS    256U
+#define BENCH_SETPOINT 300
+
+#if RAM_HOT_PATHS
+// VTOR cere alinierea la puterea lui 2 de peste dimensiunea tabelei
+// (101 vectori x 4 octeți -> 512)
+SRAM2_ZERO __attribute__((aligned(512))) static uint32_t ramVectors[VECTOR_COUNT];
+#endif
+
+static volatile HotIsrStats_t isrStats[HOT_ISR_COUNT];
+
+static const char *const isrNames[HOT_ISR_COUNT] = {
+    [HOT_ISR_EXTI0] = "exti0",
+    [HOT_ISR_DMA_LOG] = "dma_log",
+    [HOT_ISR_USART2] = "usart2",
+    [HOT_ISR_LPUART1] = "lpuart1",
+    [HOT_ISR_USART1] = "usart1",
+    [HOT_ISR_USART3] = "usart3",
+};
+
+void HotPath_Init(void) {
+#if RAM_HOT_PATHS
+    // Și intrarea în excepție citește vectorul: cu tabela în flash, o
+    // întrerupere din timpul unei ștergeri ar aștepta sfârșitul ei
+    memcpy(ramVectors, (const void *)SCB->VTOR, sizeof(ramVectors));
+    SCB->VTOR = (uint32_t)ramVectors;
+    __DSB();
+    __ISB();
+#endif
+}
+
+HOT_FUNC void HotPath_IsrDone(HotIsr_t isr, uint32_t start) {
+    uint32_t cycles = DWT->CYCCNT - start;
+    volatile HotIsrStats_t *stats = &isrStats[isr];
+
+    stats->count++;
+    stats->lastCycles = cycles;
+    if (cycles > stats->maxCycles) {
+        stats->maxCycles = cycles;
+    }
+}
+
+void HotPath_GetIsrStats(HotIsr_t isr, HotIsrStats_t *out) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *out = *(const HotIsrStats_t *)&isrStats[isr];
+    __set_PRIMASK(primask);
+}
+
+const char *HotPath_IsrName(HotIsr_t isr) {
+    return isrNames[isr];
+}
+
+// Fiecare apel e măsurat cu întreruperile oprite; variantele din flash și
+// din SRAM2 alternează, ca ART să fie la fel de „cald” pentru amândouă
+void HotPath_Bench(HotBench_t *ppm, HotBench_t *pid) {
+    Pid_t flashPid;
+    Pid_t ramPid;
+    volatile uint32_t sink = 0;
+
+    memset(ppm, 0, sizeof(*ppm));
+    memset(pid, 0, sizeof(*pid));
+    Pid_Init(&flashPid, FAN_CONTROL_PERIOD_MS, 0, 1000, 1);
+    Pid_Configure(&flashPid, config.fanKp, config.fanKi, config.fanKd, 0);
+    ramPid = flashPid;
+
+    for (uint32_t i = 0; i < BENCH_CALLS; i++) {
+        uint16_t counts = (uint16_t)(i * GAS_SENSOR_FULL_SCALE / (BENCH_CALLS - 1U));
+        uint32_t primask = __get_PRIMASK();
+        uint32_t start;
+
+        __disable_irq();
+        start = DWT->CYCCNT;
+        sink += GasSensor_PpmFlash(counts);
+        ppm->flashCycles += DWT->CYCCNT - start;
+        start = DWT->CYCCNT;
+        sink += GasSensor_Ppm(counts);
+        ppm->ramCycles += DWT->CYCCNT - start;
+
+        start = DWT->CYCCNT;
+        sink += (uint32_t)Pid_UpdateFlash(&flashPid, BENCH_SETPOINT, counts / 4);
+        pid->flashCycles += DWT->CYCCNT - start;
+        start = DWT->CYCCNT;
+        sink += (uint32_t)Pid_Update(&ramPid, BENCH_SETPOINT, counts / 4);
+        pid->ramCycles += DWT->CYCCNT - start;
+        __set_PRIMASK(primask);
+    }
+    ppm->calls = BENCH_CALLS;
+    pid->calls = BENCH_CALLS;
+}
@@ -0,0 +1,105 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "led.h"
+
+#define LED_RED   (1U << 0)
+#define LED_GREEN (1U << 1)
+
+// Un bit pe perioadă de LED_TICK_MS, bitul 0 primul; length <= 32
+typedef struct {
+    uint8_t leds;   // LED-urile pe care indicația le comandă
+    uint8_t length; // lungimea ciclului, în perioade
+    uint32_t red;
+    uint32_t green;
+} LedPattern_t;
+
+static const LedPattern_t patterns[LED_IND_COUNT] = {
+    // 100 ms verde la fiecare 2 s
+    [LED_IND_HEARTBEAT] = { LED_GREEN,           20, 0x00000, 0x00001 },
+    // verde aprins, cu o pauză scurtă la fiecare 2 s
+    [LED_IND_LINK]      = { LED_GREEN,           20, 0x00000, 0xFFFFE },
+    // roșu 0.5 s / 0.5 s
+    [LED_IND_WARNING]   = { LED_RED,             10, 0x0001F, 0x00000 },
+    // roșu 5 Hz, verde stins
+    [LED_IND_ALARM]     = { LED_RED | LED_GREEN,  2, 0x00001, 0x00000 },
+    // roșu și verde alternativ
+    [LED_IND_FAULT]     = { LED_RED | LED_GREEN, 10, 0x0001F, 0x003E0 },
+};
+
+static volatile uint32_t activeMask = 1U << LED_IND_HEARTBEAT;
+static uint32_t tick;
+static uint32_t output;
+static osTimerId_t ledTimer;
+
+static uint32_t Pattern(uint32_t mask, uint32_t now) {
+    uint32_t result = 0;
+    uint32_t assigned = 0;
+
+    for (int i = LED_IND_COUNT - 1; i >= 0; i--) {
+        const LedPattern_t *p = &patterns[i];
+        uint32_t phase;
+        uint32_t leds;
+
+        if ((mask & (1U << i)) == 0 || (leds = p->leds & ~assigned) == 0) {
+            continue;
+        }
+        phase = now % p->length;
+        if ((leds & LED_RED) && (p->red >> phase) & 1U) {
+            result |= LED_RED;
+        }
+        if ((leds & LED_GREEN) && (p->green >> phase) & 1U) {
+            result |= LED_GREEN;
+        }
+        assigned |= leds;
+    }
+    return result;
+}
+
+// O singură scriere BSRR pentru ambele LED-uri, doar la schimbare
+static void Apply(uint32_t leds) {
+    uint32_t set = ((leds & LED_RED) ? GPIO_PIN_5 : 0U) | ((leds & LED_GREEN) ? GPIO_PIN_6 : 0U);
+    uint32_t reset = (GPIO_PIN_5 | GPIO_PIN_6) & ~set;
+
+    if (leds != output) {
+        GPIOA->BSRR = set | (reset << 16);
+        output = leds;
+    }
+}
+
+static void LedTimerCallback(void *argument) {
+    Apply(Pattern(activeMask, ++tick));
+}
+
+void Led_Init(void) {
+    const osTimerAttr_t ledTimerAttr = {
+        .name = "Led"
+    };
+
+    output = 0; // MX_GPIO_Init pornește cu ambele LED-uri stinse
+    ledTimer = osTimerNew(LedTimerCallback, osTimerPeriodic, NULL, &ledTimerAttr);
+    osTimerStart(ledTimer, LED_TICK_MS);
+}
+
+void Led_Set(LedIndication_t indication, uint8_t active) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (active) {
+        activeMask |= 1U << indication;
+    } else {
+        activeMask &= ~(1U << indication);
+    }
+    __set_PRIMASK(primask);
+}
+
+void Led_Halt(LedIndication_t indication) {
+    __disable_irq();
+    for (uint32_t now = 0;; now++) {
+        Apply(Pattern(1U << indication, now));
+        // SysTick (1 ms, configurat de HAL_Init) se numără și fără întreruperi
+        for (uint32_t ms = 0; ms < LED_TICK_MS; ms++) {
+            while ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) == 0) {
+            }
+        }
+    }
+}
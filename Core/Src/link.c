@@ -0,0 +1,182 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "link.h"
+#include "power.h"
+#include "crc.h"
+#include "watchdog.h"
+#include "logger.h"
+#include "diag.h"
+#include "modbus.h"
+#include "sections.h"
+#include <string.h>
+
+// Transmisia blocantă se face pe bucăți, cu anunțare la watchdog între
+// ele: la 1200 baud, 64 de octeți durează ~530 ms, iar $cfg list câteva
+// secunde, peste termenul BluetoothTask
+#define LINK_TX_CHUNK 64U
+
+extern UART_HandleTypeDef *linkUart;
+extern osThreadId_t bluetoothTaskHandle;
+extern osThreadId_t diagTaskHandle;
+
+// Buffer-ul recepției prin întrerupere: putere a lui 2, cel puțin două
+// blocuri OTA, ca un bloc să vină cât precedentul e scris în flash
+#define LINK_RX_RING 2048U
+
+static uint8_t listenByte;
+static volatile uint8_t listenDone; // listenByte chiar a fost primit (nu eroare)
+static uint8_t rxRing[LINK_RX_RING];
+static volatile uint16_t rxHead;
+static volatile uint16_t rxTail;
+static volatile uint8_t rxRingActive;
+static uint8_t rxByte;
+
+// Comenzile primite pe consola de diagnostic răspund tot acolo: din
+// DiagTask, Link_Print și cadrele ajung în jurnal (USART2), nu pe link.
+// Logger_WriteText golește jurnalul când se umple, deci răspunsurile
+// lungi nu se pierd.
+void Link_Send(const uint8_t *data, uint16_t len) {
+    if (diagTaskHandle != NULL && osThreadGetId() == diagTaskHandle) {
+        Logger_WriteText((const char *)data, len);
+        return;
+    }
+    while (len > 0) {
+        uint16_t chunk = (len > LINK_TX_CHUNK) ? LINK_TX_CHUNK : len;
+
+        Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+        HAL_UART_Transmit(linkUart, (uint8_t *)data, chunk, HAL_MAX_DELAY);
+        data += chunk;
+        len -= chunk;
+    }
+    Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+}
+
+void Link_ListenArm(void) {
+    if (linkUart->Instance == LPUART1) {
+        listenDone = 0;
+        HAL_UART_Receive_IT(linkUart, &listenByte, 1);
+    } else {
+        Power_LinkWakeArm(1);
+    }
+}
+
+uint8_t Link_ListenDisarm(uint8_t *byte) {
+    if (linkUart->Instance != LPUART1) {
+        Power_LinkWakeArm(0);
+        return 0;
+    }
+    // Întâi se oprește întreruperea, apoi se testează listenDone: un octet
+    // terminat între test și oprire s-ar pierde. Cel sosit după oprire
+    // rămâne în RDR și e preluat direct.
+    ATOMIC_CLEAR_BIT(linkUart->Instance->CR1, USART_CR1_RXNEIE);
+    if (!listenDone && __HAL_UART_GET_FLAG(linkUart, UART_FLAG_RXNE)) {
+        listenByte = (uint8_t)linkUart->Instance->RDR;
+        listenDone = 1;
+    }
+    // După o eroare de cadru, zgomot sau depășire RxState e tot READY,
+    // dar listenByte nu e un octet primit
+    if (!listenDone) {
+        HAL_UART_AbortReceive(linkUart);
+        return 0;
+    }
+    if (linkUart->RxState != HAL_UART_STATE_READY) {
+        HAL_UART_AbortReceive(linkUart);
+    }
+    *byte = listenByte;
+    return 1;
+}
+
+void Link_RxStart(void) {
+    rxHead = 0;
+    rxTail = 0;
+    rxRingActive = 1;
+    HAL_UART_Receive_IT(linkUart, &rxByte, 1);
+}
+
+void Link_RxStop(void) {
+    rxRingActive = 0;
+    HAL_UART_AbortReceive(linkUart);
+}
+
+uint16_t Link_RxRead(uint8_t *out, uint16_t len, uint32_t timeoutMs) {
+    uint32_t start = osKernelGetTickCount();
+    uint16_t count = 0;
+
+    // Un cadru OTA întreg durează la 1200 baud ~8.6 s: task-ul se anunță
+    // la fiecare trecere, termenul real al citirii e timeoutMs
+    while (count < len) {
+        Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+        if (rxTail != rxHead) {
+            out[count++] = rxRing[rxTail];
+            rxTail = (uint16_t)((rxTail + 1U) & (LINK_RX_RING - 1U));
+        } else if (osKernelGetTickCount() - start >= timeoutMs) {
+            break;
+        } else {
+            osDelay(1);
+        }
+    }
+    return count;
+}
+
+// Octetul primit prin întrerupere: în buffer-ul circular cât e activ,
+// altfel trezirea BluetoothTask (LPUART1, eventual chiar în Stop 2).
+// Cu buffer-ul plin octetul se pierde, iar cadrul lui e respins la CRC.
+HOT_FUNC void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart == linkUart && rxRingActive) {
+        uint16_t next = (uint16_t)((rxHead + 1U) & (LINK_RX_RING - 1U));
+
+        if (next != rxTail) {
+            rxRing[rxHead] = rxByte;
+            rxHead = next;
+        }
+        HAL_UART_Receive_IT(huart, &rxByte, 1);
+    } else if (huart == linkUart) {
+        listenDone = 1;
+        if (bluetoothTaskHandle != NULL) {
+            osThreadFlagsSet(bluetoothTaskHandle, LINK_FLAG_RX);
+        }
+    } else if (huart->Instance == USART2) {
+        Diag_RxCallback();
+    } else if (huart->Instance == USART3) {
+        Modbus_RxFullCallback();
+    }
+}
+
+// Depășirea (un octet pierdut cât întreruperile erau mascate de o
+// ștergere de pagină) oprește recepția: se rearmează, iar cadrul afectat
+// e respins la CRC. Pe USART3 tot aici ajunge și RTO, sfârșitul unui cadru
+// Modbus recepționat prin DMA.
+HOT_FUNC void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    if (huart == linkUart && rxRingActive) {
+        HAL_UART_Receive_IT(huart, &rxByte, 1);
+    } else if (huart->Instance == USART2) {
+        Diag_ErrorCallback();
+    } else if (huart->Instance == USART3) {
+        Modbus_RxEndCallback(huart->ErrorCode);
+    }
+}
+
+void Link_SendFrame(uint8_t type, const uint8_t *payload, uint16_t len) {
+    uint8_t header[4] = { LINK_FRAME_SYNC, type, (uint8_t)len, (uint8_t)(len >> 8) };
+    uint16_t crc = Crc16_Update(Crc16(&header[1], 3), payload, len);
+    uint8_t trailer[2] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+
+    Link_Send(header, sizeof(header));
+    Link_Send(payload, len);
+    Link_Send(trailer, sizeof(trailer));
+}
+
+void Link_Print(const char *text) {
+    Link_Send((const uint8_t *)text, (uint16_t)strlen(text));
+}
+
+void Link_PrintU32(uint32_t value) {
+    char digits[10];
+    uint16_t n = sizeof(digits);
+
+    do {
+        digits[--n] = (char)('0' + value % 10U);
+        value /= 10U;
+    } while (value != 0);
+    Link_Send((const uint8_t *)&digits[n], (uint16_t)(sizeof(digits) - n));
+}
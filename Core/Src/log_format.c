@@ -0,0 +1,145 @@
+#include "log_format.h"
+
+typedef struct {
+    char *out;
+    uint32_t size;
+    uint32_t len;
+} Output_t;
+
+static void Put(Output_t *o, char c) {
+    if (o->len + 1U < o->size) {
+        o->out[o->len++] = c;
+    }
+}
+
+static void PutPadded(Output_t *o, const char *text, uint32_t textLen, uint32_t width, uint8_t left, char pad) {
+    uint32_t padding = (width > textLen) ? width - textLen : 0U;
+
+    // Zerourile se pun după semn
+    if (pad == '0' && textLen > 0 && text[0] == '-') {
+        Put(o, *text++);
+        textLen--;
+    }
+    while (!left && padding-- > 0) {
+        Put(o, pad);
+    }
+    while (textLen-- > 0) {
+        Put(o, *text++);
+    }
+    while (left && padding-- > 0) {
+        Put(o, ' ');
+    }
+}
+
+static uint32_t Number(char *buf, uint32_t value, uint32_t base, uint8_t upper, uint8_t negative) {
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[10];
+    uint32_t n = 0;
+    uint32_t len = 0;
+
+    do {
+        tmp[n++] = digits[value % base];
+        value /= base;
+    } while (value != 0);
+    if (negative) {
+        buf[len++] = '-';
+    }
+    while (n > 0) {
+        buf[len++] = tmp[--n];
+    }
+    return len;
+}
+
+uint32_t LogFormat(char *out, uint32_t size, const char *fmt, const uint32_t *args, uint32_t nargs,
+                   LogResolveString_t resolveString) {
+    Output_t o = { out, size, 0 };
+    uint32_t arg = 0;
+
+    while (*fmt != '\0') {
+        char buf[12];
+        uint32_t len;
+        uint32_t width = 0;
+        uint8_t left = 0;
+        char pad = ' ';
+        uint32_t value;
+
+        if (*fmt != '%') {
+            Put(&o, *fmt++);
+            continue;
+        }
+        fmt++;
+        if (*fmt == '-') {
+            left = 1;
+            fmt++;
+        }
+        if (*fmt == '0') {
+            pad = '0';
+            fmt++;
+        }
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10U + (uint32_t)(*fmt++ - '0');
+        }
+        while (*fmt == 'l' || *fmt == 'h') {
+            fmt++;
+        }
+        if (*fmt == '\0') {
+            break;
+        }
+        if (*fmt == '%') {
+            Put(&o, *fmt++);
+            continue;
+        }
+
+        // Argumente lipsă (șir de format modificat): se afișează 0
+        value = (arg < nargs) ? args[arg] : 0U;
+        arg++;
+        switch (*fmt++) {
+        case 'd':
+        case 'i':
+            len = ((int32_t)value < 0) ? Number(buf, 0U - value, 10U, 0, 1) : Number(buf, value, 10U, 0, 0);
+            PutPadded(&o, buf, len, width, left, pad);
+            break;
+        case 'u':
+            PutPadded(&o, buf, Number(buf, value, 10U, 0, 0), width, left, pad);
+            break;
+        case 'x':
+            PutPadded(&o, buf, Number(buf, value, 16U, 0, 0), width, left, pad);
+            break;
+        case 'X':
+            PutPadded(&o, buf, Number(buf, value, 16U, 1, 0), width, left, pad);
+            break;
+        case 'p':
+            buf[0] = '0';
+            buf[1] = 'x';
+            len = 2U + Number(&buf[2], value, 16U, 0, 0);
+            PutPadded(&o, buf, len, width, left, ' ');
+            break;
+        case 'c':
+            buf[0] = (char)value;
+            PutPadded(&o, buf, 1, width, left, ' ');
+            break;
+        case 's': {
+            const char *text = (resolveString != 0) ? resolveString(value) : 0;
+            uint32_t textLen = 0;
+
+            if (text == 0) {
+                text = "?";
+            }
+            while (text[textLen] != '\0') {
+                textLen++;
+            }
+            PutPadded(&o, text, textLen, width, left, ' ');
+            break;
+        }
+        default:
+            // Specificator necunoscut: copiat ca atare
+            Put(&o, '%');
+            Put(&o, fmt[-1]);
+            break;
+        }
+    }
+    if (o.size > 0) {
+        o.out[o.len] = '\0';
+    }
+    return o.len;
+}
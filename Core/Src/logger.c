@@ -0,0 +1,287 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "log_format.h"
+#include "link.h"
+#include "config.h"
+#include "crc.h"
+#include "modbus.h"
+#include "sections.h"
+#include <string.h>
+
+#define LOG_RING_MASK     (LOG_RING_WORDS - 1U)
+#define LOG_TX_SIZE       256U
+#define LOG_TX_TIMEOUT_MS 100U
+#define LOG_TEXT_MAX      (LOG_MAX_DATA * 4U)
+
+extern UART_HandleTypeDef huart2;
+extern osThreadId_t diagTaskHandle;
+
+SRAM2_ZERO static uint32_t ring[LOG_RING_WORDS]; // zero = înregistrare nescrisă
+static volatile uint32_t head;    // rezervat de producători
+static volatile uint32_t tail;    // consumat de DiagTask
+static volatile uint32_t dropped; // de raportat pe fir
+static volatile LoggerStats_t stats;
+
+// Două buffere: unul se umple cât celălalt e trimis prin DMA
+static uint8_t txBuffer[2][LOG_TX_SIZE];
+static uint32_t txLen;
+static uint8_t txActive;
+static volatile uint8_t txBusy;
+
+// Rezervă words cuvinte; întoarce indexul de start sau 0xFFFFFFFF dacă
+// bufferul e plin
+static uint32_t Reserve(uint32_t words) {
+    uint32_t start;
+    uint32_t used;
+
+    do {
+        start = __LDREXW((volatile uint32_t *)&head);
+        used = start + words - tail;
+        if (used > LOG_RING_WORDS) {
+            __CLREX();
+            return 0xFFFFFFFFUL;
+        }
+    } while (__STREXW(start + words, (volatile uint32_t *)&head) != 0);
+
+    if (used > stats.highWater) {
+        stats.highWater = used; // orientativ: fără sincronizare între producători
+    }
+    return start;
+}
+
+static void Drop(void) {
+    uint32_t value;
+
+    do {
+        value = __LDREXW(&dropped);
+    } while (__STREXW(value + 1U, &dropped) != 0);
+}
+
+void Logger_Write(const char *fmt, uint32_t nargs, const uint32_t *args) {
+    uint32_t start;
+
+    if (nargs > LOG_MAX_DATA) {
+        nargs = LOG_MAX_DATA;
+    }
+    start = Reserve(2U + nargs);
+    if (start == 0xFFFFFFFFUL) {
+        Drop();
+        return;
+    }
+    ring[(start + 1U) & LOG_RING_MASK] = (nargs << 28) | (uwTick & 0x0FFFFFFFUL);
+    for (uint32_t i = 0; i < nargs; i++) {
+        ring[(start + 2U + i) & LOG_RING_MASK] = args[i];
+    }
+    // Cuvântul 0 marchează înregistrarea completă pentru DiagTask
+    __DMB();
+    ring[start & LOG_RING_MASK] = (uint32_t)(uintptr_t)fmt;
+}
+
+void Logger_WriteText(const char *text, uint32_t len) {
+    while (len > 0) {
+        uint32_t chunk = (len > LOG_TEXT_MAX) ? LOG_TEXT_MAX : len;
+        uint32_t words = (chunk + 3U) / 4U;
+        uint32_t start = Reserve(2U + words);
+
+        // Răspunsurile consolei de diagnostic ($cfg list are peste 2 KB) se
+        // scriu din DiagTask, singurul consumator: bufferul plin se golește
+        // pe loc, altfel nimic nu l-ar goli înainte de sfârșitul comenzii
+        if (start == 0xFFFFFFFFUL && __get_IPSR() == 0U && diagTaskHandle != NULL &&
+            osThreadGetId() == diagTaskHandle) {
+            Logger_Drain();
+            start = Reserve(2U + words);
+        }
+        if (start == 0xFFFFFFFFUL) {
+            Drop();
+            return;
+        }
+        ring[(start + 1U) & LOG_RING_MASK] = (words << 28) | (uwTick & 0x0FFFFFFFUL);
+        for (uint32_t i = 0; i < words; i++) {
+            uint32_t word = 0;
+
+            for (uint32_t b = 0; b < 4U && i * 4U + b < chunk; b++) {
+                word |= (uint32_t)(uint8_t)text[i * 4U + b] << (8U * b);
+            }
+            ring[(start + 2U + i) & LOG_RING_MASK] = word;
+        }
+        __DMB();
+        ring[start & LOG_RING_MASK] = LOG_TAG_TEXT | chunk;
+        text += chunk;
+        len -= chunk;
+    }
+}
+
+// printf și restul ieșirii stdio din newlib ajung în jurnal, nu pe
+// __io_putchar octet cu octet (înlocuiește _write-ul slab din syscalls.c)
+int _write(int file, char *ptr, int len) {
+    (void)file;
+    Logger_WriteText(ptr, (uint32_t)len);
+    return len;
+}
+
+uint8_t Logger_Busy(void) {
+    return txBusy;
+}
+
+void Logger_GetStats(LoggerStats_t *out) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *out = *(const LoggerStats_t *)&stats;
+    out->dropped += dropped;
+    __set_PRIMASK(primask);
+}
+
+static void Flush(void) {
+    if (txLen == 0) {
+        return;
+    }
+    // Flag-ul poate fi rămas de la un transfer anterior: contează txBusy
+    while (txBusy) {
+        if (osThreadFlagsWait(LOG_FLAG_TX_DONE, osFlagsWaitAny, LOG_TX_TIMEOUT_MS) == (uint32_t)osErrorTimeout) {
+            HAL_UART_AbortTransmit(&huart2);
+            txBusy = 0;
+        }
+    }
+    txBusy = 1;
+    if (HAL_UART_Transmit_DMA(&huart2, txBuffer[txActive], (uint16_t)txLen) != HAL_OK) {
+        txBusy = 0;
+    }
+    txActive ^= 1U;
+    txLen = 0;
+}
+
+static void Emit(const void *data, uint32_t len) {
+    const uint8_t *bytes = data;
+
+    while (len > 0) {
+        uint32_t chunk = LOG_TX_SIZE - txLen;
+
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(&txBuffer[txActive][txLen], bytes, chunk);
+        txLen += chunk;
+        bytes += chunk;
+        len -= chunk;
+        if (txLen == LOG_TX_SIZE) {
+            Flush();
+        }
+    }
+}
+
+// Pe țintă, argumentul %s e chiar pointerul
+static const char *ResolveString(uint32_t address) {
+    return (const char *)(uintptr_t)address;
+}
+
+static void EmitText(uint32_t header, uint32_t timestamp, const uint32_t *data, uint32_t words) {
+    char line[96];
+    char stamp[16];
+    uint32_t len;
+
+    if ((header & LOG_TAG_MASK) == LOG_TAG_TEXT) {
+        Emit(data, header & ~LOG_TAG_MASK);
+        return;
+    }
+    if ((header & LOG_TAG_MASK) == LOG_TAG_DROPPED) {
+        len = LogFormat(line, sizeof(line), "[log] %u inregistrari pierdute\r\n",
+                        (const uint32_t[]){ header & ~LOG_TAG_MASK }, 1, 0);
+        Emit(line, len);
+        return;
+    }
+    len = LogFormat(stamp, sizeof(stamp), "[%u.%03u] ", (const uint32_t[]){ timestamp / 1000U, timestamp % 1000U },
+                    2, 0);
+    Emit(stamp, len);
+    len = LogFormat(line, sizeof(line), (const char *)(uintptr_t)header, data, words, ResolveString);
+    Emit(line, len);
+    Emit("\r\n", 2);
+}
+
+// Cadru LINK_FRAME_LOG cu înregistrările brute, ca pe link
+static void EmitFrame(const uint32_t *words, uint32_t count) {
+    uint16_t len = (uint16_t)(count * 4U);
+    uint8_t header[4] = { LINK_FRAME_SYNC, LINK_FRAME_LOG, (uint8_t)len, (uint8_t)(len >> 8) };
+    uint16_t crc = Crc16_Update(Crc16(&header[1], 3), (const uint8_t *)words, len);
+    uint8_t trailer[2] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+
+    Emit(header, sizeof(header));
+    Emit(words, len);
+    Emit(trailer, sizeof(trailer));
+}
+
+// În modul binar adună înregistrările întregi în cadre de cel mult
+// LINK_FRAME_MAX_PAYLOAD octeți
+void Logger_Drain(void) {
+    uint32_t frame[LINK_FRAME_MAX_PAYLOAD / 4U];
+    uint32_t frameWords = 0;
+    uint32_t lost;
+
+    do {
+        lost = __LDREXW(&dropped);
+    } while (__STREXW(0, &dropped) != 0);
+    if (lost != 0) {
+        stats.dropped += lost;
+        if (config.logBinary) {
+            frame[frameWords++] = LOG_TAG_DROPPED | (lost & ~LOG_TAG_MASK);
+            frame[frameWords++] = uwTick & 0x0FFFFFFFUL;
+        } else {
+            EmitText(LOG_TAG_DROPPED | (lost & ~LOG_TAG_MASK), 0, 0, 0);
+        }
+    }
+
+    while (tail != head) {
+        uint32_t header = ring[tail & LOG_RING_MASK];
+        uint32_t info;
+        uint32_t words;
+        uint32_t record[2U + LOG_MAX_DATA];
+
+        // Rezervat, dar încă nescris de producător
+        if (header == 0) {
+            break;
+        }
+        __DMB();
+        info = ring[(tail + 1U) & LOG_RING_MASK];
+        words = info >> 28;
+        record[0] = header;
+        record[1] = info;
+        for (uint32_t i = 0; i < words; i++) {
+            record[2U + i] = ring[(tail + 2U + i) & LOG_RING_MASK];
+        }
+        // Cuvintele se șterg: la următoarea trecere oricare poate ajunge
+        // cuvântul 0 al unei înregistrări
+        for (uint32_t i = 0; i < 2U + words; i++) {
+            ring[(tail + i) & LOG_RING_MASK] = 0;
+        }
+        __DMB();
+        tail += 2U + words;
+        stats.written++;
+
+        if (config.logBinary) {
+            if (frameWords + 2U + words > LINK_FRAME_MAX_PAYLOAD / 4U) {
+                EmitFrame(frame, frameWords);
+                frameWords = 0;
+            }
+            memcpy(&frame[frameWords], record, (2U + words) * 4U);
+            frameWords += 2U + words;
+        } else {
+            EmitText(header, info & 0x0FFFFFFFUL, &record[2], words);
+        }
+    }
+    if (frameWords != 0) {
+        EmitFrame(frame, frameWords);
+    }
+    Flush();
+}
+
+HOT_FUNC void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart == &huart2) {
+        txBusy = 0;
+        if (diagTaskHandle != NULL) {
+            osThreadFlagsSet(diagTaskHandle, LOG_FLAG_TX_DONE);
+        }
+    } else if (huart->Instance == USART3) {
+        Modbus_TxCallback();
+    }
+}
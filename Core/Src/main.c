@@ -1,31 +1,128 @@
 #include "main.h"
 #include "cmsis_os.h"
+#include "history.h"
+#include "event_log.h"
+#include "flash_if.h"
+#include "config.h"
+#include "command.h"
+#include "link.h"
+#include "gas_sensor.h"
+#include "sensors.h"
+#include "baseline.h"
+#include "selftest.h"
+#include "fan.h"
+#include "buzzer.h"
+#include "led.h"
+#include "safety.h"
+#include "watchdog.h"
+#include "crash_dump.h"
+#include "stack_guard.h"
+#include "power.h"
+#include "adc.h"
+#include "supply.h"
+#include "logger.h"
+#include "diag.h"
+#include "hot_path.h"
+#include "ota.h"
+#include "modbus.h"
+#include "env_sensor.h"
 #include <string.h>
 
 // Declarații de funcții
 void SystemClock_Config(void);
 void MX_GPIO_Init(void);
 void MX_USART1_UART_Init(void);
+void MX_LPUART1_UART_Init(void);
+void MX_DMA_Init(void);
+void MX_USART2_UART_Init(void);
+void MX_USART3_UART_Init(void);
+void MX_I2C1_Init(void);
+void MX_TIM2_Init(void);
+void MX_TIM3_Init(void);
+void MX_TIM6_Init(void);
 void StartGasMonitorTask(void *argument);
 void StartBluetoothTask(void *argument);
-void ControlFan(uint8_t command); // Funcție pentru control ventilator
+void StartStorageTask(void *argument);
+void ControlFan(uint8_t command); // Funcție pentru control ventilator (comandă manuală)
+static void SendHistory(uint32_t *cursor, uint8_t frameType);
 
 // Handle-uri pentru UART și task-uri
 UART_HandleTypeDef huart1;
+UART_HandleTypeDef hlpuart1;
+UART_HandleTypeDef *linkUart = &huart1; // portul modulului HC-05 (cfg link_lpuart)
+UART_HandleTypeDef huart2;                // VCP ST-LINK: jurnalul de diagnostic
+DMA_HandleTypeDef hdma_usart2_tx;
+UART_HandleTypeDef huart3;                // RS-485: slave Modbus RTU (cfg modbus_addr)
+DMA_HandleTypeDef hdma_usart3_rx;
+DMA_HandleTypeDef hdma_usart3_tx;
+I2C_HandleTypeDef hi2c1;                  // SHT3x (temperatură și umiditate)
+DMA_HandleTypeDef hdma_i2c1_rx;
+TIM_HandleTypeDef htim2;
+TIM_HandleTypeDef htim3;
+TIM_HandleTypeDef htim6;
 osThreadId_t gasMonitorTaskHandle;
 osThreadId_t bluetoothTaskHandle;
+osThreadId_t storageTaskHandle;
+osThreadId_t watchdogTaskHandle;
+osThreadId_t diagTaskHandle;
+osThreadId_t modbusTaskHandle;
 osSemaphoreId_t connectionSemaphoreHandle; // Semafor pentru sincronizare
 osMessageQueueId_t bluetoothMessageQueueHandle;
 
+// Buffer pentru cadrele de istoric (static, ca să nu încarce stiva task-ului)
+static uint8_t historyFrame[LINK_FRAME_MAX_PAYLOAD];
+static EventRecord_t eventFrame[LINK_FRAME_MAX_PAYLOAD / sizeof(EventRecord_t)];
+
 int main(void) {
+    // Vectorii în SRAM2 înaintea oricărei întreruperi (RAM_HOT_PATHS)
+    HotPath_Init();
+
     // Inițializare sistem
     HAL_Init();
     SystemClock_Config();
+    Config_Load(); // înainte de periferice: viteza UART vine din configurație
+    Power_Init(); // LSE și RTC; înainte de IWDG (pornirea LSE poate dura) și de LPUART1
     MX_GPIO_Init();
-    MX_USART1_UART_Init();
+    if (config.linkLpuart) {
+        MX_LPUART1_UART_Init();
+    } else {
+        MX_USART1_UART_Init();
+    }
+    MX_DMA_Init();
+    MX_USART2_UART_Init();
+    if (config.modbusAddr != 0) {
+        MX_USART3_UART_Init();
+        Modbus_Init();
+    }
+    if (config.envPeriodMs != 0) {
+        MX_I2C1_Init();
+    }
+    MX_TIM2_Init();
+    MX_TIM3_Init();
+    MX_TIM6_Init();
+    Buzzer_Init();
+    Sensors_Init();
+    Supply_Init();
 
     // Inițializare kernel FreeRTOS
     osKernelInitialize();
+    Config_Init();
+
+    // Jurnalul de evenimente din flash; primul eveniment e cauza resetului
+    FlashIf_Init();
+    EventLog_Init();
+    EventLog_Append(EVT_BOOT, (uint16_t)(RCC->CSR >> 24), 0);
+    LOG("boot: csr=%08x lse=%u", RCC->CSR, (RCC->BDCR & RCC_BDCR_LSERDY) != 0);
+    Watchdog_Init(); // citește și el cauza resetului, înainte de ștergerea flag-urilor
+    CrashDump_Init();
+    Ota_Init(); // imagine în probă sau rollback raportat de bootloader
+    StackGuard_Init(); // după CrashDump_Init, care activează MemManage
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+    Led_Init();
+    Fan_Init(); // după jurnal: pornirile/opririle ventilatorului sunt evenimente
+    Safety_Init(); // după ventilator și buzzer, pe care le comandă direct
+    EnvSensor_Init();
+    SelfTest_Init();
 
     // Inițializare semafor
     const osSemaphoreAttr_t semaphore_attr = {
@@ -51,10 +148,44 @@ int main(void) {
     const osThreadAttr_t bluetoothTaskAttr = {
         .name = "BluetoothTask",
         .priority = osPriorityLow,
-        .stack_size = 128 * 4
+        .stack_size = 192 * 4
     };
     bluetoothTaskHandle = osThreadNew(StartBluetoothTask, NULL, &bluetoothTaskAttr);
 
+    // Creare task pentru scrierile în flash (jurnal de evenimente, configurație)
+    const osThreadAttr_t storageTaskAttr = {
+        .name = "StorageTask",
+        .priority = osPriorityLow,
+        .stack_size = 128 * 4
+    };
+    storageTaskHandle = osThreadNew(StartStorageTask, NULL, &storageTaskAttr);
+
+    // Creare task supervizor (IWDG); prioritate maximă dintre task-uri
+    const osThreadAttr_t watchdogTaskAttr = {
+        .name = "WatchdogTask",
+        .priority = osPriorityHigh,
+        .stack_size = 64 * 4
+    };
+    watchdogTaskHandle = osThreadNew(StartWatchdogTask, NULL, &watchdogTaskAttr);
+
+    // Creare task pentru canalul de diagnostic (USART2): jurnal, statistici, consolă
+    const osThreadAttr_t diagTaskAttr = {
+        .name = "DiagTask",
+        .priority = osPriorityLow,
+        .stack_size = 256 * 4
+    };
+    diagTaskHandle = osThreadNew(StartDiagTask, NULL, &diagTaskAttr);
+
+    // Creare task pentru slave-ul Modbus (USART3), doar dacă are adresă
+    if (Modbus_Enabled()) {
+        const osThreadAttr_t modbusTaskAttr = {
+            .name = "ModbusTask",
+            .priority = osPriorityBelowNormal,
+            .stack_size = 128 * 4
+        };
+        modbusTaskHandle = osThreadNew(StartModbusTask, NULL, &modbusTaskAttr);
+    }
+
     // Trimite mesajul de conexiune reușită la început din Bluetooth task
     osSemaphoreRelease(connectionSemaphoreHandle); // Eliberează semaforul pentru a semnaliza începerea altor task-uri
 
@@ -66,43 +197,143 @@ int main(void) {
     }
 }
 
+// Modelul sonor pentru fiecare nivel de alarmă
+static const BuzzerPatternId_t levelPatterns[] = {
+    [ALARM_NONE] = BUZZER_NONE,
+    [ALARM_WARNING] = BUZZER_WARNING,
+    [ALARM_ALARM] = BUZZER_ALARM,
+};
+
 // Task pentru monitorizarea senzorului de gaz
 void StartGasMonitorTask(void *argument) {
     uint8_t gasAlertMessage[] = "ALERTĂ: Gaz detectat!\r\n";
+    uint8_t gasWarnMessage[] = "Atenție: nivel ridicat.\r\n";
     uint8_t gasClearMessage[] = "Nu sunt detectate gaze.\r\n";
-    GPIO_PinState prevState = GPIO_PIN_RESET;
+    uint8_t battLowMessage[] = "Baterie descărcată.\r\n";
+    GPIO_PinState gasState = HAL_GPIO_ReadPin(GPIOA, GPIO_PIN_0);
+    AlarmLevel_t prevLevel = ALARM_NONE;
+    uint8_t debounceCount = 0;
+    uint8_t safetyTripped = 0;
+    uint32_t watchdogPeriod = 0;
+    uint32_t lastHistoryTick = osKernelGetTickCount();
 
     for (;;) {
-        GPIO_PinState gasState = HAL_GPIO_ReadPin(GPIOA, GPIO_PIN_0);
-
-        if (gasState == GPIO_PIN_SET) {
-            // Gaz absent - aprindem LED-ul verde și stingem LED-ul roșu
-            HAL_GPIO_WritePin(GPIOA, GPIO_PIN_6, GPIO_PIN_SET);  // LED verde
-            HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_RESET); // LED roșu
-            HAL_GPIO_WritePin(GPIOB, GPIO_PIN_2, GPIO_PIN_RESET); // Buzzer
-
-            // Trimite mesajul "clear" către Bluetooth pentru a trimite prin UART
-            if (prevState != gasState) {
-                if (osMessageQueuePut(bluetoothMessageQueueHandle, gasClearMessage, 0, 0) != osOK) {
-                    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET); // LED roșu pentru debug
-                }
+        // Termenul de watchdog urmează perioada buclei (sample_ms din cfg,
+        // sau batt_sample_ms cu bateria descărcată)
+        if (watchdogPeriod != Supply_SamplePeriod()) {
+            watchdogPeriod = Supply_SamplePeriod();
+            Watchdog_Register(WDG_TASK_GAS, 2U * watchdogPeriod + 1000U);
+        }
+        Watchdog_CheckIn(WDG_TASK_GAS);
+
+        GPIO_PinState rawState = HAL_GPIO_ReadPin(GPIOA, GPIO_PIN_0);
+        uint32_t now = osKernelGetTickCount();
+        AlarmLevel_t analogLevel;
+        AlarmLevel_t level;
+        SensorState_t primary;
+        EnvReading_t env;
+        uint16_t ppm;
+
+        // Compensarea MQ-2 cu ultima citire SHT3x, cât timp e recentă
+        if (config.envComp && EnvSensor_Get(&env)) {
+            GasSensor_SetConditions(env.temperature, env.humidity);
+        } else {
+            GasSensor_ClearConditions();
+        }
+        // ADC-ul e pornit o singură dată pe ciclu, pentru secvența tuturor
+        // senzorilor de gaz și, la supply_ms, pentru alimentare și temperatură.
+        // Nivelul fiecărui canal și evenimentele lui vin din Sensors_Scan.
+        Adc_PowerUp();
+        analogLevel = Sensors_Scan(now);
+        Sensors_Get(SENSOR_PRIMARY, &primary);
+        ppm = primary.ppm;
+        if (Supply_Due(now) && Supply_Measure(now)) {
+            SupplyReading_t supply;
+
+            Supply_Get(&supply);
+            LOG("supply: baterie %s vbat=%umV vdda=%umV", supply.lowBattery ? "descarcata" : "ok",
+                supply.vbatMv, supply.vddaMv);
+            EventLog_Append(supply.lowBattery ? EVT_BATTERY_LOW : EVT_BATTERY_OK, supply.vbatMv, supply.vddaMv);
+            if (supply.lowBattery &&
+                osMessageQueuePut(bluetoothMessageQueueHandle, battLowMessage, 0, 0) == osOK) {
+                osThreadFlagsSet(bluetoothTaskHandle, LINK_FLAG_MESSAGE);
+            }
+        }
+        Adc_PowerDown();
+
+        // Starea se schimbă doar după alarmDebounce citiri consecutive diferite
+        if (rawState != gasState) {
+            if (++debounceCount >= config.alarmDebounce) {
+                gasState = rawState;
+                debounceCount = 0;
             }
         } else {
-            // Gaz detectat - aprindem LED-ul roșu și buzzer-ul
-            HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET);  // LED roșu
-            HAL_GPIO_WritePin(GPIOB, GPIO_PIN_2, GPIO_PIN_SET);  // Buzzer
-            HAL_GPIO_WritePin(GPIOA, GPIO_PIN_6, GPIO_PIN_RESET); // LED verde
-
-            // Trimite mesajul "alert" către Bluetooth pentru a trimite prin UART
-            if (prevState != gasState) {
-                if (osMessageQueuePut(bluetoothMessageQueueHandle, gasAlertMessage, 0, 0) != osOK) {
-                    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET); // LED roșu pentru debug
-                }
+            debounceCount = 0;
+        }
+
+        // Nivelul final: comparatorul modulului MQ-2 (DO) forțează alarma,
+        // altfel decide canalul cu nivelul cel mai mare. Cât timp MQ-2 se
+        // încălzește, DO nu e de încredere: calea de siguranță doar ventilează.
+        Safety_SetQuiet(!Baseline_Warm(SENSOR_PRIMARY));
+        level = (gasState == GPIO_PIN_RESET && Baseline_Warm(SENSOR_PRIMARY)) ? ALARM_ALARM : analogLevel;
+
+        // Eșantion în istoric la fiecare historyPeriodMs (concentrația în ppm)
+        if (now - lastHistoryTick >= config.historyPeriodMs) {
+            lastHistoryTick = now;
+            History_Add(now, ppm);
+        }
+
+        // Ventilatorul urmărește concentrația din timerul de control
+        Fan_SetMeasurement(ppm, level);
+        Modbus_Publish(primary.counts, ppm, level, gasState == GPIO_PIN_RESET);
+
+        if (!config.buzzerEnable) {
+            Buzzer_Stop(levelPatterns[level]);
+        }
+
+        // Calea de siguranță a acționat deja din întrerupere; aici doar
+        // raportăm, iar dacă DO a revenit fără să treacă de debounce
+        // (impuls scurt) oprim alarma sonoră pornită de ea
+        if (Safety_TakeTrip()) {
+            SafetyStats_t stats;
+
+            Safety_GetStats(&stats);
+            EventLog_Append(EVT_SAFETY_TRIP, (uint16_t)(stats.lastCycles / (SystemCoreClock / 1000000U)), ppm);
+            safetyTripped = 1;
+        }
+        if (safetyTripped && !Safety_Active() && level != ALARM_ALARM) {
+            Buzzer_Stop(BUZZER_ALARM);
+            safetyTripped = 0;
+        }
+
+        // La schimbarea nivelului: LED-uri și model sonor (rulează apoi
+        // singure, din timer/întreruperi) și mesajul către Bluetooth
+        if (level != prevLevel) {
+            uint8_t *message = gasClearMessage;
+
+            LOG("gas: nivel %u -> %u, %u ppm, DO=%u", prevLevel, level, ppm, gasState == GPIO_PIN_RESET);
+
+            Led_Set(LED_IND_WARNING, level == ALARM_WARNING);
+            Led_Set(LED_IND_ALARM, level == ALARM_ALARM);
+            Buzzer_Stop(levelPatterns[prevLevel]);
+            if (config.buzzerEnable) {
+                Buzzer_Play(levelPatterns[level]);
+            }
+
+            if (level == ALARM_ALARM) {
+                message = gasAlertMessage;
+            } else if (level == ALARM_WARNING) {
+                message = gasWarnMessage;
+            }
+            // Coadă plină: mesajul se pierde, dar evenimentele canalelor (sau
+            // EVT_SAFETY_TRIP, pentru DO) sunt deja în jurnal
+            if (osMessageQueuePut(bluetoothMessageQueueHandle, message, 0, 0) == osOK) {
+                osThreadFlagsSet(bluetoothTaskHandle, LINK_FLAG_MESSAGE);
             }
         }
 
-        prevState = gasState;
-        osDelay(100); // Delay pentru stabilitate
+        prevLevel = level;
+        osDelay(Supply_SamplePeriod()); // Delay pentru stabilitate
     }
 }
 
@@ -113,47 +344,211 @@ void StartBluetoothTask(void *argument) {
     uint8_t fanOnMsg[] = "Ventilatorul a fost pornit.\r\n";
     uint8_t fanOffMsg[] = "Ventilatorul a fost oprit.\r\n";
     uint8_t messageBuffer[32]; // Buffer pentru mesajele din coadă
+    uint8_t streaming = 0;
+    uint32_t streamCursor = 0;
+    uint32_t supplySequence = 0;
+    uint32_t lastRxTick = 0;
+    uint8_t crashPending;
+    char lineBuffer[COMMAND_MAX_LINE];
 
     // Așteaptă semaforul înainte de a trimite mesajul de conexiune
     osSemaphoreAcquire(connectionSemaphoreHandle, osWaitForever);
+    Watchdog_Register(WDG_TASK_BLUETOOTH, 3000U);
 
     // Trimite un mesaj de inițializare (conexiune reușită)
-    HAL_UART_Transmit(&huart1, connectedMsg, strlen((char *)connectedMsg), HAL_MAX_DELAY);
+    HAL_UART_Transmit(linkUart, connectedMsg, strlen((char *)connectedMsg), HAL_MAX_DELAY);
+    if (Watchdog_LastResetMask() != 0) {
+        Link_Print("Reset de watchdog (detalii: $wdg).\r\n");
+    }
+    // Instantaneul căderii anterioare se trimite abia la prima comandă:
+    // până atunci nu e sigur că o gazdă ascultă (HC-05 nu își expune starea)
+    crashPending = CrashDump_Pending();
 
     for (;;) {
+        uint8_t listen = 1;
+        uint8_t pending = 0; // octet primit deja în așteptare
+        uint8_t linkActive;
+        SelfTestReport_t selftestReport;
+        SelfTestPing_t selftestPing;
+
+        Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+
+        // Consum redus, legătură inactivă: interogarea UART-ului ar ține
+        // nucleul treaz, așa că task-ul se blochează până la activitate pe
+        // RX sau un mesaj. Pe USART1 octetul care trezește placa din Stop 2
+        // se pierde; pe LPUART1 e primit în Stop și livrat aici.
+        if (config.lowPower && !streaming && osKernelGetTickCount() - lastRxTick > LINK_IDLE_MS) {
+            uint32_t flags;
+
+            Link_ListenArm();
+            flags = osThreadFlagsWait(LINK_FLAG_RX | LINK_FLAG_MESSAGE | LINK_FLAG_SELFTEST, osFlagsWaitAny,
+                                      LINK_WAIT_MS);
+            pending = Link_ListenDisarm(rxBuffer);
+            listen = pending || ((flags & osFlagsError) == 0 && (flags & LINK_FLAG_RX));
+            Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+        }
+
         // Verifică dacă există un mesaj în coadă
         if (osMessageQueueGet(bluetoothMessageQueueHandle, messageBuffer, NULL, 0) == osOK) {
             // Trimite mesajul prin UART
-            HAL_UART_Transmit(&huart1, messageBuffer, strlen((char *)messageBuffer), HAL_MAX_DELAY);
+            HAL_UART_Transmit(linkUart, messageBuffer, strlen((char *)messageBuffer), HAL_MAX_DELAY);
+        }
+
+        // Autotest: ping-ul pasului de link și raportul final; fără gazdă
+        // conectată pasul de link e sărit, iar raportul rămâne pentru $selftest
+        linkActive = osKernelGetTickCount() - lastRxTick <= LINK_IDLE_MS;
+        if (SelfTest_LinkPoll(linkActive, &selftestPing)) {
+            Link_SendFrame(LINK_FRAME_PING, (const uint8_t *)&selftestPing, sizeof(selftestPing));
+        }
+        if (SelfTest_TakeReport(&selftestReport) && linkActive) {
+            Link_SendFrame(LINK_FRAME_SELFTEST, (const uint8_t *)&selftestReport, sizeof(selftestReport));
+        }
+
+        // Streaming: trimite eșantioanele noi în loturi de câte streamBatch
+        if (streaming && History_Head() - streamCursor >= config.streamBatch) {
+            SendHistory(&streamCursor, LINK_FRAME_STREAM);
+        }
+        // Telemetria alimentării, la fiecare măsurare nouă
+        if (streaming) {
+            SupplyReading_t supply;
+            uint32_t sequence = Supply_Get(&supply);
+
+            if (sequence != supplySequence) {
+                supplySequence = sequence;
+                Link_SendFrame(LINK_FRAME_SUPPLY, (const uint8_t *)&supply, sizeof(supply));
+            }
         }
 
         // Verifică dacă primește date prin UART
-        if (HAL_UART_Receive(&huart1, rxBuffer, 1, 500) == HAL_OK) {
+        if (pending || (listen && HAL_UART_Receive(linkUart, rxBuffer, 1, 500) == HAL_OK)) {
             uint8_t command = rxBuffer[0];
 
+            // Modulul HC-05 nu își expune starea, așa că legătura e
+            // considerată activă cât timp primim comenzi
+            lastRxTick = osKernelGetTickCount();
+            Led_Set(LED_IND_LINK, 1);
+
+            // Cadru binar de la gazdă: sesiune de actualizare a firmware-ului
+            if (command == LINK_FRAME_SYNC) {
+                Ota_Session();
+                lastRxTick = osKernelGetTickCount();
+                continue;
+            }
+
+            // O singură dată, cu gazda conectată ($crash îl retrimite)
+            if (crashPending) {
+                crashPending = 0;
+                Link_Print("Cădere înainte de reset (detalii: $crash).\r\n");
+                CrashDump_Send();
+                CrashDump_MarkReported();
+            }
+
             // Debug: trimite înapoi comanda primită
-            HAL_UART_Transmit(&huart1, rxBuffer, 1, HAL_MAX_DELAY);
+            HAL_UART_Transmit(linkUart, rxBuffer, 1, HAL_MAX_DELAY);
+
+            // Comandă text: restul liniei vine imediat, fără ecou și fără delay
+            if (command == COMMAND_PREFIX) {
+                uint8_t length = 0;
+                while (HAL_UART_Receive(linkUart, rxBuffer, 1, 100) == HAL_OK &&
+                       rxBuffer[0] != '\r' && rxBuffer[0] != '\n') {
+                    Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+                    if (length < sizeof(lineBuffer) - 1) {
+                        lineBuffer[length++] = (char)rxBuffer[0];
+                    }
+                }
+                lineBuffer[length] = '\0';
+                Link_Print("\r\n");
+                Command_Execute(lineBuffer);
+            }
 
             // Control ventilator
             if (command == '1') {
-                HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_SET);  // Pornește ventilatorul
-                HAL_UART_Transmit(&huart1, fanOnMsg, strlen((char *)fanOnMsg), HAL_MAX_DELAY);
+                ControlFan(command); // Pornește ventilatorul (mod manual)
+                HAL_UART_Transmit(linkUart, fanOnMsg, strlen((char *)fanOnMsg), HAL_MAX_DELAY);
             } else if (command == '0') {
-                HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_RESET);  // Oprește ventilatorul
-                HAL_UART_Transmit(&huart1, fanOffMsg, strlen((char *)fanOffMsg), HAL_MAX_DELAY);
+                ControlFan(command); // Oprește ventilatorul (mod manual)
+                HAL_UART_Transmit(linkUart, fanOffMsg, strlen((char *)fanOffMsg), HAL_MAX_DELAY);
+            } else if (command == 'h') {
+                // Descărcare istoric complet, comprimat
+                uint32_t cursor = History_Oldest();
+                SendHistory(&cursor, LINK_FRAME_HISTORY);
+            } else if (command == 'e') {
+                // Descărcare jurnal de evenimente (după scrierea lotului curent)
+                uint32_t cursor = 0;
+                uint32_t count;
+                EventLog_Flush();
+                while ((count = EventLog_Read(&cursor, eventFrame,
+                                              sizeof(eventFrame) / sizeof(eventFrame[0]))) != 0) {
+                    Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+                    Link_SendFrame(LINK_FRAME_EVENTS, (const uint8_t *)eventFrame,
+                                   (uint16_t)(count * sizeof(EventRecord_t)));
+                }
+            } else if (command == 's') {
+                // Pornire/oprire streaming eșantioane
+                streaming = !streaming;
+                streamCursor = History_Head();
             }
         }
 
+        if (osKernelGetTickCount() - lastRxTick > LINK_IDLE_MS) {
+            Led_Set(LED_IND_LINK, 0);
+        }
+
         osDelay(10); // Delay scurt pentru stabilitate
     }
 }
 
-// Funcție pentru controlul ventilatorului
+// Task pentru scrierile în flash: scrie jurnalul când un lot e complet
+// sau, cel târziu, la fiecare EVENT_LOG_FLUSH_MS, salvează configurația
+// după un cfg commit și notează în starea de boot confirmarea imaginii
+// noi (sau încheierea unui rollback)
+void StartStorageTask(void *argument) {
+    // Așteptarea + scrierea unui lot (câteva pagini șterse) încap în termen
+    Watchdog_Register(WDG_TASK_STORAGE, EVENT_LOG_FLUSH_MS + 3000U);
+    Ota_Commit(); // rollback-ul raportat de Ota_Init
+
+    for (;;) {
+        Watchdog_CheckIn(WDG_TASK_STORAGE);
+        uint32_t flags = osThreadFlagsWait(STORAGE_FLAG_EVENTLOG | STORAGE_FLAG_CONFIG | STORAGE_FLAG_FW,
+                                           osFlagsWaitAny, EVENT_LOG_FLUSH_MS);
+
+        if ((flags & osFlagsError) == 0 && (flags & STORAGE_FLAG_CONFIG)) {
+            EventLog_Append(EVT_CONFIG_SAVED, (Config_Save() == 0) ? 1 : 0, 0);
+        }
+        if ((flags & osFlagsError) == 0 && (flags & STORAGE_FLAG_FW)) {
+            Ota_Commit();
+        }
+        EventLog_Flush();
+    }
+}
+
+// Trimite eșantioanele de la *cursor până la capătul istoricului, în cadre
+// independente: fiecare începe cu indexul primului eșantion și poate fi
+// decodat separat pe host (Tools/histdecode.c)
+static void SendHistory(uint32_t *cursor, uint8_t frameType) {
+    for (;;) {
+        uint32_t first;
+        size_t len = History_Encode(cursor, &first, &historyFrame[4], sizeof(historyFrame) - 4);
+
+        if (len == 0) {
+            break;
+        }
+        Watchdog_CheckIn(WDG_TASK_BLUETOOTH); // descărcarea completă durează secunde la 9600
+        historyFrame[0] = (uint8_t)first;
+        historyFrame[1] = (uint8_t)(first >> 8);
+        historyFrame[2] = (uint8_t)(first >> 16);
+        historyFrame[3] = (uint8_t)(first >> 24);
+        Link_SendFrame(frameType, historyFrame, (uint16_t)(len + 4));
+    }
+}
+
+// Funcție pentru controlul ventilatorului: comenzile '1'/'0' trec în mod
+// manual (100% / oprit); revenirea la automat se face cu "$fan auto"
 void ControlFan(uint8_t command) {
     if (command == '1') {
-        HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_SET); // Pornire ventilator
+        Fan_SetManual(100); // Pornire ventilator
     } else if (command == '0') {
-        HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_RESET); // Oprire ventilator
+        Fan_SetManual(0); // Oprire ventilator
     }
 }
 
@@ -165,8 +560,9 @@ void MX_GPIO_Init(void) {
     GPIO_InitTypeDef GPIO_InitStruct = {0};
 
     // Configurare pin PA0 (intrare digitală pentru senzorul MQ-02)
+    // cu întrerupere pe frontul descendent pentru calea de siguranță
     GPIO_InitStruct.Pin = GPIO_PIN_0;
-    GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
     GPIO_InitStruct.Pull = GPIO_PULLDOWN;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
@@ -180,18 +576,13 @@ void MX_GPIO_Init(void) {
     GPIO_InitStruct.Pin = GPIO_PIN_2;
     HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
-    // Configurare pin PB1 pentru ventilator
-    GPIO_InitStruct.Pin = GPIO_PIN_1;
-    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-    GPIO_InitStruct.Pull = GPIO_NOPULL;
-    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-    HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
-
-    // Inițializare LED-uri, buzzer și ventilator (toate stinse)
+    // Inițializare LED-uri și buzzer (toate stinse); LED-urile sunt apoi
+    // comandate doar de serviciul din led.c. PB1 (ventilator) e
+    // configurat ca ieșire PWM în MX_TIM3_Init, iar PB2 e preluat de
+    // Buzzer_Init (LPTIM1_OUT)
     HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_RESET); // LED roșu
     HAL_GPIO_WritePin(GPIOA, GPIO_PIN_6, GPIO_PIN_RESET); // LED verde
     HAL_GPIO_WritePin(GPIOB, GPIO_PIN_2, GPIO_PIN_RESET); // Buzzer
-    HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_RESET); // Ventilator
 }
 
 // Inițializare UART1 pentru Bluetooth
@@ -199,7 +590,7 @@ void MX_USART1_UART_Init(void) {
     __HAL_RCC_USART1_CLK_ENABLE();
 
     huart1.Instance = USART1;
-    huart1.Init.BaudRate = 9600;
+    huart1.Init.BaudRate = config.baudRate;
     huart1.Init.WordLength = UART_WORDLENGTH_8B;
     huart1.Init.StopBits = UART_STOPBITS_1;
     huart1.Init.Parity = UART_PARITY_NONE;
@@ -211,6 +602,169 @@ void MX_USART1_UART_Init(void) {
     }
 }
 
+// Inițializare USART2 (PA2/PA3, VCP-ul ST-LINK) pentru canalul de
+// diagnostic: TX prin DMA (DMA1 canal 7), RX pe întrerupere (consolă)
+void MX_USART2_UART_Init(void) {
+    huart2.Instance = USART2;
+    huart2.Init.BaudRate = config.diagBaud;
+    huart2.Init.WordLength = UART_WORDLENGTH_8B;
+    huart2.Init.StopBits = UART_STOPBITS_1;
+    huart2.Init.Parity = UART_PARITY_NONE;
+    huart2.Init.Mode = UART_MODE_TX_RX;
+    huart2.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    huart2.Init.OverSampling = UART_OVERSAMPLING_16;
+    if (HAL_UART_Init(&huart2) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+// Inițializare USART3 (PC4 TX, PC5 RX, PB14 DE) pentru Modbus RTU pe
+// RS-485: DE comandat de USART, cu timpii de asertare/dezasertare de un bit
+// (16 eșantioane); RX și TX prin DMA (DMA1 canalele 3 și 2)
+void MX_USART3_UART_Init(void) {
+    huart3.Instance = USART3;
+    huart3.Init.BaudRate = config.modbusBaud;
+    huart3.Init.WordLength = (config.modbusParity != 0) ? UART_WORDLENGTH_9B : UART_WORDLENGTH_8B;
+    huart3.Init.StopBits = (config.modbusParity != 0) ? UART_STOPBITS_1 : UART_STOPBITS_2;
+    huart3.Init.Parity = (config.modbusParity == 1) ? UART_PARITY_EVEN :
+                         (config.modbusParity == 2) ? UART_PARITY_ODD : UART_PARITY_NONE;
+    huart3.Init.Mode = UART_MODE_TX_RX;
+    huart3.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    huart3.Init.OverSampling = UART_OVERSAMPLING_16;
+    if (HAL_RS485Ex_Init(&huart3, UART_DE_POLARITY_HIGH, 16, 16) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+// Inițializare I2C1 (PB8 SCL, PB9 SDA) pentru SHT3x: 100 kHz din PCLK1 la
+// 80 MHz, filtrul analogic activ; recepția prin DMA (DMA2 canal 6)
+void MX_I2C1_Init(void) {
+    hi2c1.Instance = I2C1;
+    hi2c1.Init.Timing = 0x10909CEC;
+    hi2c1.Init.OwnAddress1 = 0;
+    hi2c1.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+    hi2c1.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+    hi2c1.Init.OwnAddress2 = 0;
+    hi2c1.Init.OwnAddress2Masks = I2C_OA2_NOMASK;
+    hi2c1.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+    hi2c1.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
+    if (HAL_I2C_Init(&hi2c1) != HAL_OK) {
+        Error_Handler();
+    }
+    if (HAL_I2CEx_ConfigAnalogFilter(&hi2c1, I2C_ANALOGFILTER_ENABLE) != HAL_OK) {
+        Error_Handler();
+    }
+    if (HAL_I2CEx_ConfigDigitalFilter(&hi2c1, 0) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+// Ceasul DMA1 și întreruperile canalelor 7 (USART2_TX), 2 (USART3_TX) și
+// 3 (USART3_RX); DMA2 canal 6 (I2C1_RX: DMA1 canal 7 e ocupat de USART2)
+void MX_DMA_Init(void) {
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    HAL_NVIC_SetPriority(DMA2_Channel6_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Channel6_IRQn);
+
+    HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+    HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+
+    HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+}
+
+// Inițializare LPUART1 pentru Bluetooth (PB10 RX, PB11 TX): rămâne activ în
+// Stop 2 (UESM) și trezește placa la bitul de start, fără să piardă octetul
+void MX_LPUART1_UART_Init(void) {
+    UART_WakeUpTypeDef wakeUp = {0};
+
+    hlpuart1.Instance = LPUART1;
+    hlpuart1.Init.BaudRate = config.baudRate;
+    hlpuart1.Init.WordLength = UART_WORDLENGTH_8B;
+    hlpuart1.Init.StopBits = UART_STOPBITS_1;
+    hlpuart1.Init.Parity = UART_PARITY_NONE;
+    hlpuart1.Init.Mode = UART_MODE_TX_RX;
+    hlpuart1.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    if (HAL_UART_Init(&hlpuart1) != HAL_OK) {
+        Error_Handler();
+    }
+
+    // Potrivirea de adresă nu se folosește: legătura transportă octeți
+    // arbitrari (cadre binare), fără bit de marcaj pentru adresă
+    wakeUp.WakeUpEvent = UART_WAKEUP_ON_STARTBIT;
+    if (HAL_UARTEx_StopModeWakeUpSourceConfig(&hlpuart1, wakeUp) != HAL_OK ||
+        HAL_UARTEx_EnableStopMode(&hlpuart1) != HAL_OK) {
+        Error_Handler();
+    }
+    __HAL_UART_ENABLE_IT(&hlpuart1, UART_IT_WUF);
+    linkUart = &hlpuart1;
+}
+
+// Inițializare TIM2: captură pe CH1 (PA15) pentru turometrul ventilatorului,
+// tact de 1 MHz, numărător pe 32 de biți fără reîncărcare
+void MX_TIM2_Init(void) {
+    TIM_IC_InitTypeDef sConfigIC = {0};
+
+    htim2.Instance = TIM2;
+    htim2.Init.Prescaler = 80000000U / FAN_TACH_TICK_HZ - 1;
+    htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim2.Init.Period = 0xFFFFFFFFU;
+    htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_IC_Init(&htim2) != HAL_OK) {
+        Error_Handler();
+    }
+
+    sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_RISING;
+    sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+    sConfigIC.ICFilter = 0x8; // ieșire open-collector, fronturi lente
+    if (HAL_TIM_IC_ConfigChannel(&htim2, &sConfigIC, TIM_CHANNEL_1) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+// Inițializare TIM3: PWM 25 kHz pe CH4 (PB1) pentru ventilator, pornit la 0%
+void MX_TIM3_Init(void) {
+    TIM_OC_InitTypeDef sConfigOC = {0};
+
+    htim3.Instance = TIM3;
+    htim3.Init.Prescaler = 0;
+    htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim3.Init.Period = FAN_PWM_PERIOD - 1;
+    htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    if (HAL_TIM_PWM_Init(&htim3) != HAL_OK) {
+        Error_Handler();
+    }
+
+    sConfigOC.OCMode = TIM_OCMODE_PWM1;
+    sConfigOC.Pulse = 0;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_PWM_ConfigChannel(&htim3, &sConfigOC, TIM_CHANNEL_4) != HAL_OK) {
+        Error_Handler();
+    }
+    HAL_TIM_MspPostInit(&htim3);
+}
+
+// Inițializare TIM6: baza de timp a secvențelor buzzerului (2 kHz); durata
+// fiecărui pas e scrisă în ARR din întrerupere, deci fără preîncărcare
+void MX_TIM6_Init(void) {
+    htim6.Instance = TIM6;
+    htim6.Init.Prescaler = 80000000U / BUZZER_TICK_HZ - 1;
+    htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim6.Init.Period = 0xFFFF;
+    htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&htim6) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
 // Configurare ceas sistem
 void SystemClock_Config(void) {
     RCC_OscInitTypeDef RCC_OscInitStruct = {0};
@@ -245,8 +799,5 @@ void SystemClock_Config(void) {
 
 // Funcție pentru gestionarea erorilor
 void Error_Handler(void) {
-    while (1) {
-        HAL_GPIO_TogglePin(GPIOA, GPIO_PIN_5); // LED roșu pentru debug
-        HAL_Delay(200);
-    }
+    Led_Halt(LED_IND_FAULT); // indicația de defect, fără întreruperi și fără kernel
 }
@@ -0,0 +1,281 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "modbus.h"
+#include "config.h"
+#include "crc.h"
+#include "fan.h"
+#include "safety.h"
+#include "supply.h"
+#include "env_sensor.h"
+#include "baseline.h"
+#include "selftest.h"
+#include "fw_image.h"
+#include <string.h>
+
+#define FUNC_READ_HOLDING    0x03U
+#define FUNC_READ_INPUT      0x04U
+#define FUNC_WRITE_SINGLE    0x06U
+#define FUNC_WRITE_MULTIPLE  0x10U
+#define HOLDING_COUNT        (2U * CFG_KEY_COUNT)
+
+extern UART_HandleTypeDef huart3;
+extern osThreadId_t modbusTaskHandle;
+
+LiveState_t liveState = {
+    .versionHi = (uint16_t)(FW_VERSION >> 16),
+    .versionLo = (uint16_t)FW_VERSION,
+    .compensation = 1000,
+};
+
+// Registrele de intrare se citesc direct din liveState, după adresă
+_Static_assert(sizeof(LiveState_t) == MODBUS_INPUT_COUNT * sizeof(uint16_t), "LiveState_t: doar câmpuri de 16 biți");
+
+static uint8_t address; // modbus_addr de la pornire
+static uint8_t rxFrame[MODBUS_FRAME_MAX];
+static uint8_t txFrame[MODBUS_FRAME_MAX];
+static volatile uint16_t rxLength;
+static volatile uint32_t lineErrors;
+static ModbusStats_t stats;
+
+static uint16_t GetU16(const uint8_t *data) {
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static void PutU16(uint8_t *data, uint16_t value) {
+    data[0] = (uint8_t)(value >> 8);
+    data[1] = (uint8_t)value;
+}
+
+static HOT_FUNC void StartReceive(void) {
+    HAL_UART_Receive_DMA(&huart3, rxFrame, sizeof(rxFrame));
+}
+
+void Modbus_Init(void) {
+    uint32_t timeout = MODBUS_RTO_BITS;
+
+    // Peste 19200 baud pauza e fixă (1,75 ms), nu 3,5 caractere
+    if (config.modbusBaud > 19200U) {
+        timeout = (MODBUS_RTO_US * config.modbusBaud + 999999U) / 1000000U;
+    }
+    address = config.modbusAddr;
+    HAL_UART_ReceiverTimeout_Config(&huart3, timeout);
+    HAL_UART_EnableReceiverTimeout(&huart3);
+}
+
+uint8_t Modbus_Enabled(void) {
+    return address != 0;
+}
+
+void Modbus_Publish(uint16_t counts, uint16_t ppm, AlarmLevel_t level, uint8_t detector) {
+    SupplyReading_t supply;
+    EnvReading_t env;
+    uint8_t envValid;
+    uint32_t uptime = osKernelGetTickCount() / osKernelGetTickFreq();
+
+    if (!Modbus_Enabled()) {
+        return;
+    }
+    Supply_Get(&supply);
+    envValid = EnvSensor_Get(&env);
+    liveState.ppm = ppm;
+    liveState.counts = counts;
+    liveState.level = level;
+    liveState.detector = detector;
+    liveState.safety = Safety_Active();
+    liveState.fanDuty = Fan_GetDuty();
+    liveState.fanRpm = Fan_GetRpm();
+    liveState.fanMode = Fan_GetMode();
+    liveState.vddaMv = supply.vddaMv;
+    liveState.vbatMv = supply.vbatMv;
+    liveState.temperature = supply.temperature;
+    liveState.lowBattery = supply.lowBattery;
+    liveState.uptimeHi = (uint16_t)(uptime >> 16);
+    liveState.uptimeLo = (uint16_t)uptime;
+    liveState.ambientTemp = envValid ? env.temperature : 0;
+    liveState.ambientRh = envValid ? env.humidity : 0;
+    liveState.compensation = GasSensor_Compensation();
+    liveState.selftest = SelfTest_Summary();
+    liveState.warmMask = 0;
+    for (uint8_t i = 0; i < Sensors_Count(); i++) {
+        SensorState_t channel;
+
+        Sensors_Get(i, &channel);
+        liveState.channelPpm[i] = channel.ppm;
+        liveState.channelLevel[i] = channel.level;
+        liveState.warmMask |= (uint16_t)(Baseline_Warm(i) << i);
+    }
+}
+
+// Sfârșitul recepției: RTO (pauza de 3,5 caractere) sau o eroare de linie;
+// în ambele cazuri HAL a oprit deja DMA-ul, iar contorul lui dă lungimea
+HOT_FUNC void Modbus_RxEndCallback(uint32_t errorCode) {
+    uint16_t length = (uint16_t)(sizeof(rxFrame) - __HAL_DMA_GET_COUNTER(huart3.hdmarx));
+
+    if ((errorCode & ~HAL_UART_ERROR_RTO) != 0U) {
+        lineErrors++;
+        StartReceive();
+    } else if (length < 4U || modbusTaskHandle == NULL) {
+        StartReceive();
+    } else {
+        // Recepția rămâne oprită până la răspuns: magistrala e half-duplex
+        rxLength = length;
+        osThreadFlagsSet(modbusTaskHandle, MODBUS_FLAG_FRAME);
+    }
+}
+
+// Bufferul s-a umplut fără pauză: nu e un cadru Modbus valid
+HOT_FUNC void Modbus_RxFullCallback(void) {
+    lineErrors++;
+    StartReceive();
+}
+
+HOT_FUNC void Modbus_TxCallback(void) {
+    StartReceive();
+}
+
+static uint16_t ReadHolding(uint16_t reg) {
+    uint32_t value = Config_Get((uint8_t)(reg / 2U));
+
+    return (reg & 1U) ? (uint16_t)value : (uint16_t)(value >> 16);
+}
+
+// Valoarea cheii după scrierea registrelor start..start+count-1 care îi
+// aparțin; cealaltă jumătate vine din configurația activă
+static uint32_t MergeKey(uint8_t key, uint16_t start, uint16_t count, const uint8_t *data) {
+    uint32_t value = Config_Get(key);
+
+    for (uint16_t half = 0; half < 2U; half++) {
+        uint16_t reg = (uint16_t)(2U * key + half);
+
+        if (reg >= start && reg < start + count) {
+            uint16_t word = GetU16(&data[2U * (reg - start)]);
+
+            value = half ? ((value & 0xFFFF0000UL) | word) : ((value & 0x0000FFFFUL) | ((uint32_t)word << 16));
+        }
+    }
+    return value;
+}
+
+// Cheile atinse se aplică împreună sau deloc, direct în configurația
+// activă: modificările $cfg neaplicate rămân în copia de lucru, iar
+// valorile rescrise neschimbate nu ajung în flash
+static int WriteHolding(uint16_t start, uint16_t count, const uint8_t *data) {
+    uint8_t first = (uint8_t)(start / 2U);
+    uint8_t last = (uint8_t)((start + count - 1U) / 2U);
+    static uint32_t values[CFG_KEY_COUNT]; // doar ModbusTask; stiva e mică
+
+    for (uint8_t key = first; key <= last; key++) {
+        values[key - first] = MergeKey(key, start, count, data);
+    }
+    return Config_Apply(first, (uint8_t)(last - first + 1U), values);
+}
+
+// Execută PDU-ul (funcție + date) și scrie răspunsul în reply; întoarce
+// lungimea răspunsului sau -ModbusException_t
+static int Execute(const uint8_t *pdu, uint16_t length, uint8_t *reply) {
+    const uint16_t *inputs = (const uint16_t *)&liveState;
+    uint16_t start = (length >= 5U) ? GetU16(&pdu[1]) : 0U;
+    uint16_t count = (length >= 5U) ? GetU16(&pdu[3]) : 0U;
+
+    switch (pdu[0]) {
+    case FUNC_READ_HOLDING:
+    case FUNC_READ_INPUT: {
+        uint16_t limit = (pdu[0] == FUNC_READ_INPUT) ? MODBUS_INPUT_COUNT : HOLDING_COUNT;
+
+        if (length != 5U || count == 0 || count > MODBUS_MAX_READ) {
+            return -MODBUS_EX_VALUE;
+        }
+        if ((uint32_t)start + count > limit) {
+            return -MODBUS_EX_ADDRESS;
+        }
+        reply[1] = (uint8_t)(2U * count);
+        for (uint16_t i = 0; i < count; i++) {
+            PutU16(&reply[2U + 2U * i],
+                   (pdu[0] == FUNC_READ_INPUT) ? inputs[start + i] : ReadHolding((uint16_t)(start + i)));
+        }
+        return 2 + 2 * count;
+    }
+    case FUNC_WRITE_SINGLE:
+        if (length != 5U) {
+            return -MODBUS_EX_VALUE;
+        }
+        if (start >= HOLDING_COUNT) {
+            return -MODBUS_EX_ADDRESS;
+        }
+        if (WriteHolding(start, 1, &pdu[3]) != 0) {
+            return -MODBUS_EX_VALUE;
+        }
+        memcpy(&reply[1], &pdu[1], 4);
+        return 5;
+    case FUNC_WRITE_MULTIPLE:
+        if (length < 6U || count == 0 || count > MODBUS_MAX_WRITE || pdu[5] != 2U * count ||
+            length != 6U + pdu[5]) {
+            return -MODBUS_EX_VALUE;
+        }
+        if ((uint32_t)start + count > HOLDING_COUNT) {
+            return -MODBUS_EX_ADDRESS;
+        }
+        if (WriteHolding(start, count, &pdu[6]) != 0) {
+            return -MODBUS_EX_VALUE;
+        }
+        memcpy(&reply[1], &pdu[1], 4);
+        return 5;
+    default:
+        return -MODBUS_EX_FUNCTION;
+    }
+}
+
+// Întoarce lungimea răspunsului din txFrame; 0 = fără răspuns (CRC greșit,
+// altă adresă sau difuzare)
+static uint16_t Process(uint16_t length) {
+    uint16_t crc;
+    int result;
+
+    if (Crc16_Modbus(rxFrame, length - 2U) != (rxFrame[length - 2U] | (rxFrame[length - 1U] << 8))) {
+        stats.crcErrors++;
+        return 0;
+    }
+    stats.frames++;
+    if (rxFrame[0] != address && rxFrame[0] != 0) {
+        return 0;
+    }
+
+    txFrame[1] = rxFrame[1];
+    result = Execute(&rxFrame[1], (uint16_t)(length - 3U), &txFrame[1]);
+    if (rxFrame[0] == 0) {
+        return 0; // difuzare: scrierile se execută, fără răspuns
+    }
+    if (result < 0) {
+        stats.exceptions++;
+        txFrame[1] = (uint8_t)(rxFrame[1] | 0x80U);
+        txFrame[2] = (uint8_t)-result;
+        result = 2;
+    }
+    txFrame[0] = address;
+    crc = Crc16_Modbus(txFrame, 1U + (uint16_t)result);
+    txFrame[1 + result] = (uint8_t)crc;
+    txFrame[2 + result] = (uint8_t)(crc >> 8);
+    return (uint16_t)(3 + result);
+}
+
+void Modbus_GetStats(ModbusStats_t *out) {
+    *out = stats;
+    out->lineErrors = lineErrors;
+}
+
+void StartModbusTask(void *argument) {
+    (void)argument;
+
+    StartReceive();
+    for (;;) {
+        uint16_t length;
+
+        osThreadFlagsWait(MODBUS_FLAG_FRAME, osFlagsWaitAny, osWaitForever);
+        length = Process(rxLength);
+        if (length != 0 && HAL_UART_Transmit_DMA(&huart3, txFrame, length) == HAL_OK) {
+            stats.replies++;
+        } else {
+            StartReceive();
+        }
+    }
+}
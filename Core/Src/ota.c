@@ -0,0 +1,347 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "ota.h"
+#include "fw_image.h"
+#include "flash_if.h"
+#include "crc.h"
+#include "link.h"
+#include "watchdog.h"
+#include "event_log.h"
+#include "logger.h"
+#include "selftest.h"
+#include <string.h>
+
+#define OTA_POLL_MS        100U  // așteptarea unui cadru nou între verificările de watchdog
+#define OTA_RESET_DELAY_MS 200U  // confirmarea și jurnalul pleacă înainte de reset
+
+extern osThreadId_t storageTaskHandle;
+extern UART_HandleTypeDef *linkUart;
+
+// Antetul imaginii, la începutul slotului (secțiunea .fw_header din
+// STM32L452RETXP_FLASH.ld); dimensiunea și CRC-ul le scrie Tools/fwpack.c
+__attribute__((section(".fw_header"), used)) const FwImageHeader_t fwHeader = {
+    .magic = FW_IMAGE_MAGIC,
+    .version = FW_VERSION,
+};
+
+// + completarea ultimului bloc până la un double-word
+static uint8_t otaFrame[OTA_FRAME_MAX + 8U] __attribute__((aligned(8)));
+static FwState_t bootState;
+static uint32_t imageSize;
+static uint32_t nextOffset;
+static uint32_t rejectedFrames;
+static uint8_t sessionOpen;
+static uint8_t seqReported;
+static uint8_t trial;
+static uint32_t healthyMs;
+static volatile uint8_t commitPending; // FW_REC_CONFIRM / FW_REC_CLOSED, 0 = nimic
+
+static const char *const phaseNames[] = {
+    [FW_PHASE_IDLE] = "activa",
+    [FW_PHASE_INSTALLING] = "instalare",
+    [FW_PHASE_INSTALLED] = "instalata",
+    [FW_PHASE_TRIAL] = "proba",
+    [FW_PHASE_REVERTING] = "revenire",
+    [FW_PHASE_REVERTED] = "revenita",
+};
+
+void Ota_Init(void) {
+    FwImageHeader_t header;
+
+    FwState_Scan((const FwStateRecord_t *)FW_STATE_ADDR, FW_STATE_RECORDS, &bootState);
+    if (bootState.phase == FW_PHASE_TRIAL) {
+        trial = 1;
+        LOG("ota: imaginea %08x in proba, confirmare dupa %u ms", fwHeader.version, OTA_TRIAL_MS);
+    } else if (bootState.phase == FW_PHASE_REVERTED) {
+        // Imaginea respinsă a rămas în staging
+        uint32_t rejected = (FwImage_Check(FW_STAGING_ADDR, &header) == 0) ? header.version : 0;
+
+        EventLog_Append(EVT_FW_ROLLBACK, (uint16_t)(rejected >> 16), (uint16_t)(fwHeader.version >> 16));
+        LOG("ota: rollback, imaginea %08x nu s-a confirmat", rejected);
+        commitPending = FW_REC_CLOSED;
+    }
+}
+
+static void SendAck(uint8_t status) {
+    OtaAck_t ack = {
+        .status = status,
+        .window = OTA_WINDOW,
+        .blockSize = OTA_BLOCK_SIZE,
+        .nextOffset = nextOffset,
+    };
+
+    Link_SendFrame(LINK_FRAME_OTA_ACK, (const uint8_t *)&ack, sizeof(ack));
+}
+
+// Timpul de transfer al len octeți pe link, plus o marjă
+static uint32_t TransferMs(uint32_t len) {
+    return len * 10U * 1000U / linkUart->Init.BaudRate + OTA_POLL_MS;
+}
+
+// Un cadru complet în otaFrame; synced = octetul de sincronizare e deja citit
+static int ReadFrame(uint8_t synced, uint8_t *type, uint16_t *len) {
+    uint8_t header[3];
+    uint8_t trailer[2];
+    uint8_t sync = LINK_FRAME_SYNC;
+
+    if (!synced && (Link_RxRead(&sync, 1, OTA_POLL_MS) != 1 || sync != LINK_FRAME_SYNC)) {
+        return -1;
+    }
+    if (Link_RxRead(header, sizeof(header), TransferMs(sizeof(header))) != sizeof(header)) {
+        return -1;
+    }
+    *type = header[0];
+    *len = (uint16_t)(header[1] | (header[2] << 8));
+    if (*len > OTA_FRAME_MAX || Link_RxRead(otaFrame, *len, TransferMs(*len)) != *len ||
+        Link_RxRead(trailer, sizeof(trailer), TransferMs(sizeof(trailer))) != sizeof(trailer) ||
+        Crc16_Update(Crc16(header, sizeof(header)), otaFrame, *len) != (trailer[0] | (trailer[1] << 8))) {
+        rejectedFrames++;
+        return -1;
+    }
+    return 0;
+}
+
+static void HandleBegin(uint16_t len) {
+    OtaBegin_t begin;
+    uint32_t pages;
+
+    sessionOpen = 0;
+    nextOffset = 0;
+    if (len != sizeof(begin)) {
+        SendAck(OTA_ERR_SIZE);
+        return;
+    }
+    memcpy(&begin, otaFrame, sizeof(begin));
+    // În probă, staging-ul ține imaginea de rezervă: nu se suprascrie
+    if (trial || (bootState.phase != FW_PHASE_IDLE && bootState.phase != FW_PHASE_REVERTED)) {
+        SendAck(OTA_ERR_STATE);
+        return;
+    }
+    if (begin.imageSize <= FW_HEADER_SIZE || begin.imageSize > FW_SLOT_SIZE) {
+        SendAck(OTA_ERR_SIZE);
+        return;
+    }
+
+    // Câte o sesiune flash pe pagină: jurnalul și configurația nu așteaptă
+    // toată ștergerea (~22 ms pe pagină)
+    pages = (begin.imageSize + FW_PAGE_SIZE - 1U) / FW_PAGE_SIZE;
+    for (uint32_t i = 0; i < pages; i++) {
+        HAL_StatusTypeDef status;
+
+        Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+        FlashIf_Begin();
+        status = FlashIf_ErasePage(FW_STAGING_ADDR + i * FW_PAGE_SIZE);
+        FlashIf_End();
+        if (status != HAL_OK) {
+            SendAck(OTA_ERR_FLASH);
+            return;
+        }
+    }
+    imageSize = begin.imageSize;
+    sessionOpen = 1;
+    seqReported = 0;
+    LOG("ota: inceput, %u octeti", imageSize);
+    SendAck(OTA_OK);
+}
+
+static void HandleData(uint16_t len) {
+    uint32_t offset;
+    uint32_t count = (uint32_t)len - 4U;
+    uint32_t padded;
+    HAL_StatusTypeDef status;
+
+    if (!sessionOpen) {
+        SendAck(OTA_ERR_STATE);
+        return;
+    }
+    if (len <= 4U) {
+        SendAck(OTA_ERR_SIZE);
+        return;
+    }
+    memcpy(&offset, otaFrame, sizeof(offset));
+    // Go-back-N: blocurile de după unul pierdut sunt ignorate; gazda reia
+    // de la nextOffset la primul răspuns OTA_ERR_SEQ
+    if (offset != nextOffset) {
+        if (!seqReported) {
+            seqReported = 1;
+            SendAck(OTA_ERR_SEQ);
+        }
+        return;
+    }
+    if (offset + count > imageSize || (count % 8U != 0 && offset + count != imageSize)) {
+        SendAck(OTA_ERR_SIZE);
+        return;
+    }
+
+    padded = (count + 7U) & ~7U;
+    memset(&otaFrame[4U + count], 0xFF, padded - count);
+    FlashIf_Begin();
+    status = FlashIf_Program(FW_STAGING_ADDR + offset, &otaFrame[4], padded);
+    FlashIf_End();
+    if (status != HAL_OK) {
+        SendAck(OTA_ERR_FLASH);
+        return;
+    }
+    nextOffset += count;
+    seqReported = 0;
+    SendAck(OTA_OK);
+}
+
+// Starea de boot se șterge la fiecare instalare: ciclul anterior s-a
+// încheiat (confirmat sau revenit), altfel BEGIN ar fi fost refuzat
+static int RequestInstall(uint32_t pages) {
+    FwStateRecord_t record = { FW_STATE_MAGIC, FW_REC_INSTALL, 0, pages };
+    HAL_StatusTypeDef status = HAL_OK;
+
+    FlashIf_Begin();
+    for (uint32_t addr = FW_STATE_ADDR; addr < FW_STATE_ADDR + FW_STATE_SIZE && status == HAL_OK;
+         addr += FW_PAGE_SIZE) {
+        status = FlashIf_ErasePage(addr);
+    }
+    if (status == HAL_OK) {
+        status = FlashIf_Program(FW_STATE_ADDR, &record, sizeof(record));
+    }
+    FlashIf_End();
+    return (status == HAL_OK) ? 0 : -1;
+}
+
+static void HandleEnd(void) {
+    FwImageHeader_t header;
+    uint32_t pages;
+
+    if (!sessionOpen || nextOffset != imageSize) {
+        SendAck(sessionOpen ? OTA_ERR_SEQ : OTA_ERR_STATE);
+        return;
+    }
+    sessionOpen = 0;
+    if (FwImage_Check(FW_STAGING_ADDR, &header) != 0 || FW_HEADER_SIZE + header.imageSize != imageSize ||
+        FwImage_Verify(FW_STAGING_ADDR) != 0) {
+        LOG("ota: imagine respinsa la verificare");
+        SendAck(OTA_ERR_VERIFY);
+        return;
+    }
+    // Se schimbă și paginile imaginii curente care depășesc imaginea nouă:
+    // la rollback, cea veche trebuie să se întoarcă întreagă
+    pages = FwImage_Pages(FW_APP_ADDR);
+    if (FwImage_Pages(FW_STAGING_ADDR) > pages) {
+        pages = FwImage_Pages(FW_STAGING_ADDR);
+    }
+    if (RequestInstall(pages) != 0) {
+        SendAck(OTA_ERR_FLASH);
+        return;
+    }
+
+    SendAck(OTA_OK);
+    EventLog_Append(EVT_FW_STAGED, (uint16_t)(header.version >> 16), (uint16_t)pages);
+    EventLog_Flush();
+    LOG("ota: imaginea %08x verificata, reset pentru instalare (%u pagini)", header.version, pages);
+    osDelay(OTA_RESET_DELAY_MS);
+    NVIC_SystemReset();
+}
+
+void Ota_Session(void) {
+    uint32_t lastFrame = osKernelGetTickCount();
+    uint8_t synced = 1;
+
+    Link_RxStart();
+    while (osKernelGetTickCount() - lastFrame < OTA_IDLE_MS) {
+        uint8_t type;
+        uint16_t len;
+
+        Watchdog_CheckIn(WDG_TASK_BLUETOOTH);
+        if (ReadFrame(synced, &type, &len) != 0) {
+            synced = 0;
+            continue;
+        }
+        synced = 0;
+        lastFrame = osKernelGetTickCount();
+
+        if (type == LINK_FRAME_OTA_BEGIN) {
+            HandleBegin(len);
+        } else if (type == LINK_FRAME_OTA_DATA) {
+            HandleData(len);
+        } else if (type == LINK_FRAME_OTA_END) {
+            HandleEnd();
+        } else if (type == LINK_FRAME_PONG) {
+            // Răspunsul la ping-ul autotestului vine singur: sesiunea se închide
+            SelfTest_Pong(otaFrame, len);
+            break;
+        }
+    }
+    Link_RxStop();
+    if (sessionOpen) {
+        sessionOpen = 0;
+        LOG("ota: sesiune abandonata la %u/%u octeti", nextOffset, imageSize);
+    }
+}
+
+// Sănătatea imaginii în probă: WatchdogTask reîmprospătează IWDG doar cât
+// toate task-urile supravegheate se anunță la timp, deci OTA_TRIAL_MS de
+// reîmprospătări înseamnă că imaginea nouă funcționează
+void Ota_HealthTick(uint32_t elapsedMs) {
+    if (!trial || commitPending != 0) {
+        return;
+    }
+    healthyMs += elapsedMs;
+    if (healthyMs >= OTA_TRIAL_MS) {
+        commitPending = FW_REC_CONFIRM;
+        osThreadFlagsSet(storageTaskHandle, STORAGE_FLAG_FW);
+    }
+}
+
+void Ota_Commit(void) {
+    FwStateRecord_t record = { FW_STATE_MAGIC, commitPending, 0, 0 };
+    HAL_StatusTypeDef status;
+
+    if (commitPending == 0 || bootState.used >= FW_STATE_RECORDS) {
+        return;
+    }
+    FlashIf_Begin();
+    status = FlashIf_Program(FW_STATE_ADDR + bootState.used * sizeof(FwStateRecord_t), &record,
+                             sizeof(record));
+    FlashIf_End();
+    bootState.used++; // și la eroare: slotul poate fi programat pe jumătate
+
+    if (status == HAL_OK) {
+        if (commitPending == FW_REC_CONFIRM) {
+            EventLog_Append(EVT_FW_CONFIRMED, (uint16_t)(fwHeader.version >> 16), 0);
+            LOG("ota: imaginea %08x confirmata", fwHeader.version);
+            trial = 0;
+        }
+        bootState.phase = FW_PHASE_IDLE;
+        commitPending = 0;
+    }
+}
+
+static void PrintVersion(uint32_t version) {
+    Link_PrintU32(version >> 24);
+    Link_Print(".");
+    Link_PrintU32((version >> 16) & 0xFFU);
+    Link_Print(".");
+    Link_PrintU32(version & 0xFFFFU);
+}
+
+void Ota_PrintStatus(void) {
+    FwImageHeader_t header;
+
+    Link_Print("versiune=");
+    PrintVersion(fwHeader.version);
+    Link_Print(" faza=");
+    Link_Print(phaseNames[bootState.phase]);
+    if (trial) {
+        Link_Print(" proba=");
+        Link_PrintU32(healthyMs / 1000U);
+        Link_Print("/");
+        Link_PrintU32(OTA_TRIAL_MS / 1000U);
+        Link_Print("s");
+    }
+    Link_Print(" staging=");
+    if (FwImage_Check(FW_STAGING_ADDR, &header) != 0) {
+        Link_Print("gol");
+    } else {
+        PrintVersion(header.version);
+    }
+    Link_Print(" respinse=");
+    Link_PrintU32(rejectedFrames);
+    Link_Print("\r\n");
+}
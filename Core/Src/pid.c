@@ -0,0 +1,79 @@
+#include "pid.h"
+#include "sections.h"
+
+static int32_t Clamp(int32_t value, int32_t min, int32_t max) {
+    return (value < min) ? min : (value > max) ? max : value;
+}
+
+void Pid_Init(Pid_t *pid, uint32_t periodMs, int32_t outMin, int32_t outMax, uint8_t reverse) {
+    pid->kp = 0;
+    pid->ki = 0;
+    pid->kd = 0;
+    pid->outMin = outMin;
+    pid->outMax = outMax;
+    pid->rateLimit = 0;
+    pid->periodMs = periodMs;
+    pid->reverse = reverse;
+    Pid_Reset(pid, 0, outMin);
+}
+
+void Pid_Configure(Pid_t *pid, int32_t kp, int32_t ki, int32_t kd, int32_t rateLimit) {
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->rateLimit = rateLimit;
+}
+
+void Pid_Reset(Pid_t *pid, int32_t measurement, int32_t output) {
+    output = Clamp(output, pid->outMin, pid->outMax);
+    pid->integrator = output * (1 << PID_Q);
+    pid->prevMeasurement = measurement;
+    pid->output = output;
+}
+
+// Corpul comun al Pid_Update (SRAM2) și Pid_UpdateFlash
+static inline __attribute__((always_inline)) int32_t Update(Pid_t *pid, int32_t setpoint, int32_t measurement) {
+    int32_t error = pid->reverse ? measurement - setpoint : setpoint - measurement;
+    int32_t delta = pid->reverse ? measurement - pid->prevMeasurement
+                                 : pid->prevMeasurement - measurement;
+    int32_t previousIntegrator = pid->integrator;
+    int32_t output;
+    int32_t limited;
+
+    // Termenul I în Q8.8; produsul trece de 32 de biți la erori mari
+    pid->integrator += (int32_t)((int64_t)pid->ki * error * (int32_t)pid->periodMs / 1000);
+    pid->integrator = Clamp(pid->integrator, pid->outMin * (1 << PID_Q), pid->outMax * (1 << PID_Q));
+
+    output = (int32_t)(((int64_t)pid->kp * error +
+                        (int64_t)pid->kd * delta * 1000 / (int32_t)pid->periodMs +
+                        pid->integrator) >> PID_Q);
+
+    limited = Clamp(output, pid->outMin, pid->outMax);
+    if (pid->rateLimit != 0) {
+        limited = Clamp(limited, pid->output - pid->rateLimit, pid->output + pid->rateLimit);
+    }
+
+    // Integrare condiționată: ieșirea nu poate urma eroarea, deci nu acumulăm
+    if ((limited < output && error > 0) || (limited > output && error < 0)) {
+        pid->integrator = previousIntegrator;
+    }
+
+    pid->prevMeasurement = measurement;
+    pid->output = limited;
+    return limited;
+}
+
+HOT_FUNC int32_t Pid_Update(Pid_t *pid, int32_t setpoint, int32_t measurement) {
+    return Update(pid, setpoint, measurement);
+}
+
+int32_t Pid_UpdateFlash(Pid_t *pid, int32_t setpoint, int32_t measurement) {
+    return Update(pid, setpoint, measurement);
+}
+
+void Pid_Track(Pid_t *pid, int32_t applied) {
+    applied = Clamp(applied, pid->outMin, pid->outMax);
+    pid->integrator += (applied - pid->output) * (1 << PID_Q);
+    pid->integrator = Clamp(pid->integrator, pid->outMin * (1 << PID_Q), pid->outMax * (1 << PID_Q));
+    pid->output = applied;
+}
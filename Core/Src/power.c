@@ -0,0 +1,344 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "power.h"
+#include "config.h"
+#include "fan.h"
+#include "buzzer.h"
+#include "link.h"
+#include "logger.h"
+#include "modbus.h"
+#include "env_sensor.h"
+
+#define POWER_LSE_TIMEOUT_MS 1000U
+#define RTC_PREDIV_A         7U    // ck_apre = RTCCLK / 8 (4096 Hz pe LSE)
+#define RTC_WAKEUP_DIV       16U   // WUCKSEL = 0: RTCCLK / 16
+#define LINK_RX_PIN          GPIO_PIN_7 // USART1_RX (PB7)
+#define SECONDS_PER_DAY      86400U
+
+extern osThreadId_t bluetoothTaskHandle;
+
+static uint32_t rtcHz;          // 0 dacă RTC nu are ceas: fără Stop
+static uint32_t subsecondHz;    // rezoluția SSR
+static volatile PowerStats_t stats;
+// Numărate în unitățile ceasului care le măsoară, convertite la citire
+static volatile uint64_t sleepCycles;   // cicluri de nucleu în WFI
+static volatile uint64_t stopUnits;     // unități de 1/subsecondHz s în Stop 2
+static volatile uint32_t statsStartTick;
+
+#if POWER_TRACE
+#define TRACE(level) (GPIOB->BSRR = (level) ? GPIO_PIN_13 : (GPIO_PIN_13 << 16))
+#else
+#define TRACE(level) ((void)0)
+#endif
+
+static void RtcUnlock(void) {
+    RTC->WPR = 0xCAU;
+    RTC->WPR = 0x53U;
+}
+
+static void RtcLock(void) {
+    RTC->WPR = 0xFFU;
+}
+
+// RTC pornit de la 00:00:00, cu SSR citit direct (BYPSHAD): folosit doar ca
+// ceas care merge și în Stop 2, pentru a măsura cât a dormit placa
+static void RtcInit(void) {
+    RtcUnlock();
+    RTC->ISR |= RTC_ISR_INIT;
+    while ((RTC->ISR & RTC_ISR_INITF) == 0) {
+    }
+    // Cele două câmpuri ale PRER se scriu separat
+    RTC->PRER = subsecondHz - 1U;
+    RTC->PRER |= RTC_PREDIV_A << RTC_PRER_PREDIV_A_Pos;
+    RTC->TR = 0;
+    RTC->CR = RTC_CR_BYPSHAD;
+    RTC->ISR &= ~RTC_ISR_INIT;
+    RtcLock();
+}
+
+static uint32_t Bcd(uint32_t value) {
+    return (value >> 4) * 10U + (value & 0x0FU);
+}
+
+// Timpul din zi, în unități de 1/subsecondHz s
+static uint32_t RtcNow(void) {
+    uint32_t tr;
+    uint32_t ssr;
+    uint32_t seconds;
+
+    // Fără umbrire, TR se poate schimba între cele două citiri
+    do {
+        tr = RTC->TR;
+        ssr = RTC->SSR;
+    } while (tr != RTC->TR);
+
+    seconds = Bcd((tr & (RTC_TR_HT | RTC_TR_HU)) >> RTC_TR_HU_Pos) * 3600U +
+              Bcd((tr & (RTC_TR_MNT | RTC_TR_MNU)) >> RTC_TR_MNU_Pos) * 60U +
+              Bcd(tr & (RTC_TR_ST | RTC_TR_SU));
+    return seconds * subsecondHz + (subsecondHz - 1U - ssr);
+}
+
+static uint32_t RtcElapsed(uint32_t start) {
+    uint32_t day = SECONDS_PER_DAY * subsecondHz;
+
+    return (RtcNow() + day - start) % day;
+}
+
+static void WakeupTimerStart(uint32_t ms) {
+    RtcUnlock();
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    while ((RTC->ISR & RTC_ISR_WUTWF) == 0) {
+    }
+    RTC->WUTR = ms * (rtcHz / RTC_WAKEUP_DIV) / 1000U - 1U;
+    RTC->ISR = ~(RTC_ISR_WUTF | RTC_ISR_INIT) | (RTC->ISR & RTC_ISR_INIT);
+    EXTI->PR1 = EXTI_PR1_PIF20;
+    RTC->CR |= RTC_CR_WUTE | RTC_CR_WUTIE;
+    RtcLock();
+}
+
+static void WakeupTimerStop(void) {
+    RtcUnlock();
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    RtcLock();
+}
+
+// Trezirea e pe HSI16 (STOPWUCK); PLL-ul își păstrează configurația
+// din SystemClock_Config și doar se repornește
+static void RestoreClock(void) {
+    RCC->CR |= RCC_CR_PLLON;
+    while ((RCC->CR & RCC_CR_PLLRDY) == 0) {
+    }
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+    }
+}
+
+// Cu întreruperile încă mascate, flag-urile arată cine a trezit placa
+static PowerWake_t WakeSource(void) {
+    if (EXTI->PR1 & GPIO_PIN_0) {
+        return POWER_WAKE_GAS;
+    }
+    if ((EXTI->PR1 & LINK_RX_PIN) || NVIC_GetPendingIRQ(LPUART1_IRQn)) {
+        return POWER_WAKE_LINK;
+    }
+    if (RTC->ISR & RTC_ISR_WUTF) {
+        return POWER_WAKE_RTC;
+    }
+    return POWER_WAKE_OTHER;
+}
+
+// Sleep cronometrat cu SysTick: COUNTFLAG (șters la citirea CTRL) arată
+// dacă numărătorul a trecut prin zero cât timp nucleul a dormit. Tick-ul
+// care trezește nucleul se tratează abia după __enable_irq, deci există
+// cel mult o trecere prin zero.
+static void SleepTimed(void) {
+    uint32_t val0;
+    uint32_t val1;
+    uint32_t cycles;
+
+    __disable_irq();
+    (void)SysTick->CTRL;
+    val0 = SysTick->VAL;
+    __DSB();
+    __WFI();
+    val1 = SysTick->VAL;
+    cycles = val0 - val1;
+    if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) {
+        cycles += SysTick->LOAD + 1U;
+    }
+    sleepCycles += cycles;
+    __enable_irq();
+}
+
+static uint8_t StopAllowed(void) {
+    // USART2 (ceas PCLK1) se oprește în Stop 2: transferul DMA al jurnalului
+    // de diagnostic trebuie să se termine înainte. USART3 nu recepționează
+    // în Stop 2: cu slave-ul Modbus activ rămâne doar Sleep. La fel I2C1,
+    // doar cât durează un transfer cu SHT3x.
+    return config.lowPower && rtcHz != 0 && !Fan_Running() && Buzzer_Current() == BUZZER_NONE &&
+           !Logger_Busy() && !Modbus_Enabled() && !EnvSensor_Busy();
+}
+
+void Power_Init(void) {
+    uint32_t start;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_RCC_RTCAPB_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    // LSE rămâne pornit peste reset (domeniul de backup): se așteaptă doar
+    // la punerea sub tensiune
+    if ((RCC->BDCR & RCC_BDCR_LSERDY) == 0) {
+        RCC->BDCR |= RCC_BDCR_LSEON;
+        start = HAL_GetTick();
+        while ((RCC->BDCR & RCC_BDCR_LSERDY) == 0 && HAL_GetTick() - start < POWER_LSE_TIMEOUT_MS) {
+        }
+    }
+    stats.lse = (RCC->BDCR & RCC_BDCR_LSERDY) != 0;
+
+    // Sursa RTC se poate alege o singură dată; schimbarea ar cere resetul
+    // domeniului de backup, care ar șterge și raportul watchdog-ului
+    if ((RCC->BDCR & RCC_BDCR_RTCSEL) == 0) {
+        if (!stats.lse) {
+            RCC->CSR |= RCC_CSR_LSION;
+            while ((RCC->CSR & RCC_CSR_LSIRDY) == 0) {
+            }
+        }
+        __HAL_RCC_RTC_CONFIG(stats.lse ? RCC_RTCCLKSOURCE_LSE : RCC_RTCCLKSOURCE_LSI);
+    }
+    switch (RCC->BDCR & RCC_BDCR_RTCSEL) {
+    case RCC_RTCCLKSOURCE_LSE:
+        rtcHz = stats.lse ? LSE_VALUE : 0U;
+        break;
+    case RCC_RTCCLKSOURCE_LSI:
+        rtcHz = LSI_VALUE;
+        break;
+    default:
+        rtcHz = 0;
+        break;
+    }
+    if (rtcHz != 0) {
+        subsecondHz = rtcHz / (RTC_PREDIV_A + 1U);
+        __HAL_RCC_RTC_ENABLE();
+        RtcInit();
+    }
+
+    // Timerul de trezire RTC e linia EXTI 20
+    EXTI->RTSR1 |= EXTI_RTSR1_RT20;
+    EXTI->IMR1 |= EXTI_IMR1_IM20;
+    HAL_NVIC_SetPriority(RTC_WKUP_IRQn, 6, 0); // cod în flash: FLASH_IF_MASK_PRIORITY
+    HAL_NVIC_EnableIRQ(RTC_WKUP_IRQn);
+
+    // RX-ul legăturii pe EXTI7 (front de start), armat doar la nevoie;
+    // pinul rămâne în modul alternativ al USART1
+    MODIFY_REG(SYSCFG->EXTICR[1], SYSCFG_EXTICR2_EXTI7, SYSCFG_EXTICR2_EXTI7_PB);
+    EXTI->FTSR1 |= LINK_RX_PIN;
+    HAL_NVIC_SetPriority(EXTI9_5_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+
+    __HAL_RCC_WAKEUPSTOP_CLK_CONFIG(RCC_STOP_WAKEUPCLOCK_HSI);
+#ifdef DEBUG
+    // Debuggerul rămâne conectat și în Stop (consumul nu mai e reprezentativ)
+    DBGMCU->CR |= DBGMCU_CR_DBG_STOP;
+#endif
+
+#if POWER_TRACE
+    {
+        GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+        __HAL_RCC_GPIOB_CLK_ENABLE();
+        GPIO_InitStruct.Pin = GPIO_PIN_13;
+        GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+        HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+        TRACE(1);
+    }
+#endif
+}
+
+void Power_Sleep(uint32_t expectedTicks) {
+    uint32_t start;
+    uint32_t slept;
+    uint32_t sleptMs;
+    PowerWake_t source;
+
+    if (expectedTicks < POWER_MIN_STOP_MS || !StopAllowed()) {
+        // Sleep: SysTick merge mai departe și trezește nucleul la tick-ul următor
+        SleepTimed();
+        return;
+    }
+    if (expectedTicks > POWER_MAX_STOP_MS) {
+        expectedTicks = POWER_MAX_STOP_MS;
+    }
+
+    __disable_irq();
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
+        __enable_irq();
+        return;
+    }
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    WakeupTimerStart(expectedTicks);
+    start = RtcNow();
+
+    TRACE(0);
+    HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFI);
+    RestoreClock();
+    TRACE(1);
+
+    slept = RtcElapsed(start);
+    source = WakeSource();
+    WakeupTimerStop();
+    sleptMs = slept * 1000U / subsecondHz;
+    if (sleptMs > expectedTicks) {
+        sleptMs = expectedTicks;
+    }
+
+    // Timpul din Stop, recuperat în ambele ceasuri de 1 ms (HAL și kernel)
+    uwTick += sleptMs;
+    vTaskStepTick(sleptMs);
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    stats.stopCount++;
+    stopUnits += slept;
+    stats.lastStopMs = sleptMs;
+    stats.wakeCount[source]++;
+
+    // Întreruperea sursei de trezire (dacă e cazul) rulează abia acum
+    __enable_irq();
+}
+
+void Power_LinkWakeArm(uint8_t enable) {
+    if (enable) {
+        EXTI->PR1 = LINK_RX_PIN;
+        EXTI->IMR1 |= LINK_RX_PIN;
+    } else {
+        EXTI->IMR1 &= ~LINK_RX_PIN;
+    }
+}
+
+// Primul front de start trezește BluetoothTask; restul octeților vin prin
+// USART1, deci linia se dezarmează imediat
+void Power_LinkWakeCallback(void) {
+    EXTI->IMR1 &= ~LINK_RX_PIN;
+    if (bluetoothTaskHandle != NULL) {
+        osThreadFlagsSet(bluetoothTaskHandle, LINK_FLAG_RX);
+    }
+}
+
+void Power_GetStats(PowerStats_t *out) {
+    uint32_t primask = __get_PRIMASK();
+    uint64_t windowUs;
+    uint64_t sleepUs;
+    uint64_t stopUs;
+
+    __disable_irq();
+    *out = *(const PowerStats_t *)&stats;
+    windowUs = (uint64_t)(uwTick - statsStartTick) * 1000U;
+    sleepUs = sleepCycles / (SystemCoreClock / 1000000U);
+    stopUs = (subsecondHz != 0) ? stopUnits * 1000000U / subsecondHz : 0U;
+    __set_PRIMASK(primask);
+
+    // LPRun și Stop 1 nu sunt folosite de firmware: rămân 0
+    out->residency.us[ENERGY_MODE_SLEEP] = sleepUs;
+    out->residency.us[ENERGY_MODE_STOP2] = stopUs;
+    out->residency.us[ENERGY_MODE_RUN] = (windowUs > sleepUs + stopUs) ? windowUs - sleepUs - stopUs : 0U;
+}
+
+void Power_ResetStats(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    stats.stopCount = 0;
+    stats.lastStopMs = 0;
+    for (int i = 0; i < POWER_WAKE_COUNT; i++) {
+        stats.wakeCount[i] = 0;
+    }
+    sleepCycles = 0;
+    stopUnits = 0;
+    statsStartTick = uwTick;
+    __set_PRIMASK(primask);
+}
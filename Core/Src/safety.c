@@ -0,0 +1,92 @@
+#include "main.h"
+#include "safety.h"
+#include "fan.h"
+#include "buzzer.h"
+#include "config.h"
+#include "power.h"
+#include "baseline.h"
+#include "sections.h"
+
+static volatile uint8_t tripPending;
+static volatile uint8_t quiet;
+static volatile SafetyStats_t stats;
+
+HOT_FUNC static void Trip(void) {
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles;
+
+    // Ventilatorul întâi: o singură scriere în CCR
+    Fan_SafetyOn();
+    if (config.buzzerEnable && !quiet) {
+        Buzzer_Play(BUZZER_ALARM);
+    }
+    cycles = DWT->CYCCNT - start;
+
+    stats.trips++;
+    stats.lastCycles = cycles;
+    if (cycles > stats.maxCycles) {
+        stats.maxCycles = cycles;
+    }
+    tripPending = 1;
+}
+
+void Safety_Init(void) {
+    // Contorul de cicluri pentru măsurarea latenței
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Starea de încălzire din Baseline_Init (și după un reset la cald),
+    // actualizată apoi de GasMonitorTask
+    quiet = !Baseline_Warm(SENSOR_PRIMARY);
+    __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_0);
+    HAL_NVIC_SetPriority(EXTI0_IRQn, SAFETY_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+
+    if (Safety_Active()) {
+        uint32_t primask = __get_PRIMASK();
+
+        __disable_irq();
+        Trip();
+        __set_PRIMASK(primask);
+    }
+}
+
+uint8_t Safety_Active(void) {
+    return (GPIOA->IDR & GPIO_PIN_0) == 0;
+}
+
+uint8_t Safety_TakeTrip(void) {
+    uint32_t primask = __get_PRIMASK();
+    uint8_t pending;
+
+    __disable_irq();
+    pending = tripPending;
+    tripPending = 0;
+    __set_PRIMASK(primask);
+    return pending;
+}
+
+void Safety_SetQuiet(uint8_t value) {
+    quiet = value;
+}
+
+void Safety_GetStats(SafetyStats_t *out) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    out->trips = stats.trips;
+    out->lastCycles = stats.lastCycles;
+    out->maxCycles = stats.maxCycles;
+    __set_PRIMASK(primask);
+}
+
+// Din SRAM2, ca și HAL_GPIO_EXTI_IRQHandler (scriptul de linker)
+HOT_FUNC void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    if (GPIO_Pin == GPIO_PIN_0) {
+        Trip();
+    } else if (GPIO_Pin == GPIO_PIN_7) {
+        // RX-ul legăturii, armat doar cât BluetoothTask așteaptă în consum redus
+        Power_LinkWakeCallback();
+    }
+}
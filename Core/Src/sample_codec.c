@@ -0,0 +1,154 @@
+#include "sample_codec.h"
+
+static size_t PutVarint(uint8_t *out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80U) {
+        out[n++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static int GetVarint(const uint8_t *in, size_t len, size_t *pos, uint32_t *value) {
+    uint32_t result = 0;
+    uint32_t shift = 0;
+
+    while (*pos < len && shift < 35U) {
+        uint8_t byte = in[(*pos)++];
+        result |= (uint32_t)(byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0) {
+            *value = result;
+            return 0;
+        }
+        shift += 7U;
+    }
+    return -1;
+}
+
+static inline uint32_t ZigZag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t UnZigZag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1U);
+}
+
+static void FlushRun(SampleEncoder_t *enc) {
+    if (enc->run != 0) {
+        enc->len += PutVarint(&enc->out[enc->len], (enc->run << 1) | 1U);
+        enc->run = 0;
+    }
+}
+
+void SampleEncoder_Init(SampleEncoder_t *enc, uint8_t *out, size_t size) {
+    enc->out = out;
+    enc->size = size;
+    enc->len = 0;
+    enc->count = 0;
+    enc->prevTimestamp = 0;
+    enc->prevInterval = 0;
+    enc->prevValue = 0;
+    enc->run = 0;
+}
+
+int SampleEncoder_Put(SampleEncoder_t *enc, const Sample_t *sample) {
+    if (enc->size < enc->len + SAMPLE_ENCODER_RESERVE) {
+        return -1;
+    }
+
+    if (enc->count == 0) {
+        enc->len += PutVarint(&enc->out[enc->len], sample->timestamp);
+        enc->len += PutVarint(&enc->out[enc->len], sample->value);
+    } else {
+        uint32_t interval = sample->timestamp - enc->prevTimestamp;
+        int32_t dv = (int32_t)sample->value - (int32_t)enc->prevValue;
+        int32_t ddt = (int32_t)(interval - enc->prevInterval);
+
+        if (dv == 0 && ddt == 0) {
+            // Porțiune plată cu eșantionare regulată - doar incrementăm run-ul
+            enc->run++;
+        } else {
+            FlushRun(enc);
+            enc->len += PutVarint(&enc->out[enc->len], ZigZag(dv) << 1);
+            enc->len += PutVarint(&enc->out[enc->len], ZigZag(ddt));
+        }
+        enc->prevInterval = interval;
+    }
+
+    enc->prevTimestamp = sample->timestamp;
+    enc->prevValue = sample->value;
+    enc->count++;
+    return 0;
+}
+
+size_t SampleEncoder_Finish(SampleEncoder_t *enc) {
+    FlushRun(enc);
+    return enc->len;
+}
+
+size_t SampleCodec_Encode(const Sample_t *samples, size_t count, uint8_t *out, size_t size) {
+    SampleEncoder_t enc;
+
+    SampleEncoder_Init(&enc, out, size);
+    for (size_t i = 0; i < count; i++) {
+        if (SampleEncoder_Put(&enc, &samples[i]) != 0) {
+            return 0;
+        }
+    }
+    return SampleEncoder_Finish(&enc);
+}
+
+int32_t SampleCodec_Decode(const uint8_t *in, size_t len, Sample_t *out, size_t maxCount) {
+    size_t pos = 0;
+    size_t count = 0;
+    uint32_t timestamp, value, token, interval = 0;
+
+    if (len == 0) {
+        return 0;
+    }
+    if (GetVarint(in, len, &pos, &timestamp) != 0 ||
+        GetVarint(in, len, &pos, &value) != 0 || value > 0xFFFFU) {
+        return -1;
+    }
+    if (maxCount == 0) {
+        return -1;
+    }
+    out[count].timestamp = timestamp;
+    out[count].value = (uint16_t)value;
+    count++;
+
+    while (pos < len) {
+        if (GetVarint(in, len, &pos, &token) != 0) {
+            return -1;
+        }
+
+        if (token & 1U) {
+            uint32_t run = token >> 1;
+            if (run > maxCount - count) {
+                return -1;
+            }
+            while (run--) {
+                timestamp += interval;
+                out[count].timestamp = timestamp;
+                out[count].value = (uint16_t)value;
+                count++;
+            }
+        } else {
+            uint32_t ddt;
+            if (count >= maxCount || GetVarint(in, len, &pos, &ddt) != 0) {
+                return -1;
+            }
+            value = (uint32_t)((int32_t)value + UnZigZag(token >> 1));
+            if (value > 0xFFFFU) {
+                return -1;
+            }
+            interval += (uint32_t)UnZigZag(ddt);
+            timestamp += interval;
+            out[count].timestamp = timestamp;
+            out[count].value = (uint16_t)value;
+            count++;
+        }
+    }
+    return (int32_t)count;
+}
@@ -0,0 +1,263 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "selftest.h"
+#include "config.h"
+#include "sensors.h"
+#include "fan.h"
+#include "buzzer.h"
+#include "safety.h"
+#include "link.h"
+#include "event_log.h"
+#include "logger.h"
+#include <string.h>
+
+// Între teste timerul verifică doar dacă a venit ora celui programat
+#define SELFTEST_IDLE_MS 60000U
+
+typedef enum {
+    STEP_IDLE = 0,
+    STEP_FAN,                // ventilatorul accelerează spre SELFTEST_FAN_DUTY
+    STEP_LINK,               // ping trimis (sau cerut), se așteaptă pong-ul
+} Step_t;
+
+extern osThreadId_t bluetoothTaskHandle;
+
+static osTimerId_t testTimer;
+static Step_t step;
+static uint32_t stepStart;
+static uint32_t lastRun;
+static uint16_t sequence;
+static uint16_t pingCount;
+static volatile uint8_t startRequest; // 1 = comandă, în așteptarea timerului
+static SelfTestReport_t current;      // testul în curs (doar din timer)
+static SelfTestReport_t report;       // ultimul test complet
+static volatile uint8_t reportPending;
+
+// Pasul de link, împărțit cu BluetoothTask
+static SelfTestPing_t ping;
+static volatile uint8_t pingRequested;
+static volatile uint8_t linkSkipped;
+static volatile uint8_t pongReceived;
+static volatile uint16_t rttMs;
+
+// Alarma are prioritate: cât timp lucrează, buzzerul și ventilatorul nu se testează
+static uint8_t AlarmActive(void) {
+    for (uint8_t i = 0; i < Sensors_Count(); i++) {
+        SensorState_t state;
+
+        Sensors_Get(i, &state);
+        if (state.level != ALARM_NONE) {
+            return 1;
+        }
+    }
+    return Safety_Active();
+}
+
+static void TestSensors(void) {
+    for (uint8_t i = 0; i < Sensors_Count(); i++) {
+        SensorState_t state;
+
+        Sensors_Get(i, &state);
+        if (state.counts < SELFTEST_COUNTS_MIN || state.counts > SELFTEST_COUNTS_MAX) {
+            current.badChannels |= (uint8_t)(1U << i);
+        }
+    }
+    current.result[SELFTEST_SENSORS] = current.badChannels ? SELFTEST_FAIL : SELFTEST_PASS;
+}
+
+// Placa nu are o intrare de citire înapoi de la buzzer: PB2 e chiar
+// ieșirea LPTIM1 a MCU, deci fronturile arată doar că tonul e comandat
+// (timer pornit, pin nescurtcircuitat), nu că buzzerul sună. Comanda bună
+// se raportează SKIP, lipsa ei FAIL; PASS nu se dă niciodată.
+static void TestBuzzer(void) {
+    // Sunetul dezactivat din configurație rămâne dezactivat și pentru test
+    if (!config.buzzerEnable || AlarmActive() || Buzzer_Current() != BUZZER_NONE) {
+        current.result[SELFTEST_BUZZER] = SELFTEST_SKIP;
+        return;
+    }
+    Buzzer_Play(BUZZER_BEEP);
+    current.buzzerEdges = (uint16_t)Buzzer_Feedback(SELFTEST_BUZZER_WINDOW_US);
+    current.result[SELFTEST_BUZZER] =
+        (current.buzzerEdges >= SELFTEST_BUZZER_EDGES) ? SELFTEST_SKIP : SELFTEST_FAIL;
+}
+
+static void StartLink(uint32_t now) {
+    pongReceived = 0;
+    linkSkipped = 0;
+    ping.token = ((uint32_t)sequence << 16) | ++pingCount;
+    pingRequested = 1;
+    step = STEP_LINK;
+    stepStart = now;
+    osThreadFlagsSet(bluetoothTaskHandle, LINK_FLAG_SELFTEST);
+}
+
+static void Begin(uint32_t now) {
+    memset(&current, 0, sizeof(current));
+    current.sequence = ++sequence;
+    current.manual = startRequest;
+    startRequest = 0;
+    lastRun = now;
+    LOG("selftest: start %u (%s)", sequence, current.manual ? "comanda" : "programat");
+
+    TestSensors();
+    TestBuzzer();
+    if (AlarmActive() || config.fanTachPulses == 0) {
+        current.result[SELFTEST_FAN] = SELFTEST_SKIP;
+        StartLink(now);
+    } else {
+        Fan_SetTest(SELFTEST_FAN_DUTY);
+        step = STEP_FAN;
+        stepStart = now;
+    }
+}
+
+static void FinishFan(uint32_t now) {
+    current.fanRpm = Fan_GetRpm();
+    Fan_SetTest(0);
+    if (current.fanRpm >= SELFTEST_FAN_MIN_RPM) {
+        current.result[SELFTEST_FAN] = SELFTEST_PASS;
+    } else {
+        // O alarmă apărută între timp a preluat ventilatorul
+        current.result[SELFTEST_FAN] = AlarmActive() ? SELFTEST_SKIP : SELFTEST_FAIL;
+    }
+    StartLink(now);
+}
+
+static void Finish(uint32_t now) {
+    uint16_t failed = 0;
+    uint16_t skipped = 0;
+    uint32_t primask;
+
+    pingRequested = 0;
+    current.timestamp = now;
+    for (uint32_t i = 0; i < SELFTEST_ITEM_COUNT; i++) {
+        failed |= (uint16_t)((current.result[i] == SELFTEST_FAIL) << i);
+        skipped |= (uint16_t)((current.result[i] == SELFTEST_SKIP) << i);
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    report = current;
+    reportPending = 1;
+    __set_PRIMASK(primask);
+    step = STEP_IDLE;
+
+    LOG("selftest: gata %u, picate=%x sarite=%x", sequence, failed, skipped);
+    EventLog_Append(EVT_SELFTEST, failed, skipped);
+    osThreadFlagsSet(bluetoothTaskHandle, LINK_FLAG_SELFTEST);
+}
+
+// Rulează în task-ul de timere: fiecare pas doar pornește sau verifică,
+// fără să aștepte (citirea înapoi a buzzerului ține SELFTEST_BUZZER_WINDOW_US)
+static void TestTimerCallback(void *argument) {
+    uint32_t now = osKernelGetTickCount();
+
+    (void)argument;
+    switch (step) {
+    case STEP_IDLE:
+        if (startRequest ||
+            (config.selftestHours != 0 && now - lastRun >= config.selftestHours * 3600000UL)) {
+            Begin(now);
+        }
+        break;
+    case STEP_FAN:
+        if (now - stepStart >= SELFTEST_FAN_MS) {
+            FinishFan(now);
+        }
+        break;
+    case STEP_LINK:
+        if (linkSkipped) {
+            current.result[SELFTEST_LINK] = SELFTEST_SKIP;
+            Finish(now);
+        } else if (pongReceived) {
+            current.linkRttMs = rttMs;
+            current.result[SELFTEST_LINK] = SELFTEST_PASS;
+            Finish(now);
+        } else if (now - stepStart >= SELFTEST_LINK_TIMEOUT_MS) {
+            current.result[SELFTEST_LINK] = SELFTEST_FAIL;
+            Finish(now);
+        }
+        break;
+    }
+    osTimerStart(testTimer, (step == STEP_IDLE) ? SELFTEST_IDLE_MS : SELFTEST_STEP_MS);
+}
+
+void SelfTest_Init(void) {
+    const osTimerAttr_t testTimerAttr = {
+        .name = "SelfTest"
+    };
+
+    testTimer = osTimerNew(TestTimerCallback, osTimerOnce, NULL, &testTimerAttr);
+    osTimerStart(testTimer, SELFTEST_IDLE_MS);
+}
+
+int SelfTest_Start(void) {
+    if (step != STEP_IDLE || startRequest) {
+        return -1;
+    }
+    startRequest = 1;
+    // Primul pas imediat, tot din task-ul de timere
+    osTimerStart(testTimer, 1);
+    return 0;
+}
+
+uint8_t SelfTest_Running(void) {
+    return step != STEP_IDLE || startRequest;
+}
+
+uint8_t SelfTest_LinkPoll(uint8_t linkActive, SelfTestPing_t *out) {
+    if (!pingRequested) {
+        return 0;
+    }
+    pingRequested = 0;
+    if (!linkActive) {
+        linkSkipped = 1; // nicio gazdă conectată care să răspundă
+        return 0;
+    }
+    ping.sentMs = osKernelGetTickCount();
+    *out = ping;
+    return 1;
+}
+
+void SelfTest_Pong(const uint8_t *payload, uint16_t len) {
+    SelfTestPing_t pong;
+
+    if (len != sizeof(pong) || step != STEP_LINK) {
+        return;
+    }
+    memcpy(&pong, payload, sizeof(pong));
+    if (pong.token == ping.token && !pongReceived) {
+        uint32_t rtt = osKernelGetTickCount() - ping.sentMs;
+
+        rttMs = (uint16_t)((rtt > 0xFFFFU) ? 0xFFFFU : rtt);
+        pongReceived = 1;
+    }
+}
+
+uint8_t SelfTest_TakeReport(SelfTestReport_t *out) {
+    uint32_t primask = __get_PRIMASK();
+    uint8_t pending;
+
+    __disable_irq();
+    pending = reportPending;
+    reportPending = 0;
+    *out = report;
+    __set_PRIMASK(primask);
+    return pending;
+}
+
+void SelfTest_GetReport(SelfTestReport_t *out) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *out = report;
+    __set_PRIMASK(primask);
+}
+
+uint16_t SelfTest_Summary(void) {
+    uint16_t summary = 0;
+
+    for (uint32_t i = 0; i < SELFTEST_ITEM_COUNT; i++) {
+        summary |= (uint16_t)(report.result[i] << (2U * i));
+    }
+    return summary;
+}
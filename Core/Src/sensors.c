@@ -0,0 +1,136 @@
+#include "main.h"
+#include "sensors.h"
+#include "config.h"
+#include "adc.h"
+#include "event_log.h"
+#include "logger.h"
+#include "baseline.h"
+#include "safety.h"
+
+// Canalele plăcii. MQ-2 ia R0 și pragurile din configurație; ceilalți au
+// valorile tipice ale modulelor, corectate apoi de urmărirea liniei de bază.
+// Pentru MQ-135, „aer curat” e CO2-ul atmosferic (~400 ppm) pe curba CO2.
+// MQ-7 e citit cu încălzitorul la 5 V continuu (fără ciclul 5 V / 1.4 V din
+// foaia de catalog), deci concentrația de CO e doar orientativă.
+static const SensorChannel_t sensorTable[] = {
+    {
+        .name = "mq2", .port = GPIOA, .pin = GPIO_PIN_1, .adcChannel = 6,
+        .sampleTime = ADC_SMP_92_5, .compensate = 1, .curve = &gasCurveMq2Lpg,
+        .r0 = &config.sensorR0, .cleanRatio = 9830, .warnPpm = &config.warnPpm,
+        .alarmPpm = &config.alarmPpm,
+    },
+    {
+        .name = "mq7", .port = GPIOA, .pin = GPIO_PIN_4, .adcChannel = 9,
+        .sampleTime = ADC_SMP_92_5, .compensate = 0, .curve = &gasCurveMq7Co,
+        .r0 = &(const uint16_t){ 1000 }, .cleanRatio = 27500, .warnPpm = &(const uint16_t){ 50 },
+        .alarmPpm = &(const uint16_t){ 200 },
+    },
+    {
+        .name = "mq135", .port = GPIOB, .pin = GPIO_PIN_0, .adcChannel = 15,
+        .sampleTime = ADC_SMP_92_5, .compensate = 0, .curve = &gasCurveMq135Co2,
+        .r0 = &(const uint16_t){ 3800 }, .cleanRatio = 640, .warnPpm = &(const uint16_t){ 1500 },
+        .alarmPpm = &(const uint16_t){ 5000 },
+    },
+};
+
+#define SENSOR_COUNT (sizeof(sensorTable) / sizeof(sensorTable[0]))
+
+_Static_assert(SENSOR_COUNT <= SENSOR_MAX, "sensorTable: prea multe canale pentru SENSOR_MAX");
+_Static_assert(SENSOR_COUNT <= ADC_SEQ_MAX, "sensorTable: prea multe canale pentru o secvență ADC");
+
+static uint16_t counts[SENSOR_COUNT]; // destinația DMA, în ordinea tabelului
+static SensorState_t state[SENSOR_COUNT];
+static uint32_t scanCycles;
+
+void Sensors_Init(void) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    uint8_t channels[SENSOR_COUNT];
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+
+    Adc_Init();
+    GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    for (uint32_t i = 0; i < SENSOR_COUNT; i++) {
+        GPIO_InitStruct.Pin = sensorTable[i].pin;
+        HAL_GPIO_Init(sensorTable[i].port, &GPIO_InitStruct);
+        // Impedanța modulelor e mare: eșantionare lungă
+        Adc_SetSampleTime(sensorTable[i].adcChannel, sensorTable[i].sampleTime);
+        channels[i] = sensorTable[i].adcChannel;
+    }
+    Adc_SetSequence(channels, SENSOR_COUNT);
+    Baseline_Init();
+}
+
+AlarmLevel_t Sensors_Scan(uint32_t now) {
+    static const EventType_t levelEvents[] = {
+        [ALARM_NONE] = EVT_GAS_CLEARED,
+        [ALARM_WARNING] = EVT_GAS_WARNING,
+        [ALARM_ALARM] = EVT_GAS_DETECTED,
+    };
+    uint32_t start = DWT->CYCCNT;
+    uint16_t factor = GasSensor_Compensation();
+    AlarmLevel_t highest = ALARM_NONE;
+
+    Adc_Scan(counts);
+    for (uint32_t i = 0; i < SENSOR_COUNT; i++) {
+        const SensorChannel_t *channel = &sensorTable[i];
+        SensorState_t next;
+        uint32_t primask;
+
+        next.counts = counts[i];
+        next.ppm = GasSensor_Convert(channel->curve, Baseline_R0((uint8_t)i),
+                                     channel->compensate ? factor : 1000U, counts[i]);
+        // În încălzire nivelul rămâne ALARM_NONE, fără evenimente
+        next.level = Baseline_Warm((uint8_t)i) ?
+                     GasSensor_Classify(next.ppm, state[i].level, *channel->warnPpm, *channel->alarmPpm) :
+                     ALARM_NONE;
+        if (next.level != state[i].level) {
+            LOG("%s: nivel %u -> %u, %u ppm", channel->name, state[i].level, next.level, next.ppm);
+            EventLog_Append(levelEvents[next.level], next.ppm, (uint16_t)i);
+        }
+        if (next.level > highest) {
+            highest = next.level;
+        }
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+        state[i] = next;
+        __set_PRIMASK(primask);
+    }
+
+    // Aer curat verificat: niciun canal peste praguri, DO inactiv și
+    // concentrația canalului mult sub pragul de avertizare
+    for (uint32_t i = 0; i < SENSOR_COUNT; i++) {
+        const SensorChannel_t *channel = &sensorTable[i];
+        uint8_t clean = highest == ALARM_NONE && !Safety_Active() && state[i].ppm < *channel->warnPpm / 4U;
+
+        Baseline_Update((uint8_t)i, counts[i], channel->compensate ? factor : 1000U, clean, now);
+    }
+    scanCycles = DWT->CYCCNT - start;
+    return highest;
+}
+
+uint8_t Sensors_Count(void) {
+    return (uint8_t)SENSOR_COUNT;
+}
+
+const SensorChannel_t *Sensors_Channel(uint8_t index) {
+    return (index < SENSOR_COUNT) ? &sensorTable[index] : NULL;
+}
+
+void Sensors_Get(uint8_t index, SensorState_t *out) {
+    uint32_t primask = __get_PRIMASK();
+
+    if (index >= SENSOR_COUNT) {
+        return;
+    }
+    __disable_irq();
+    *out = state[index];
+    __set_PRIMASK(primask);
+}
+
+uint32_t Sensors_ScanCycles(void) {
+    return scanCycles;
+}
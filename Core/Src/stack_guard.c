@@ -0,0 +1,81 @@
+#include "stack_guard.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Simboluri din scriptul de link: vârful MSP și rezerva lui (ca în sysmem.c)
+extern uint8_t _estack;
+extern uint32_t _Min_Stack_Size;
+
+// Fără acces (AP = 0), fără execuție, 32 de octeți (SIZE = log2(32) - 1)
+#define GUARD_RASR (MPU_RASR_XN_Msk | (4U << MPU_RASR_SIZE_Pos) | MPU_RASR_S_Msk | MPU_RASR_C_Msk | \
+                    MPU_RASR_ENABLE_Msk)
+
+static uint32_t mspGuard;
+
+static uint32_t RegionBase(uint32_t region) {
+    MPU->RNR = region;
+    return MPU->RBAR & MPU_RBAR_ADDR_Msk;
+}
+
+void StackGuard_Init(void) {
+    // Limita MSP e aceeași cu cea până la care _sbrk lasă heap-ul să crească
+    mspGuard = (uint32_t)&_estack - (uint32_t)&_Min_Stack_Size;
+    mspGuard = (mspGuard + STACK_GUARD_SIZE - 1U) & ~(STACK_GUARD_SIZE - 1U);
+
+    MPU->CTRL = 0;
+    MPU->RBAR = mspGuard | MPU_RBAR_VALID_Msk | STACK_GUARD_MSP_REGION;
+    MPU->RASR = GUARD_RASR;
+    // Până la primul task, garda task-ului dublează garda MSP
+    MPU->RBAR = mspGuard | MPU_RBAR_VALID_Msk | STACK_GUARD_TASK_REGION;
+    MPU->RASR = GUARD_RASR;
+    MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+    __DSB();
+    __ISB();
+}
+
+uint8_t StackGuard_Hit(uint32_t cfsr, uint32_t mmfar) {
+    uint32_t taskGuard;
+
+    if ((MPU->CTRL & MPU_CTRL_ENABLE_Msk) == 0) {
+        return 0;
+    }
+    // Cadrul de excepție nu a încăput pe stivă
+    if (cfsr & SCB_CFSR_MSTKERR_Msk) {
+        return 1;
+    }
+    if ((cfsr & SCB_CFSR_MMARVALID_Msk) == 0) {
+        return 0;
+    }
+    taskGuard = RegionBase(STACK_GUARD_TASK_REGION);
+    return (mmfar - mspGuard < STACK_GUARD_SIZE) || (mmfar - taskGuard < STACK_GUARD_SIZE);
+}
+
+void StackGuard_Disable(void) {
+    MPU->CTRL = 0;
+    __DSB();
+    __ISB();
+}
+
+// Octeții de umplere (tskSTACK_FILL_BYTE) de jos în sus, garda numărată
+// ca neatinsă, fără să fie citită
+uint32_t StackGuard_StackSpace(void *thread) {
+    TaskStatus_t status;
+    const uint8_t *bottom;
+    uint32_t guard;
+    uint32_t free = 0;
+
+    vTaskGetInfo((TaskHandle_t)thread, &status, pdFALSE, eInvalid);
+    bottom = (const uint8_t *)status.pxStackBase;
+    guard = STACK_GUARD_BASE(bottom);
+    for (;;) {
+        uint32_t address = (uint32_t)&bottom[free];
+
+        if (address - guard < STACK_GUARD_SIZE) {
+            free = guard + STACK_GUARD_SIZE - (uint32_t)bottom;
+        } else if (bottom[free] == 0xA5U) {
+            free++;
+        } else {
+            return free;
+        }
+    }
+}
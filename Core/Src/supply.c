@@ -0,0 +1,100 @@
+#include "main.h"
+#include "supply.h"
+#include "adc.h"
+#include "config.h"
+
+// Valorile de calibrare din fabrică (memoria sistem), la VDDA = 3.0 V
+#define VREFINT_CAL          (*(const uint16_t *)0x1FFF75AAUL)
+#define TEMPSENSOR_CAL1      (*(const uint16_t *)0x1FFF75A8UL) // la 30 °C
+#define TEMPSENSOR_CAL2      (*(const uint16_t *)0x1FFF75CAUL) // la 130 °C
+#define CAL_VDDA_MV          3000U
+#define CAL1_TEMP            300   // 0.1 °C
+#define CAL2_TEMP            1300
+#define VBAT_DIVIDER         3U
+
+static volatile SupplyReading_t reading;
+static volatile uint32_t sequence;
+static uint32_t lastTick;
+
+void Supply_Init(void) {
+    // Sursele interne cer cel puțin 4-12 us de eșantionare: 640.5 cicluri
+    // la 40 MHz înseamnă 16 us
+    Adc_SetSampleTime(SUPPLY_VREFINT_CHANNEL, ADC_SMP_640_5);
+    Adc_SetSampleTime(SUPPLY_TEMP_CHANNEL, ADC_SMP_640_5);
+    Adc_SetSampleTime(SUPPLY_VBAT_CHANNEL, ADC_SMP_640_5);
+}
+
+uint8_t Supply_Due(uint32_t now) {
+    return sequence == 0 || now - lastTick >= config.supplyPeriodMs;
+}
+
+uint8_t Supply_Measure(uint32_t now) {
+    uint32_t vref;
+    uint32_t vdda;
+    uint32_t vbat;
+    int32_t temp;
+    uint8_t low = reading.lowBattery;
+    uint8_t changed;
+    uint32_t primask;
+
+    ADC1_COMMON->CCR |= ADC_CCR_VREFEN | ADC_CCR_TSEN | ADC_CCR_VBATEN;
+    for (volatile uint32_t i = 0; i < SystemCoreClock / (1000000U / SUPPLY_TSTART_US); i++) {
+    }
+    vref = Adc_Read(SUPPLY_VREFINT_CHANNEL);
+    temp = Adc_Read(SUPPLY_TEMP_CHANNEL);
+    vbat = Adc_Read(SUPPLY_VBAT_CHANNEL);
+    ADC1_COMMON->CCR &= ~(ADC_CCR_VREFEN | ADC_CCR_TSEN | ADC_CCR_VBATEN);
+
+    vdda = (vref != 0) ? CAL_VDDA_MV * VREFINT_CAL / vref : 0U;
+    vbat = vbat * VBAT_DIVIDER * vdda / ADC_FULL_SCALE;
+    // Citirea senzorului se raportează la VDDA-ul de calibrare, apoi
+    // interpolare liniară între cele două puncte din fabrică
+    temp = temp * (int32_t)vdda / (int32_t)CAL_VDDA_MV;
+    temp = CAL1_TEMP + (temp - TEMPSENSOR_CAL1) * (CAL2_TEMP - CAL1_TEMP) /
+                       (int32_t)(TEMPSENSOR_CAL2 - TEMPSENSOR_CAL1);
+
+    // batt_low_mv = 0 dezactivează alarma
+    if (config.battLowMv == 0) {
+        low = 0;
+    } else if (vbat < config.battLowMv) {
+        low = 1;
+    } else if (vbat >= config.battLowMv + SUPPLY_HYSTERESIS_MV) {
+        low = 0;
+    }
+    changed = (low != reading.lowBattery);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    reading.timestamp = now;
+    reading.vddaMv = (uint16_t)vdda;
+    reading.vbatMv = (uint16_t)vbat;
+    reading.temperature = (int16_t)temp;
+    reading.lowBattery = low;
+    sequence++;
+    __set_PRIMASK(primask);
+
+    lastTick = now;
+    return changed;
+}
+
+uint32_t Supply_Get(SupplyReading_t *out) {
+    uint32_t primask = __get_PRIMASK();
+    uint32_t seq;
+
+    __disable_irq();
+    *out = *(const SupplyReading_t *)&reading;
+    seq = sequence;
+    __set_PRIMASK(primask);
+    return seq;
+}
+
+uint8_t Supply_LowBattery(void) {
+    return reading.lowBattery;
+}
+
+uint32_t Supply_SamplePeriod(void) {
+    if (reading.lowBattery && config.battSamplePeriodMs > config.samplePeriodMs) {
+        return config.battSamplePeriodMs;
+    }
+    return config.samplePeriodMs;
+}
@@ -0,0 +1,106 @@
+#include "main.h"
+#include "cmsis_os.h"
+#include "watchdog.h"
+#include "event_log.h"
+#include "ota.h"
+
+// Raportul supraviețuiește resetului în registrele de backup RTC
+#define WATCHDOG_BKP_MAGIC 0x57440000U // "WD" + mască în octeții de jos
+#define WATCHDOG_BKP_TAG   RTC->BKP0R
+#define WATCHDOG_BKP_AGE   RTC->BKP1R
+
+volatile uint32_t watchdogCheckIn[WDG_TASK_COUNT];
+static uint32_t deadlines[WDG_TASK_COUNT];
+static uint32_t lastResetMask;
+static uint8_t tripped;
+
+static const char *const taskNames[WDG_TASK_COUNT] = {
+    [WDG_TASK_GAS] = "GasMonitorTask",
+    [WDG_TASK_BLUETOOTH] = "BluetoothTask",
+    [WDG_TASK_STORAGE] = "StorageTask",
+    [WDG_TASK_TIMER] = "TimerTask",
+};
+
+void Watchdog_Init(void) {
+    uint32_t tag;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_RCC_RTCAPB_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    // Raportul resetului anterior, doar dacă chiar IWDG a resetat placa
+    tag = WATCHDOG_BKP_TAG;
+    if ((tag & 0xFFFF0000U) == WATCHDOG_BKP_MAGIC && __HAL_RCC_GET_FLAG(RCC_FLAG_IWDGRST)) {
+        lastResetMask = tag & 0xFFFFU;
+        EventLog_Append(EVT_WATCHDOG_RESET, (uint16_t)lastResetMask,
+                        (uint16_t)(WATCHDOG_BKP_AGE > 0xFFFFU ? 0xFFFFU : WATCHDOG_BKP_AGE));
+    }
+    WATCHDOG_BKP_TAG = 0;
+    WATCHDOG_BKP_AGE = 0;
+
+    // IWDG oprit cât timp nucleul e oprit în debugger
+    DBGMCU->APB1FZR1 |= DBGMCU_APB1FZR1_DBG_IWDG_STOP;
+
+    IWDG->KR = 0xCCCCU; // pornire (pornește și LSI)
+    IWDG->KR = 0x5555U; // acces la PR/RLR
+    IWDG->PR = 3U;      // /32 -> 1 kHz
+    IWDG->RLR = WATCHDOG_TIMEOUT_MS - 1U;
+    while (IWDG->SR != 0) {
+    }
+    IWDG->KR = 0xAAAAU;
+}
+
+void Watchdog_Register(WatchdogTask_t task, uint32_t deadlineMs) {
+    watchdogCheckIn[task] = uwTick;
+    deadlines[task] = deadlineMs;
+}
+
+uint32_t Watchdog_Age(WatchdogTask_t task) {
+    return uwTick - watchdogCheckIn[task];
+}
+
+uint32_t Watchdog_Deadline(WatchdogTask_t task) {
+    return deadlines[task];
+}
+
+const char *Watchdog_TaskName(WatchdogTask_t task) {
+    return taskNames[task];
+}
+
+uint32_t Watchdog_LastResetMask(void) {
+    return lastResetMask;
+}
+
+// Prioritate mare: dacă nici acest task nu mai rulează, IWDG resetează
+void StartWatchdogTask(void *argument) {
+    uint32_t wake = osKernelGetTickCount();
+
+    for (;;) {
+        uint32_t missed = 0;
+        uint32_t worstAge = 0;
+
+        for (uint32_t i = 0; i < WDG_TASK_COUNT; i++) {
+            uint32_t age = Watchdog_Age((WatchdogTask_t)i);
+
+            if (deadlines[i] != 0 && age > deadlines[i]) {
+                missed |= 1U << i;
+                worstAge = (age > worstAge) ? age : worstAge;
+            }
+        }
+
+        // Prima depășire: notăm vinovații și nu mai reîmprospătăm deloc,
+        // chiar dacă task-ul își revine până la expirarea IWDG
+        if (missed != 0 && !tripped) {
+            tripped = 1;
+            WATCHDOG_BKP_TAG = WATCHDOG_BKP_MAGIC | missed;
+            WATCHDOG_BKP_AGE = worstAge;
+        }
+        if (!tripped) {
+            IWDG->KR = 0xAAAAU;
+            Ota_HealthTick(WATCHDOG_PERIOD_MS);
+        }
+
+        wake += WATCHDOG_PERIOD_MS;
+        osDelayUntil(wake);
+    }
+}
@@ -44,6 +44,17 @@ defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
 .word	_ebss
+/* start address for the initialization values of the .ramfunc section.
+defined in linker script */
+.word	_siramfunc
+/* start address for the .ramfunc section. defined in linker script */
+.word	_sramfunc
+/* end address for the .ramfunc section. defined in linker script */
+.word	_eramfunc
+/* start address for the .sram2 section. defined in linker script */
+.word	_ssram2
+/* end address for the .sram2 section. defined in linker script */
+.word	_esram2
 
 .equ  BootRAM,        0xF1E0F85F
 /**
@@ -95,6 +106,37 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy the SRAM2 code (.ramfunc) from flash to SRAM2 */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  movs r3, #0
+  b LoopCopyRamFunc
+
+CopyRamFunc:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyRamFunc:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyRamFunc
+
+/* Zero fill the .sram2 segment; .sram2_noinit is left untouched */
+  ldr r2, =_ssram2
+  ldr r4, =_esram2
+  movs r3, #0
+  b LoopFillZeroSram2
+
+FillZeroSram2:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroSram2:
+  cmp r2, r4
+  bcc FillZeroSram2
+
 /* Call static constructors */
     bl __libc_init_array
 /* Call the application's entry point.*/
@@ -0,0 +1,99 @@
+// Benchmark host pentru SampleCodec: rată de compresie și viteză.
+//
+// Build: gcc -O2 -I../Core/Inc codec_bench.c ../Core/Src/sample_codec.c -o codec_bench
+//
+// Generează câteva urme sintetice de gaz (plat, drift lent, zgomot, vârfuri)
+// și compară cu formatul brut (u32 timestamp + u16 valoare = 6 octeți).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sample_codec.h"
+
+#define N_SAMPLES   100000U
+#define ITERATIONS  50U
+#define LINK_BAUD   9600U
+
+static Sample_t input[N_SAMPLES];
+static Sample_t decoded[N_SAMPLES];
+static uint8_t encoded[N_SAMPLES * 8U];
+
+typedef enum { TRACE_FLAT, TRACE_DRIFT, TRACE_NOISY, TRACE_ALARM } Trace_t;
+
+static const char *traceNames[] = { "plat", "drift", "zgomot", "alarme" };
+
+static void Generate(Trace_t trace) {
+    uint32_t value = 300;
+
+    srand(1234);
+    for (uint32_t i = 0; i < N_SAMPLES; i++) {
+        switch (trace) {
+        case TRACE_FLAT:
+            break;
+        case TRACE_DRIFT:
+            if (rand() % 20 == 0) {
+                value += (rand() % 3) - 1;
+            }
+            break;
+        case TRACE_NOISY:
+            value = 300 + (rand() % 9) - 4;
+            break;
+        case TRACE_ALARM:
+            // Palier de fond cu vârfuri rare de concentrație
+            if (i % 5000 < 200) {
+                value = 300 + (i % 5000) * 10;
+            } else {
+                value = 300;
+            }
+            break;
+        }
+        input[i].timestamp = i * 1000U + ((rand() % 50 == 0) ? 1 : 0);
+        input[i].value = (uint16_t)value;
+    }
+}
+
+static double Seconds(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(void) {
+    printf("%-8s %10s %10s %8s %12s %12s %12s\n", "urma", "brut[B]", "codat[B]",
+           "raport", "enc[Ms/s]", "dec[Ms/s]", "esant/s@9600");
+
+    for (Trace_t t = TRACE_FLAT; t <= TRACE_ALARM; t++) {
+        size_t len = 0;
+        int32_t n = 0;
+        clock_t start;
+        double encTime, decTime;
+
+        Generate(t);
+
+        start = clock();
+        for (uint32_t it = 0; it < ITERATIONS; it++) {
+            len = SampleCodec_Encode(input, N_SAMPLES, encoded, sizeof(encoded));
+        }
+        encTime = Seconds(start);
+
+        start = clock();
+        for (uint32_t it = 0; it < ITERATIONS; it++) {
+            n = SampleCodec_Decode(encoded, len, decoded, N_SAMPLES);
+        }
+        decTime = Seconds(start);
+
+        if (len == 0 || n != (int32_t)N_SAMPLES ||
+            memcmp(input, decoded, sizeof(input)) != 0) {
+            printf("%-8s EROARE: decodarea nu reproduce intrarea\n", traceNames[t]);
+            return 1;
+        }
+
+        size_t raw = N_SAMPLES * 6U;
+        // 10 biți pe octet pe UART (start + 8 + stop)
+        double samplesPerSecond = (LINK_BAUD / 10.0) * N_SAMPLES / len;
+        printf("%-8s %10zu %10zu %7.1fx %12.1f %12.1f %12.0f\n", traceNames[t], raw, len,
+               (double)raw / len, N_SAMPLES * ITERATIONS / encTime / 1e6,
+               N_SAMPLES * ITERATIONS / decTime / 1e6, samplesPerSecond);
+    }
+    printf("brut: %.0f esant/s@9600\n", (LINK_BAUD / 10.0) / 6.0);
+    return 0;
+}
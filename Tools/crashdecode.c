@@ -0,0 +1,224 @@
+// Decodor host pentru instantaneele de cădere trimise pe link (LINK_FRAME_CRASH).
+//
+// Build: gcc -O2 -I../Core/Inc crashdecode.c ../Core/Src/crc.c -o crashdecode
+// Rulare: ./crashdecode [-e firmware.elf] [-a arm-none-eabi-addr2line] captura.bin
+//
+// Reasamblează fragmentele după offset, validează CRC-32, afișează
+// registrele, decodează CFSR/HFSR și, cu -e, simbolizează PC, LR și
+// cuvintele din stivă care arată a adrese de retur (Thumb, în flash) cu
+// addr2line din toolchain.
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "crc.h"
+#include "link.h"
+#include "crash_dump.h"
+
+#define MAX_CAPTURE  (4U * 1024U * 1024U)
+#define FLASH_START  0x08000000U
+#define FLASH_END    0x0807B000U // începutul regiunii CONFIG
+
+static uint8_t capture[MAX_CAPTURE];
+static const char *elf;
+static const char *addr2line = "arm-none-eabi-addr2line";
+
+typedef struct {
+    uint32_t mask;
+    const char *name;
+} Flag_t;
+
+static const Flag_t cfsrFlags[] = {
+    { 1U << 0,  "IACCVIOL (execuție din regiune interzisă)" },
+    { 1U << 1,  "DACCVIOL (acces la date interzis)" },
+    { 1U << 3,  "MUNSTKERR" },
+    { 1U << 4,  "MSTKERR (depășire de stivă la intrarea în excepție)" },
+    { 1U << 5,  "MLSPERR" },
+    { 1U << 7,  "MMARVALID" },
+    { 1U << 8,  "IBUSERR" },
+    { 1U << 9,  "PRECISERR (adresă în BFAR)" },
+    { 1U << 10, "IMPRECISERR (scriere cu buffer, PC aproximativ)" },
+    { 1U << 11, "UNSTKERR" },
+    { 1U << 12, "STKERR" },
+    { 1U << 13, "LSPERR" },
+    { 1U << 15, "BFARVALID" },
+    { 1U << 16, "UNDEFINSTR" },
+    { 1U << 17, "INVSTATE (salt fără bitul Thumb)" },
+    { 1U << 18, "INVPC" },
+    { 1U << 19, "NOCP (FPU dezactivat)" },
+    { 1U << 24, "UNALIGNED" },
+    { 1U << 25, "DIVBYZERO" },
+};
+
+static const Flag_t hfsrFlags[] = {
+    { 1U << 1,  "VECTTBL" },
+    { 1U << 30, "FORCED (defect configurabil escaladat)" },
+    { 1U << 31, "DEBUGEVT" },
+};
+
+static const char *ReasonName(uint32_t reason) {
+    switch (reason) {
+    case CRASH_HARDFAULT:      return "HardFault";
+    case CRASH_MEMMANAGE:      return "MemManage";
+    case CRASH_BUSFAULT:       return "BusFault";
+    case CRASH_USAGEFAULT:     return "UsageFault";
+    case CRASH_STACK_OVERFLOW: return "StackOverflow";
+    default:                   return "necunoscută";
+    }
+}
+
+static void PrintFlags(const char *name, uint32_t value, const Flag_t *flags, size_t count) {
+    printf("  %-6s 0x%08X", name, (unsigned)value);
+    for (size_t i = 0; i < count; i++) {
+        if (value & flags[i].mask) {
+            printf("\n           %s", flags[i].name);
+        }
+    }
+    printf("\n");
+}
+
+static void Symbolize(const char *label, uint32_t address) {
+    char command[512];
+    char line[256];
+    FILE *out;
+
+    printf("  %-6s 0x%08X", label, (unsigned)address);
+    if (elf == NULL || address < FLASH_START || address >= FLASH_END) {
+        printf("\n");
+        return;
+    }
+    snprintf(command, sizeof(command), "%s -e '%s' -f -C -p 0x%08X", addr2line, elf,
+             (unsigned)(address & ~1U));
+    out = popen(command, "r");
+    if (out != NULL && fgets(line, sizeof(line), out) != NULL) {
+        printf("  %s", line);
+    } else {
+        printf("  (addr2line indisponibil)\n");
+    }
+    if (out != NULL) {
+        pclose(out);
+    }
+}
+
+static void PrintDump(const CrashDump_t *d) {
+    char task[CRASH_DUMP_TASK_LEN + 1];
+
+    memcpy(task, d->task, CRASH_DUMP_TASK_LEN);
+    task[CRASH_DUMP_TASK_LEN] = '\0';
+
+    printf("Cădere: %s după %u ms, task %s, context %s\n", ReasonName(d->reason),
+           (unsigned)d->uptimeMs, task[0] ? task : "-",
+           (d->excReturn & 4U) ? "task (PSP)" : "întrerupere (MSP)");
+    Symbolize("PC", d->pc);
+    Symbolize("LR", d->lr);
+    printf("  R0 0x%08X  R1 0x%08X  R2 0x%08X  R3 0x%08X  R12 0x%08X\n", (unsigned)d->r0,
+           (unsigned)d->r1, (unsigned)d->r2, (unsigned)d->r3, (unsigned)d->r12);
+    printf("  xPSR 0x%08X  SP 0x%08X  EXC_RETURN 0x%08X\n", (unsigned)d->xpsr, (unsigned)d->sp,
+           (unsigned)d->excReturn);
+    PrintFlags("CFSR", d->cfsr, cfsrFlags, sizeof(cfsrFlags) / sizeof(cfsrFlags[0]));
+    PrintFlags("HFSR", d->hfsr, hfsrFlags, sizeof(hfsrFlags) / sizeof(hfsrFlags[0]));
+    if (d->cfsr & (1U << 7)) {
+        printf("  MMFAR  0x%08X\n", (unsigned)d->mmfar);
+    }
+    if (d->cfsr & (1U << 15)) {
+        printf("  BFAR   0x%08X\n", (unsigned)d->bfar);
+    }
+
+    // Stiva: doar cuvintele care pot fi adrese de retur (Thumb, în cod)
+    printf("Stivă (posibile adrese de retur):\n");
+    for (uint32_t i = 0; i < CRASH_DUMP_STACK_WORDS; i++) {
+        uint32_t word = d->stack[i];
+
+        if ((word & 1U) && word >= FLASH_START && word < FLASH_END) {
+            char label[16];
+
+            snprintf(label, sizeof(label), "sp+%u", (unsigned)(i * 4U));
+            Symbolize(label, word);
+        }
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    static CrashDump_t dump;
+    uint8_t *assembled = (uint8_t *)&dump;
+    uint32_t received = 0;
+    const char *path = NULL;
+    FILE *in;
+    size_t len, pos = 0;
+    unsigned dumps = 0, bad = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            elf = argv[++i];
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            addr2line = argv[++i];
+        } else {
+            path = argv[i];
+        }
+    }
+    in = (path != NULL) ? fopen(path, "rb") : stdin;
+    if (in == NULL) {
+        perror(path);
+        return 1;
+    }
+    len = fread(capture, 1, sizeof(capture), in);
+
+    while (pos + 6 <= len) {
+        if (capture[pos] != LINK_FRAME_SYNC) {
+            pos++;
+            continue;
+        }
+
+        uint8_t type = capture[pos + 1];
+        size_t payloadLen = capture[pos + 2] | ((size_t)capture[pos + 3] << 8);
+        if (payloadLen > LINK_FRAME_MAX_PAYLOAD || pos + 6 + payloadLen > len) {
+            pos++;
+            continue;
+        }
+
+        const uint8_t *payload = &capture[pos + 4];
+        uint16_t crc = Crc16(&capture[pos + 1], 3 + payloadLen);
+        uint16_t rxCrc = payload[payloadLen] | (uint16_t)(payload[payloadLen + 1] << 8);
+        if (crc != rxCrc) {
+            pos++;
+            continue;
+        }
+        pos += 6 + payloadLen;
+
+        if (type != LINK_FRAME_CRASH || payloadLen < 2) {
+            continue;
+        }
+
+        uint32_t offset = payload[0] | (uint32_t)payload[1] << 8;
+        size_t chunk = payloadLen - 2;
+        if (offset == 0) {
+            received = 0;
+        }
+        if (offset != received || offset + chunk > sizeof(dump)) {
+            bad++;
+            received = 0;
+            continue;
+        }
+        memcpy(&assembled[offset], &payload[2], chunk);
+        received += chunk;
+
+        if (received == sizeof(dump)) {
+            received = 0;
+            if (dump.magic != CRASH_DUMP_MAGIC || dump.length != sizeof(dump) ||
+                dump.crc != Crc32(assembled, offsetof(CrashDump_t, crc))) {
+                bad++;
+                continue;
+            }
+            PrintDump(&dump);
+            dumps++;
+        }
+    }
+
+    fprintf(stderr, "%u instantanee decodate, %u respinse\n", dumps, bad);
+    if (in != stdin) {
+        fclose(in);
+    }
+    return 0;
+}
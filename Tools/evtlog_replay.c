@@ -0,0 +1,148 @@
+// Reluare pe host a jurnalului de evenimente din flash.
+//
+// Build: gcc -O2 -I../Core/Inc evtlog_replay.c ../Core/Src/crc.c -o evtlog_replay
+// Rulare: ./evtlog_replay captura.bin          (cadre LINK_FRAME_EVENTS, comanda 'e')
+//         ./evtlog_replay -f evtlog.bin        (imagine brută a regiunii EVTLOG,
+//                                               citită cu programatorul de la 0x0807C000)
+//
+// Aplică aceleași reguli ca firmware-ul (antet valid, CRC pe înregistrare,
+// ordonare după sequence), numerotează pornirile după EVT_BOOT și scrie
+// cronologia ca CSV, gata de reluat într-o simulare.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "crc.h"
+#include "event_log.h"
+#include "link.h"
+
+#define MAX_CAPTURE (4U * 1024U * 1024U)
+#define MAX_RECORDS 65536U
+
+static uint8_t input[MAX_CAPTURE];
+static EventRecord_t records[MAX_RECORDS];
+static uint32_t recordCount;
+
+static const char *EventName(uint8_t type) {
+    switch (type) {
+    case EVT_BOOT:           return "BOOT";
+    case EVT_GAS_DETECTED:   return "GAS_DETECTED";
+    case EVT_GAS_CLEARED:    return "GAS_CLEARED";
+    case EVT_FAN_ON:         return "FAN_ON";
+    case EVT_FAN_OFF:        return "FAN_OFF";
+    case EVT_LOG_DROPPED:    return "LOG_DROPPED";
+    case EVT_CONFIG_SAVED:   return "CONFIG_SAVED";
+    case EVT_GAS_WARNING:    return "GAS_WARNING";
+    case EVT_FAN_STALL:      return "FAN_STALL";
+    case EVT_SAFETY_TRIP:    return "SAFETY_TRIP";
+    case EVT_WATCHDOG_RESET: return "WATCHDOG_RESET";
+    case EVT_CRASH:          return "CRASH";
+    case EVT_BATTERY_LOW:    return "BATTERY_LOW";
+    case EVT_BATTERY_OK:     return "BATTERY_OK";
+    case EVT_FW_STAGED:      return "FW_STAGED";
+    case EVT_FW_CONFIRMED:   return "FW_CONFIRMED";
+    case EVT_FW_ROLLBACK:    return "FW_ROLLBACK";
+    case EVT_WARMUP_DONE:    return "WARMUP_DONE";
+    case EVT_BASELINE:       return "BASELINE";
+    case EVT_SELFTEST:       return "SELFTEST";
+    default:                 return "UNKNOWN";
+    }
+}
+
+static void AddRecord(const uint8_t *data) {
+    EventRecord_t record;
+
+    memcpy(&record, data, sizeof(record));
+    if (record.crc != Crc16(data, 14) || recordCount >= MAX_RECORDS) {
+        return;
+    }
+    records[recordCount++] = record;
+}
+
+static void ParseFlashImage(const uint8_t *image, size_t len) {
+    for (size_t page = 0; (page + 1) * EVENT_LOG_PAGE_SIZE <= len; page++) {
+        const uint8_t *base = &image[page * EVENT_LOG_PAGE_SIZE];
+        EventLogPageHeader_t header;
+
+        memcpy(&header, base, sizeof(header));
+        if (header.magic != EVENT_LOG_MAGIC || header.crc != Crc16(base, 14)) {
+            fprintf(stderr, "pagina %zu: antet invalid sau ștearsă\n", page);
+            continue;
+        }
+        fprintf(stderr, "pagina %zu: %u ștergeri, prima secvență %u\n", page,
+                (unsigned)header.eraseCount, (unsigned)header.firstSequence);
+        for (uint32_t slot = 0; slot < EVENT_LOG_SLOTS; slot++) {
+            AddRecord(base + (slot + 1U) * EVENT_LOG_RECORD_SIZE);
+        }
+    }
+}
+
+static void ParseCapture(const uint8_t *data, size_t len) {
+    size_t pos = 0;
+
+    while (pos + 6 <= len) {
+        size_t payloadLen = data[pos + 2] | ((size_t)data[pos + 3] << 8);
+
+        if (data[pos] != LINK_FRAME_SYNC || payloadLen > LINK_FRAME_MAX_PAYLOAD ||
+            pos + 6 + payloadLen > len) {
+            pos++;
+            continue;
+        }
+        const uint8_t *payload = &data[pos + 4];
+        uint16_t rxCrc = payload[payloadLen] | (uint16_t)(payload[payloadLen + 1] << 8);
+        if (Crc16(&data[pos + 1], 3 + payloadLen) != rxCrc) {
+            pos++;
+            continue;
+        }
+        if (data[pos + 1] == LINK_FRAME_EVENTS) {
+            for (size_t i = 0; i + EVENT_LOG_RECORD_SIZE <= payloadLen; i += EVENT_LOG_RECORD_SIZE) {
+                AddRecord(&payload[i]);
+            }
+        }
+        pos += 6 + payloadLen;
+    }
+}
+
+static int CompareSequence(const void *a, const void *b) {
+    uint32_t sa = ((const EventRecord_t *)a)->sequence;
+    uint32_t sb = ((const EventRecord_t *)b)->sequence;
+    return (sa > sb) - (sa < sb);
+}
+
+int main(int argc, char **argv) {
+    int flashImage = (argc > 2 && strcmp(argv[1], "-f") == 0);
+    const char *path = flashImage ? argv[2] : (argc > 1 ? argv[1] : NULL);
+    FILE *in = path ? fopen(path, "rb") : stdin;
+    size_t len;
+    unsigned boot = 0;
+
+    if (in == NULL) {
+        perror(path);
+        return 1;
+    }
+    len = fread(input, 1, sizeof(input), in);
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    if (flashImage) {
+        ParseFlashImage(input, len);
+    } else {
+        ParseCapture(input, len);
+    }
+    qsort(records, recordCount, sizeof(records[0]), CompareSequence);
+
+    printf("sequence,boot,timestamp_ms,event,value,aux\n");
+    for (uint32_t i = 0; i < recordCount; i++) {
+        if (i > 0 && records[i].sequence == records[i - 1].sequence) {
+            continue; // aceeași înregistrare descărcată de două ori
+        }
+        if (records[i].type == EVT_BOOT) {
+            boot++;
+        }
+        printf("%u,%u,%u,%s,%u,%u\n", (unsigned)records[i].sequence, boot,
+               (unsigned)records[i].timestamp, EventName(records[i].type),
+               (unsigned)records[i].value, (unsigned)records[i].aux);
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Împachetarea imaginii de aplicație pentru actualizarea pe link: completează
+// antetul FwImageHeader_t (fw_image.h) cu dimensiunea și CRC-32 imaginii.
+//
+// Build: gcc -O2 -I../Core/Inc fwpack.c ../Core/Src/crc.c -o fwpack
+// Rulare: arm-none-eabi-objcopy -O binary bluetooth.elf bluetooth.bin
+//         ./fwpack bluetooth.bin bluetooth.fw
+//
+// .bin-ul începe la FW_APP_ADDR cu antetul lăsat de firmware (magic și
+// versiune, restul 0). Rezultatul se trimite cu Tools/fwupdate.c; tot el
+// poate fi scris direct prin SWD la FW_APP_ADDR.
+
+#include <stdio.h>
+#include <string.h>
+#include "crc.h"
+#include "fw_image.h"
+
+static uint8_t image[FW_SLOT_SIZE + 1];
+
+int main(int argc, char **argv) {
+    FILE *in, *out;
+    size_t len;
+    FwImageHeader_t header;
+
+    if (argc != 3) {
+        fprintf(stderr, "Utilizare: %s imagine.bin imagine.fw\n", argv[0]);
+        return 2;
+    }
+    in = fopen(argv[1], "rb");
+    if (in == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    len = fread(image, 1, sizeof(image), in);
+    fclose(in);
+
+    if (len <= FW_HEADER_SIZE || len > FW_SLOT_SIZE) {
+        fprintf(stderr, "%s: %zu octeți, în afara slotului (%u..%lu)\n", argv[1], len,
+                (unsigned)FW_HEADER_SIZE + 1U, FW_SLOT_SIZE);
+        return 1;
+    }
+    memcpy(&header, image, sizeof(header));
+    if (header.magic != FW_IMAGE_MAGIC) {
+        fprintf(stderr, "%s: fără antet de imagine (binarul nu începe la 0x%08lx?)\n", argv[1], FW_APP_ADDR);
+        return 1;
+    }
+
+    header.imageSize = (uint32_t)(len - FW_HEADER_SIZE);
+    header.imageCrc = Crc32(&image[FW_HEADER_SIZE], header.imageSize);
+    memcpy(image, &header, sizeof(header));
+
+    out = fopen(argv[2], "wb");
+    if (out == NULL || fwrite(image, 1, len, out) != len || fclose(out) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+    printf("versiune %u.%u.%u, %u octeți, crc %08x, %lu pagini\n", header.version >> 24,
+           (header.version >> 16) & 0xFFU, header.version & 0xFFFFU, header.imageSize, header.imageCrc,
+           (unsigned long)((len + FW_PAGE_SIZE - 1U) / FW_PAGE_SIZE));
+    return 0;
+}
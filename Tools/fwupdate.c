@@ -0,0 +1,308 @@
+// Client host pentru actualizarea firmware-ului pe link (ota.h): trimite o
+// imagine împachetată cu Tools/fwpack.c prin portul serial al modulului
+// Bluetooth (rfcomm) sau printr-un adaptor USB-UART.
+//
+// Build: gcc -O2 -I../Core/Inc fwupdate.c ../Core/Src/crc.c -o fwupdate
+// Rulare: ./fwupdate -d /dev/rfcomm0 [-b 9600] bluetooth.fw
+//
+// Blocurile pleacă în fereastra anunțată de placă (OTA_WINDOW), fără să se
+// aștepte confirmarea fiecăruia; confirmările sunt cumulative. La
+// OTA_ERR_SEQ sau la expirarea așteptării, trimiterea se reia de la
+// nextOffset (go-back-N). La final placa verifică imaginea și se resetează
+// în bootloader; $fw arată apoi versiunea nouă, în probă până la confirmare.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <termios.h>
+#include <unistd.h>
+#include "crc.h"
+#include "fw_image.h"
+#include "link.h"
+#include "ota.h"
+
+#define BEGIN_TIMEOUT_MS 10000U // ștergerea staging-ului: ~22 ms pe pagină
+#define ACK_TIMEOUT_MS   3000U
+#define END_TIMEOUT_MS   5000U
+#define MAX_RETRIES      10
+
+static uint8_t image[FW_SLOT_SIZE];
+static int fd = -1;
+
+static const char *const statusNames[] = {
+    [OTA_OK] = "ok",
+    [OTA_ERR_STATE] = "stare (imaginea curentă e încă în probă?)",
+    [OTA_ERR_SIZE] = "dimensiune",
+    [OTA_ERR_FLASH] = "scriere în flash",
+    [OTA_ERR_SEQ] = "secvență",
+    [OTA_ERR_VERIFY] = "verificare (antet sau CRC)",
+};
+
+static speed_t BaudConstant(unsigned baud) {
+    switch (baud) {
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default:     return 0;
+    }
+}
+
+static int OpenPort(const char *path, unsigned baud) {
+    struct termios tio;
+    speed_t speed = BaudConstant(baud);
+
+    if (speed == 0) {
+        fprintf(stderr, "Viteză nesuportată: %u\n", baud);
+        return -1;
+    }
+    fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0 || tcgetattr(fd, &tio) != 0) {
+        perror(path);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        perror(path);
+        return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return 0;
+}
+
+static uint32_t NowMs(void) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000U + tv.tv_usec / 1000U);
+}
+
+static int WriteAll(const uint8_t *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+
+        if (n < 0 && errno != EINTR) {
+            perror("write");
+            return -1;
+        }
+        if (n > 0) {
+            data += n;
+            len -= (size_t)n;
+        }
+    }
+    return 0;
+}
+
+static int SendFrame(uint8_t type, const uint8_t *payload, uint16_t len) {
+    uint8_t frame[6U + OTA_FRAME_MAX];
+    uint16_t crc;
+
+    frame[0] = LINK_FRAME_SYNC;
+    frame[1] = type;
+    frame[2] = (uint8_t)len;
+    frame[3] = (uint8_t)(len >> 8);
+    if (len != 0) {
+        memcpy(&frame[4], payload, len);
+    }
+    crc = Crc16(&frame[1], 3U + len);
+    frame[4 + len] = (uint8_t)crc;
+    frame[5 + len] = (uint8_t)(crc >> 8);
+    return WriteAll(frame, 6U + len);
+}
+
+// Caută următorul cadru LINK_FRAME_OTA_ACK valid; textul și celelalte
+// cadre de pe link sunt sărite. 0 = primit, -1 = expirat.
+static int ReadAck(uint32_t timeoutMs, OtaAck_t *ack) {
+    static uint8_t rx[512];
+    static size_t rxLen;
+    uint32_t start = NowMs();
+
+    for (;;) {
+        size_t pos = 0;
+
+        while (pos + 6U <= rxLen) {
+            uint16_t len = (uint16_t)(rx[pos + 2] | (rx[pos + 3] << 8));
+
+            if (rx[pos] != LINK_FRAME_SYNC || len > LINK_FRAME_MAX_PAYLOAD) {
+                pos++;
+                continue;
+            }
+            if (pos + 6U + len > rxLen) {
+                break; // cadru incomplet
+            }
+            if (Crc16(&rx[pos + 1], 3U + len) != (rx[pos + 4 + len] | (rx[pos + 5 + len] << 8))) {
+                pos++;
+                continue;
+            }
+            if (rx[pos + 1] == LINK_FRAME_OTA_ACK && len == sizeof(*ack)) {
+                memcpy(ack, &rx[pos + 4], sizeof(*ack));
+                pos += 6U + len;
+                memmove(rx, &rx[pos], rxLen - pos);
+                rxLen -= pos;
+                return 0;
+            }
+            pos += 6U + len;
+        }
+        memmove(rx, &rx[pos], rxLen - pos);
+        rxLen -= pos;
+
+        uint32_t elapsed = NowMs() - start;
+        struct timeval tv;
+        fd_set set;
+        ssize_t n;
+
+        if (elapsed >= timeoutMs) {
+            return -1;
+        }
+        tv.tv_sec = (timeoutMs - elapsed) / 1000U;
+        tv.tv_usec = ((timeoutMs - elapsed) % 1000U) * 1000U;
+        FD_ZERO(&set);
+        FD_SET(fd, &set);
+        if (select(fd + 1, &set, NULL, NULL, &tv) <= 0) {
+            continue;
+        }
+        if (rxLen == sizeof(rx)) {
+            rxLen = 0; // doar zgomot: nimic de păstrat
+        }
+        n = read(fd, &rx[rxLen], sizeof(rx) - rxLen);
+        if (n > 0) {
+            rxLen += (size_t)n;
+        }
+    }
+}
+
+static const char *StatusName(uint8_t status) {
+    return (status < sizeof(statusNames) / sizeof(statusNames[0])) ? statusNames[status] : "necunoscut";
+}
+
+static int SendBlock(uint32_t offset, uint32_t size, uint16_t blockSize) {
+    uint8_t payload[4U + OTA_BLOCK_SIZE];
+    uint32_t count = (size - offset < blockSize) ? size - offset : blockSize;
+
+    memcpy(payload, &offset, sizeof(offset));
+    memcpy(&payload[4], &image[offset], count);
+    return SendFrame(LINK_FRAME_OTA_DATA, payload, (uint16_t)(4U + count));
+}
+
+int main(int argc, char **argv) {
+    const char *device = NULL;
+    const char *path = NULL;
+    unsigned baud = 9600;
+    FwImageHeader_t header;
+    OtaBegin_t begin;
+    OtaAck_t ack;
+    uint32_t size, acked = 0, sent = 0, retries = 0;
+    uint32_t window, blockSize;
+    uint32_t start;
+    FILE *in;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            device = argv[++i];
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            baud = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (device == NULL || path == NULL) {
+        fprintf(stderr, "Utilizare: %s -d port [-b baud] imagine.fw\n", argv[0]);
+        return 2;
+    }
+
+    in = fopen(path, "rb");
+    if (in == NULL) {
+        perror(path);
+        return 1;
+    }
+    size = (uint32_t)fread(image, 1, sizeof(image), in);
+    fclose(in);
+    memcpy(&header, image, sizeof(header));
+    if (size <= FW_HEADER_SIZE || header.magic != FW_IMAGE_MAGIC || header.imageSize != size - FW_HEADER_SIZE ||
+        Crc32(&image[FW_HEADER_SIZE], header.imageSize) != header.imageCrc) {
+        fprintf(stderr, "%s: imagine neîmpachetată sau coruptă (Tools/fwpack)\n", path);
+        return 1;
+    }
+    if (OpenPort(device, baud) != 0) {
+        return 1;
+    }
+
+    // BEGIN se repetă: pe USART1 primul octet doar trezește placa din Stop 2
+    begin.imageSize = size;
+    for (retries = 0; ; retries++) {
+        if (retries == MAX_RETRIES) {
+            fprintf(stderr, "Placa nu răspunde.\n");
+            return 1;
+        }
+        SendFrame(LINK_FRAME_OTA_BEGIN, (const uint8_t *)&begin, sizeof(begin));
+        if (ReadAck(BEGIN_TIMEOUT_MS, &ack) == 0) {
+            break;
+        }
+    }
+    if (ack.status != OTA_OK) {
+        fprintf(stderr, "Refuzat: %s\n", StatusName(ack.status));
+        return 1;
+    }
+    window = ack.window;
+    blockSize = (ack.blockSize < OTA_BLOCK_SIZE) ? ack.blockSize : OTA_BLOCK_SIZE;
+    printf("versiune %u.%u.%u, %u octeți, fereastră %u x %u\n", header.version >> 24,
+           (header.version >> 16) & 0xFFU, header.version & 0xFFFFU, size, window, blockSize);
+
+    start = NowMs();
+    retries = 0;
+    while (acked < size) {
+        while (sent < size && sent - acked < window * blockSize) {
+            if (SendBlock(sent, size, (uint16_t)blockSize) != 0) {
+                return 1;
+            }
+            sent += (size - sent < blockSize) ? size - sent : blockSize;
+        }
+        if (ReadAck(ACK_TIMEOUT_MS, &ack) != 0) {
+            if (++retries == MAX_RETRIES) {
+                fprintf(stderr, "\nPrea multe reluări la %u.\n", acked);
+                return 1;
+            }
+            sent = acked;
+            continue;
+        }
+        if (ack.status == OTA_ERR_SEQ) {
+            acked = ack.nextOffset;
+            sent = acked;
+        } else if (ack.status != OTA_OK) {
+            fprintf(stderr, "\nEroare la %u: %s\n", ack.nextOffset, StatusName(ack.status));
+            return 1;
+        } else if (ack.nextOffset > acked) {
+            acked = ack.nextOffset;
+            retries = 0;
+        }
+        printf("\r%u/%u octeți", acked, size);
+        fflush(stdout);
+    }
+    printf("\n%.1f s\n", (NowMs() - start) / 1000.0);
+
+    SendFrame(LINK_FRAME_OTA_END, NULL, 0);
+    if (ReadAck(END_TIMEOUT_MS, &ack) != 0) {
+        fprintf(stderr, "Fără răspuns la verificare ($fw arată starea).\n");
+        return 1;
+    }
+    if (ack.status != OTA_OK) {
+        fprintf(stderr, "Imagine respinsă: %s\n", StatusName(ack.status));
+        return 1;
+    }
+    printf("Imagine verificată; placa se resetează și instalează imaginea (în probă %u s).\n",
+           OTA_TRIAL_MS / 1000U);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Decodor host pentru cadrele de istoric/streaming trimise pe linkul Bluetooth.
+//
+// Build: gcc -O2 -I../Core/Inc histdecode.c ../Core/Src/sample_codec.c ../Core/Src/crc.c -o histdecode
+// Rulare: ./histdecode captura.bin > istoric.csv   (sau din stdin)
+//
+// Citește o captură brută a portului serial, găsește cadrele valide după
+// octetul de sincronizare și CRC, și scrie eșantioanele ca CSV.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "crc.h"
+#include "link.h"
+#include "sample_codec.h"
+
+#define MAX_CAPTURE (4U * 1024U * 1024U)
+#define MAX_SAMPLES 65536U
+
+static uint8_t capture[MAX_CAPTURE];
+static Sample_t samples[MAX_SAMPLES];
+
+int main(int argc, char **argv) {
+    FILE *in = (argc > 1) ? fopen(argv[1], "rb") : stdin;
+    size_t len, pos = 0;
+    unsigned frames = 0, bad = 0;
+
+    if (in == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    len = fread(capture, 1, sizeof(capture), in);
+
+    printf("index,timestamp_ms,value\n");
+    while (pos + 6 <= len) {
+        if (capture[pos] != LINK_FRAME_SYNC) {
+            pos++;
+            continue;
+        }
+
+        uint8_t type = capture[pos + 1];
+        size_t payloadLen = capture[pos + 2] | ((size_t)capture[pos + 3] << 8);
+        if (payloadLen > LINK_FRAME_MAX_PAYLOAD || pos + 6 + payloadLen > len) {
+            pos++;
+            continue;
+        }
+
+        const uint8_t *payload = &capture[pos + 4];
+        uint16_t crc = Crc16(&capture[pos + 1], 3 + payloadLen);
+        uint16_t rxCrc = payload[payloadLen] | (uint16_t)(payload[payloadLen + 1] << 8);
+        if (crc != rxCrc) {
+            bad++;
+            pos++;
+            continue;
+        }
+        pos += 6 + payloadLen;
+
+        if ((type != LINK_FRAME_HISTORY && type != LINK_FRAME_STREAM) || payloadLen < 4) {
+            continue;
+        }
+
+        uint32_t index = payload[0] | (uint32_t)payload[1] << 8 |
+                         (uint32_t)payload[2] << 16 | (uint32_t)payload[3] << 24;
+        int32_t n = SampleCodec_Decode(&payload[4], payloadLen - 4, samples, MAX_SAMPLES);
+        if (n < 0) {
+            bad++;
+            continue;
+        }
+        for (int32_t i = 0; i < n; i++) {
+            printf("%u,%u,%u\n", (unsigned)(index + i), (unsigned)samples[i].timestamp,
+                   (unsigned)samples[i].value);
+        }
+        frames++;
+    }
+
+    fprintf(stderr, "%u cadre decodate, %u respinse\n", frames, bad);
+    if (in != stdin) {
+        fclose(in);
+    }
+    return 0;
+}
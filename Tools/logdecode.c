@@ -0,0 +1,166 @@
+// Decodor host pentru jurnalul de diagnostic binar (log_binary = 1):
+// cadrele LINK_FRAME_LOG capturate de pe VCP-ul ST-LINK (USART2).
+//
+// Build: gcc -O2 -I../Core/Inc logdecode.c ../Core/Src/log_format.c ../Core/Src/crc.c -o logdecode
+// Rulare: ./logdecode -e firmware.elf captura.bin   (sau captura din stdin)
+//
+// Înregistrările conțin doar adresa șirului de format și argumentele brute;
+// șirurile (formatul și argumentele %s constante) se citesc din secțiunile
+// alocate ale ELF-ului cu care rulează placa, apoi se formatează cu același
+// cod ca DiagTask (log_format.c). Un ELF diferit de cel din placă dă text
+// greșit, nu o eroare: adresele nu sunt verificate altfel.
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "crc.h"
+#include "link.h"
+#include "logger.h"
+#include "log_format.h"
+
+#define MAX_CAPTURE (4U * 1024U * 1024U)
+#define MAX_ELF     (16U * 1024U * 1024U)
+
+static uint8_t capture[MAX_CAPTURE];
+static uint8_t image[MAX_ELF];
+static size_t imageLen;
+
+// Adresa din țintă -> șir din ELF (secțiune alocată cu conținut, terminat în ea)
+static const char *ResolveString(uint32_t address) {
+    const Elf32_Ehdr *eh = (const Elf32_Ehdr *)image;
+
+    if (imageLen < sizeof(*eh)) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < eh->e_shnum; i++) {
+        const Elf32_Shdr *sh = (const Elf32_Shdr *)(image + eh->e_shoff + (size_t)i * eh->e_shentsize);
+
+        if ((const uint8_t *)(sh + 1) > image + imageLen || sh->sh_type != SHT_PROGBITS ||
+            (sh->sh_flags & SHF_ALLOC) == 0 || address < sh->sh_addr || address >= sh->sh_addr + sh->sh_size ||
+            (size_t)sh->sh_offset + sh->sh_size > imageLen) {
+            continue;
+        }
+        const char *text = (const char *)image + sh->sh_offset + (address - sh->sh_addr);
+        const char *end = (const char *)image + sh->sh_offset + sh->sh_size;
+
+        if (memchr(text, '\0', (size_t)(end - text)) != NULL) {
+            return text;
+        }
+    }
+    return NULL;
+}
+
+static int LoadElf(const char *path) {
+    FILE *f = fopen(path, "rb");
+    const Elf32_Ehdr *eh = (const Elf32_Ehdr *)image;
+
+    if (f == NULL) {
+        perror(path);
+        return 0;
+    }
+    imageLen = fread(image, 1, sizeof(image), f);
+    fclose(f);
+    if (imageLen < sizeof(*eh) || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh->e_ident[EI_CLASS] != ELFCLASS32 || eh->e_ident[EI_DATA] != ELFDATA2LSB) {
+        fprintf(stderr, "%s: nu e un ELF32 little-endian\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+static void PrintRecords(const uint8_t *payload, size_t len) {
+    size_t pos = 0;
+
+    while (pos + 8 <= len) {
+        uint32_t words[2U + LOG_MAX_DATA];
+        uint32_t count;
+        uint32_t ms;
+        char line[512];
+
+        memcpy(words, payload + pos, 8);
+        count = words[1] >> 28;
+        ms = words[1] & 0x0FFFFFFFU;
+        if (pos + 8U + count * 4U > len) {
+            printf("# înregistrare trunchiată\n");
+            return;
+        }
+        memcpy(&words[2], payload + pos + 8, count * 4U);
+        pos += 8U + count * 4U;
+
+        if ((words[0] & LOG_TAG_MASK) == LOG_TAG_TEXT) {
+            fwrite(&words[2], 1, (size_t)(words[0] & ~LOG_TAG_MASK), stdout);
+        } else if ((words[0] & LOG_TAG_MASK) == LOG_TAG_DROPPED) {
+            printf("[%u.%03u] [log] %u inregistrari pierdute\n", ms / 1000U, ms % 1000U,
+                   (unsigned)(words[0] & ~LOG_TAG_MASK));
+        } else {
+            const char *fmt = ResolveString(words[0]);
+
+            if (fmt == NULL) {
+                printf("[%u.%03u] <format 0x%08x necunoscut>\n", ms / 1000U, ms % 1000U, words[0]);
+                continue;
+            }
+            LogFormat(line, sizeof(line), fmt, &words[2], count, ResolveString);
+            printf("[%u.%03u] %s\n", ms / 1000U, ms % 1000U, line);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *elfPath = NULL;
+    const char *capturePath = NULL;
+    FILE *in;
+    size_t len, pos = 0;
+    unsigned frames = 0, bad = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            elfPath = argv[++i];
+        } else {
+            capturePath = argv[i];
+        }
+    }
+    if (elfPath == NULL) {
+        fprintf(stderr, "Utilizare: %s -e firmware.elf [captura.bin]\n", argv[0]);
+        return 2;
+    }
+    if (!LoadElf(elfPath)) {
+        return 1;
+    }
+    in = (capturePath != NULL) ? fopen(capturePath, "rb") : stdin;
+    if (in == NULL) {
+        perror(capturePath);
+        return 1;
+    }
+    len = fread(capture, 1, sizeof(capture), in);
+
+    while (pos + 6 <= len) {
+        if (capture[pos] != LINK_FRAME_SYNC) {
+            pos++;
+            continue;
+        }
+
+        uint8_t type = capture[pos + 1];
+        size_t payloadLen = capture[pos + 2] | ((size_t)capture[pos + 3] << 8);
+
+        if (payloadLen > LINK_FRAME_MAX_PAYLOAD || pos + 6 + payloadLen > len) {
+            pos++;
+            continue;
+        }
+        uint16_t crc = Crc16(&capture[pos + 1], 3 + payloadLen);
+        uint16_t rxCrc = capture[pos + 4 + payloadLen] | (capture[pos + 5 + payloadLen] << 8);
+
+        if (crc != rxCrc) {
+            bad++;
+            pos++;
+            continue;
+        }
+        if (type == LINK_FRAME_LOG) {
+            PrintRecords(&capture[pos + 4], payloadLen);
+            frames++;
+        }
+        pos += 6 + payloadLen;
+    }
+    fprintf(stderr, "%u cadre de jurnal, %u respinse (CRC)\n", frames, bad);
+    return 0;
+}
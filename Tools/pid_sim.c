@@ -0,0 +1,179 @@
+// Simulator host pentru regulatorul PID al ventilatorului (Core/Src/pid.c)
+// pe un model simplu de ventilare a unei încăperi.
+//
+// Build: gcc -O2 -I../Core/Inc pid_sim.c ../Core/Src/pid.c -lm -o pid_sim
+// Rulare: ./pid_sim [kp ki kd]          (câștiguri reale, ex. 8 0.08 40)
+//         ./pid_sim -csv scenariu > trace.csv
+//
+// Model: concentrația C (ppm) într-o încăpere de volum V crește cu sursa
+// de gaz S și scade prin ventilarea naturală și prin ventilator:
+//   dC/dt = S - (k0 + kFan * viteză) * C
+// Viteza ventilatorului urmează factorul de umplere cu o constantă de timp
+// mecanică și e 0 sub pragul de calare; senzorul MQ-2 răspunde cu o
+// întârziere de ordinul întâi și e cuantizat la 1 ppm. Regulatorul rulează
+// exact ca în fan.c: perioadă fixă, ieșire în pași de 0.1%, limită de rampă,
+// minim de pornire fan_duty_lo urmărit prin Pid_Track.
+//
+// Pentru fiecare scenariu raportează suprareglajul, timpul de stabilizare
+// (intrare definitivă în banda de +/-5% din consemn), IAE și numărul de
+// saturări, pe concentrația reală din încăpere.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "pid.h"
+
+#define PERIOD_MS      100U     // FAN_CONTROL_PERIOD_MS
+#define SIM_SECONDS    1800U
+#define BAND_PERCENT   5.0
+
+// Valorile implicite din configurație (config.c)
+#define DUTY_LO        30       // fan_duty_lo (%)
+#define RAMP           20       // fan_ramp (%/s)
+
+// Încăpere de ~10 m3, ventilator de ~360 m3/h, 0.5 schimburi de aer/oră natural
+#define K0             (0.5 / 3600.0)
+#define K_FAN          0.01
+#define FAN_TAU_S      1.5
+#define STALL_DUTY     0.20
+#define SENSOR_TAU_S   10.0
+
+typedef struct {
+    const char *name;
+    double leakBefore;      // ppm/s
+    double leakAfter;
+    uint32_t stepAt;        // s
+    int32_t setpointBefore; // ppm
+    int32_t setpointAfter;
+    double c0;              // concentrația inițială
+} Scenario_t;
+
+static const Scenario_t scenarios[] = {
+    // scurgere care pornește în aer curat
+    { "scurgere",   0.0, 2.0,  10, 400, 400,   0.0 },
+    // sursa crește cu 50% după ce bucla s-a stabilizat
+    { "perturbatie", 2.0, 3.0, 900, 400, 400, 400.0 },
+    // consemn coborât de la 400 la 250 ppm
+    { "consemn",    2.0, 2.0, 900, 400, 250, 400.0 },
+};
+
+typedef struct {
+    double overshoot;   // % din consemn
+    double settling;    // s de la treaptă
+    double iae;         // ppm*s
+    uint32_t saturated; // perioade cu ieșirea la 0 sau 100%
+} Metrics_t;
+
+// Valorile implicite fan_kp/fan_ki/fan_kd din configurație
+static int32_t kp = PID_GAIN(8.0);
+static int32_t ki = PID_GAIN(0.08);
+static int32_t kd = PID_GAIN(40.0);
+
+static Metrics_t Run(const Scenario_t *sc, FILE *csv) {
+    Pid_t pid;
+    Metrics_t m = { 0.0, 0.0, 0.0, 0 };
+    double dt = PERIOD_MS / 1000.0;
+    double c = sc->c0;
+    double sensed = sc->c0;
+    double speed = 0.0;
+    int32_t duty = 0;
+    double peak = 0.0;
+    double trough = 1e9;
+    double lastOutside = 0.0;
+    uint32_t steps = SIM_SECONDS * 1000U / PERIOD_MS;
+
+    Pid_Init(&pid, PERIOD_MS, 0, 1000, 1);
+    Pid_Configure(&pid, kp, ki, kd, RAMP * 10 * (int32_t)PERIOD_MS / 1000);
+
+    // Pornire din regim staționar: factorul de umplere care ține c0
+    if (sc->c0 > 0.0) {
+        double u = (sc->leakBefore / sc->c0 - K0) / K_FAN;
+        duty = (int32_t)(u * 1000.0);
+        speed = u;
+    }
+    Pid_Reset(&pid, (int32_t)sensed, duty);
+
+    for (uint32_t i = 0; i < steps; i++) {
+        double t = i * dt;
+        int after = t >= sc->stepAt;
+        double leak = after ? sc->leakAfter : sc->leakBefore;
+        int32_t setpoint = after ? sc->setpointAfter : sc->setpointBefore;
+        double duty01;
+        double target;
+
+        // Regulatorul, ca în Fan_Update
+        duty = Pid_Update(&pid, setpoint, (int32_t)lround(sensed));
+        if (duty != 0 && duty < DUTY_LO * 10) {
+            duty = DUTY_LO * 10;
+            Pid_Track(&pid, duty);
+        }
+        if (duty == 0 || duty == 1000) {
+            m.saturated++;
+        }
+
+        // Ventilator, încăpere, senzor
+        duty01 = duty / 1000.0;
+        target = (duty01 < STALL_DUTY) ? 0.0 : duty01;
+        speed += (target - speed) * dt / FAN_TAU_S;
+        c += (leak - (K0 + K_FAN * speed) * c) * dt;
+        if (c < 0.0) {
+            c = 0.0;
+        }
+        sensed += (c - sensed) * dt / SENSOR_TAU_S;
+
+        if (after) {
+            double err = c - setpoint;
+
+            m.iae += fabs(err) * dt;
+            if (t - sc->stepAt < 600.0) {
+                peak = (c > peak) ? c : peak;
+                trough = (c < trough) ? c : trough;
+            }
+            if (fabs(err) > setpoint * BAND_PERCENT / 100.0) {
+                lastOutside = t - sc->stepAt;
+            }
+        }
+        if (csv != NULL) {
+            fprintf(csv, "%.1f,%d,%.1f,%.1f,%d\n", t, setpoint, c, sensed, duty);
+        }
+    }
+
+    {
+        // La coborârea consemnului suprareglajul e sub consemn
+        double deviation = (sc->setpointAfter < sc->setpointBefore) ? sc->setpointAfter - trough
+                                                                    : peak - sc->setpointAfter;
+        m.overshoot = deviation > 0.0 ? deviation * 100.0 / sc->setpointAfter : 0.0;
+    }
+    m.settling = lastOutside;
+    return m;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "-csv") == 0) {
+        for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+            if (strcmp(argv[2], scenarios[s].name) == 0) {
+                printf("t,setpoint,room,sensor,duty\n");
+                Run(&scenarios[s], stdout);
+                return 0;
+            }
+        }
+        fprintf(stderr, "scenariu necunoscut: %s\n", argv[2]);
+        return 1;
+    }
+    if (argc == 4) {
+        kp = PID_GAIN(atof(argv[1]));
+        ki = PID_GAIN(atof(argv[2]));
+        kd = PID_GAIN(atof(argv[3]));
+    }
+
+    printf("kp=%d ki=%d kd=%d (Q8.8), perioadă %u ms\n", kp, ki, kd, PERIOD_MS);
+    printf("%-12s %12s %14s %12s %10s\n", "scenariu", "suprareglaj", "stabilizare", "IAE", "saturat");
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        Metrics_t m = Run(&scenarios[s], NULL);
+
+        printf("%-12s %11.1f%% %13.1fs %9.0f ppm*s %9.1fs\n", scenarios[s].name, m.overshoot,
+               m.settling, m.iae, m.saturated * PERIOD_MS / 1000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+// Simulator host pentru consumul plăcii în idle fără tick (Core/Src/power.c).
+//
+// Build: gcc -O2 -I../Core/Inc power_sim.c ../Core/Src/energy.c -o power_sim
+// Rulare: ./power_sim [-c mAh] [-limit uA]
+//
+// Reface, la rezoluție de 1 ms, o oră din trezirile periodice ale
+// firmware-ului (timerele de ventilator și LED, watchdog-ul, DiagTask,
+// BluetoothTask în așteptare, StorageTask și bucla de gaz la sample_ms) și
+// aplică aceleași reguli ca Power_Sleep: între două treziri placa intră
+// în Stop 2 dacă low_power = 1, ventilatorul e oprit și pauza are cel puțin
+// POWER_MIN_STOP_MS; altfel rămâne în Sleep, trezită la fiecare tick.
+// Rezidența rezultată trece prin Energy_Estimate, cu curenții impliciți din
+// configurație, exact ca în $power.
+//
+// Cu -limit, iese cu codul 1 dacă un scenariu cu Stop 2 depășește curentul
+// mediu dat: o trezire periodică nouă sau mai scumpă se vede ca regresie.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "energy.h"
+#include "power.h"
+
+#define SIM_MS            3600000U // o oră
+#define TICK_ISR_US       2U       // SysTick + verificarea listei de întârzieri
+#define STOP_EXIT_US      30U      // ieșirea din Stop 2 și repornirea PLL-ului
+#define SUPPLY_MV         POWER_SUPPLY_MV
+#define DEFAULT_MAH       2000U
+
+// Valorile implicite din configurație (config.c)
+static const uint32_t currentNa[ENERGY_MODE_COUNT] = {
+    [ENERGY_MODE_RUN] = 9400000,
+    [ENERGY_MODE_LPRUN] = 230000,
+    [ENERGY_MODE_SLEEP] = 3000000,
+    [ENERGY_MODE_STOP1] = 5000,
+    [ENERGY_MODE_STOP2] = 1600,
+};
+#define BOARD_NA          0U
+
+typedef struct {
+    const char *name;
+    uint32_t periodMs;   // 0 = perioada de eșantionare a scenariului
+    uint32_t runUs;      // timpul de rulare la fiecare trezire
+} Source_t;
+
+// Task-urile și timerele care trezesc nucleul când nu se întâmplă nimic
+static const Source_t sources[] = {
+    { "gaz",       0,     120 }, // conversie ADC, filtru, istoric
+    { "ventilator", 100,  15 },  // FAN_CONTROL_PERIOD_MS (timer software)
+    { "led",       100,   5 },   // LED_TICK_MS
+    { "log",       100,   5 },   // LOG_DRAIN_MS, jurnal gol
+    { "watchdog",  250,   10 },  // WATCHDOG_PERIOD_MS
+    { "link",      1000,  20 },  // LINK_WAIT_MS, BluetoothTask fără trafic
+    { "storage",   5000,  40 },  // EVENT_LOG_FLUSH_MS
+};
+#define SOURCE_COUNT (sizeof(sources) / sizeof(sources[0]))
+
+typedef struct {
+    const char *name;
+    uint8_t lowPower;
+    uint8_t fanRunning;  // PWM activ: Stop 2 interzis (StopAllowed)
+    uint32_t sampleMs;
+} Scenario_t;
+
+static const Scenario_t scenarios[] = {
+    { "fara_stop",    0, 0, 100 },
+    { "stop2",        1, 0, 100 },
+    { "stop2_1s",     1, 0, 1000 },
+    { "ventilator",   1, 1, 100 },
+};
+
+typedef struct {
+    EnergyResidency_t residency;
+    uint32_t wakes;
+    uint32_t stops;
+} Result_t;
+
+static uint32_t RunCost(const Scenario_t *sc, uint32_t ms) {
+    uint32_t us = 0;
+
+    for (size_t i = 0; i < SOURCE_COUNT; i++) {
+        uint32_t period = sources[i].periodMs ? sources[i].periodMs : sc->sampleMs;
+
+        if (ms % period == 0) {
+            us += sources[i].runUs;
+        }
+    }
+    return us;
+}
+
+static void Simulate(const Scenario_t *sc, Result_t *res) {
+    uint32_t ms = 0;
+
+    memset(res, 0, sizeof(*res));
+    while (ms < SIM_MS) {
+        uint32_t runUs = RunCost(sc, ms);
+        uint32_t next = ms + 1;
+        uint32_t gapUs;
+
+        res->wakes++;
+        while (next < SIM_MS && RunCost(sc, next) == 0) {
+            next++;
+        }
+        if (runUs > 1000U) {
+            runUs = 1000U;
+        }
+        res->residency.us[ENERGY_MODE_RUN] += runUs;
+        gapUs = (next - ms) * 1000U - runUs;
+
+        if (sc->lowPower && !sc->fanRunning && next - ms >= POWER_MIN_STOP_MS) {
+            // Stop 2 până la trezirea următoare, cu trezirile RTC intermediare
+            // impuse de POWER_MAX_STOP_MS
+            uint32_t stops = (next - ms + POWER_MAX_STOP_MS - 1U) / POWER_MAX_STOP_MS;
+
+            res->stops += stops;
+            res->wakes += stops - 1U;
+            res->residency.us[ENERGY_MODE_RUN] += stops * STOP_EXIT_US;
+            res->residency.us[ENERGY_MODE_STOP2] += gapUs - stops * STOP_EXIT_US;
+        } else {
+            // Sleep cu tick-ul mergând: o întrerupere SysTick pe ms
+            uint32_t ticks = next - ms;
+
+            res->residency.us[ENERGY_MODE_RUN] += (ticks - 1U) * TICK_ISR_US;
+            res->residency.us[ENERGY_MODE_SLEEP] += gapUs - (ticks - 1U) * TICK_ISR_US;
+        }
+        ms = next;
+    }
+}
+
+int main(int argc, char **argv) {
+    uint32_t capacityMah = DEFAULT_MAH;
+    uint32_t limitUa = 0;
+    int fail = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            capacityMah = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-limit") == 0 && i + 1 < argc) {
+            limitUa = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Utilizare: %s [-c mAh] [-limit uA]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("%-11s %6s %6s %6s %8s %8s %9s %9s %8s\n", "scenariu", "run", "sleep", "stop2",
+           "treziri", "stop", "mediu_uA", "uWh/h", "zile");
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        const Scenario_t *sc = &scenarios[s];
+        Result_t res;
+        EnergyEstimate_t est;
+        double days;
+
+        Simulate(sc, &res);
+        Energy_Estimate(&res.residency, currentNa, BOARD_NA, SUPPLY_MV, &est);
+        days = est.avgNa ? (double)capacityMah * 1e6 / est.avgNa / 24.0 : 0.0;
+
+        printf("%-11s %5u‰ %5u‰ %5u‰ %8u %8u %9.1f %9u %8.1f\n", sc->name,
+               Energy_Permille(&res.residency, ENERGY_MODE_RUN),
+               Energy_Permille(&res.residency, ENERGY_MODE_SLEEP),
+               Energy_Permille(&res.residency, ENERGY_MODE_STOP2),
+               res.wakes, res.stops, est.avgNa / 1000.0, est.perHourUwh, days);
+
+        if (limitUa != 0 && sc->lowPower && !sc->fanRunning && est.avgNa > limitUa * 1000U) {
+            fprintf(stderr, "%s: %.1f uA peste limita de %u uA\n", sc->name, est.avgNa / 1000.0, limitUa);
+            fail = 1;
+        }
+    }
+    printf("(baterie %u mAh, %u mV, fără consumul restului plăcii)\n", capacityMah, SUPPLY_MV);
+    return fail;
+}